@@ -0,0 +1,131 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/euclidean_matrix.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_kernels.h"
+#include "assignments/ev/euclidean_vector_pairwise.h"
+
+namespace {
+
+// kind is "Index" for a row, "Column" for a column
+[[noreturn]] void ThrowInvalidIndex(const char* kind, int index) {
+  std::ostringstream ss;
+  ss << kind << " " << index << " is not valid for this EuclideanMatrix object";
+  ev_detail::Throw(ss.str());
+}
+
+EuclideanVectorBatch RowMajor(const EuclideanVectorBatch& b) {
+  if (b.GetLayout() == EuclideanVectorBatch::Layout::kRowMajor)
+    return b;
+  return b.ToLayout(EuclideanVectorBatch::Layout::kRowMajor);
+}
+
+void RunChunks(int numChunks, ThreadPool* pool, const std::function<void(int)>& chunk) {
+  if (pool != nullptr) {
+    pool->ParallelFor(numChunks, chunk);
+  } else {
+    for (int c = 0; c < numChunks; c++)
+      chunk(c);
+  }
+}
+
+}  // namespace
+
+// Constructors
+
+EuclideanMatrix::EuclideanMatrix(int numRows, int numColumns) : rows_{numRows, numColumns} {}
+
+EuclideanMatrix::EuclideanMatrix(const std::vector<EuclideanVector>& rows) : rows_{rows} {}
+
+EuclideanMatrix::EuclideanMatrix(const EuclideanVectorBatch& rows) : rows_{RowMajor(rows)} {}
+
+// Methods
+
+double& EuclideanMatrix::at(int row, int column) {
+  CheckRow(row);
+  if (column < 0 || column >= GetNumColumns())
+    ThrowInvalidIndex("Column", column);
+
+  return rows_(row, column);
+}
+
+double EuclideanMatrix::at(int row, int column) const {
+  CheckRow(row);
+  if (column < 0 || column >= GetNumColumns())
+    ThrowInvalidIndex("Column", column);
+
+  return rows_(row, column);
+}
+
+EuclideanVectorBatch::RowView EuclideanMatrix::Row(int row) const {
+  CheckRow(row);
+
+  return rows_.Row(row);
+}
+
+EuclideanVector EuclideanMatrix::Apply(const EuclideanVector& v, ThreadPool* pool) const {
+  ev_detail::CheckDimensions(GetNumColumns(), v.GetNumDimensions());
+
+  auto result = EuclideanVector(GetNumRows());
+  double* out = result.data();
+  const int numChunks = (GetNumRows() + kMatrixChunkRows - 1) / kMatrixChunkRows;
+  RunChunks(numChunks, pool, [&](int chunk) {
+    const int begin = chunk * kMatrixChunkRows;
+    const int end = std::min(begin + kMatrixChunkRows, GetNumRows());
+    int r = begin;
+    for (; r + 4 <= end; r += 4) {
+      const double* rows[4];
+      for (int j = 0; j < 4; j++)
+        rows[j] = rows_.data() + static_cast<std::size_t>(r + j) * rows_.GetStride();
+      ev_kernels::Dot4(v.data(), rows, GetNumColumns(), out + r);
+    }
+    for (; r < end; r++) {
+      const double* row = rows_.data() + static_cast<std::size_t>(r) * rows_.GetStride();
+      out[r] = ev_kernels::Dot(row, v.data(), GetNumColumns());
+    }
+  });
+
+  return result;
+}
+
+EuclideanVector EuclideanMatrix::ApplyTransposed(const EuclideanVector& v,
+                                                 ThreadPool* pool) const {
+  ev_detail::CheckDimensions(GetNumRows(), v.GetNumDimensions());
+
+  auto result = EuclideanVector(GetNumColumns());
+  double* out = result.data();
+  const int numChunks = (GetNumColumns() + kMatrixChunkColumns - 1) / kMatrixChunkColumns;
+  RunChunks(numChunks, pool, [&](int chunk) {
+    const int begin = chunk * kMatrixChunkColumns;
+    const int length = std::min(kMatrixChunkColumns, GetNumColumns() - begin);
+    for (int r = 0; r < GetNumRows(); r++) {
+      const double* row = rows_.data() + static_cast<std::size_t>(r) * rows_.GetStride();
+      ev_kernels::Axpy(out + begin, v[r], row + begin, length);
+    }
+  });
+
+  return result;
+}
+
+EuclideanVectorBatch EuclideanMatrix::Apply(const EuclideanVectorBatch& vectors,
+                                            ThreadPool* pool) const {
+  ev_detail::CheckDimensions(GetNumColumns(), vectors.GetNumDimensions());
+
+  auto result = EuclideanVectorBatch(vectors.GetNumVectors(), GetNumRows());
+  // Entry (i, r) of the product is vector i . row r
+  PairwiseDistances(vectors, rows_, Metric::kInnerProduct, result.data(),
+                    static_cast<std::size_t>(result.GetStride()), pool);
+
+  return result;
+}
+
+void EuclideanMatrix::CheckRow(int row) const {
+  if (row < 0 || row >= GetNumRows())
+    ThrowInvalidIndex("Index", row);
+}
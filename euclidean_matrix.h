@@ -0,0 +1,73 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_MATRIX_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_MATRIX_H_
+
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/thread_pool.h"
+
+/*
+  A dense, row-major matrix of doubles that applies linear maps to EuclideanVectors.
+
+  The rows are kept in a row-major EuclideanVectorBatch (64-byte aligned, zero padded), and
+  every product reads them and writes its result in place, without copying either through
+  std::vector:
+    Apply(v)           : M v. Four rows at a time against v (ev_kernels::Dot4), so v is read
+                         once per four rows. With a ThreadPool, chunks of kMatrixChunkRows rows
+                         are shared between the threads.
+    ApplyTransposed(v) : M^T v, as v[0] * row 0 + v[1] * row 1 + ... (ev_kernels::Axpy). The
+                         columns are cut into chunks of kMatrixChunkColumns, so the part of the
+                         result being accumulated stays in L1 while the rows stream past it, and
+                         with a ThreadPool each thread accumulates its own chunks.
+    Apply(batch)       : M v for every vector of the batch, as a batch of GetNumRows()
+                         dimensional vectors. This is the matrix product of the batch with M^T,
+                         computed by the register- and cache-blocked kernels of
+                         PairwiseDistances (see euclidean_vector_pairwise.h).
+  The chunks do not depend on the number of threads, so results are identical with or without
+  a ThreadPool. A vector (or batch) whose dimensions do not match the matrix is reported like
+  any other dimension mismatch, with the matrix as the LHS.
+*/
+
+constexpr int kMatrixChunkRows = 256;
+constexpr int kMatrixChunkColumns = 1024;
+
+class EuclideanMatrix {
+ public:
+  // Constructors
+  // numRows x numColumns, all entries 0.0
+  EuclideanMatrix(int numRows, int numColumns);
+  // One row per vector. The vectors must all have the same number of dimensions.
+  explicit EuclideanMatrix(const std::vector<EuclideanVector>& rows);
+  // One row per vector of the batch, in either layout
+  explicit EuclideanMatrix(const EuclideanVectorBatch& rows);
+
+  // Operations
+  // Unchecked access to entry (row, column)
+  double& operator()(int row, int column) noexcept { return rows_(row, column); }
+  double operator()(int row, int column) const noexcept { return rows_(row, column); }
+
+  // Methods
+  double& at(int row, int column);
+  double at(int row, int column) const;
+  EuclideanVectorBatch::RowView Row(int) const;
+  int GetNumRows() const noexcept { return rows_.GetNumVectors(); }
+  int GetNumColumns() const noexcept { return rows_.GetNumDimensions(); }
+  // The rows, as a row-major batch
+  const EuclideanVectorBatch& GetRows() const noexcept { return rows_; }
+  // M v, with GetNumRows() dimensions
+  EuclideanVector Apply(const EuclideanVector&, ThreadPool* = nullptr) const;
+  // M^T v, with GetNumColumns() dimensions
+  EuclideanVector ApplyTransposed(const EuclideanVector&, ThreadPool* = nullptr) const;
+  // M v for every vector v of the batch, as a row-major batch
+  EuclideanVectorBatch Apply(const EuclideanVectorBatch&, ThreadPool* = nullptr) const;
+
+ private:
+  void CheckRow(int) const;
+
+  EuclideanVectorBatch rows_;
+};
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_MATRIX_H_
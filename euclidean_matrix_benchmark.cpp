@@ -0,0 +1,99 @@
+// Created By : Rahil Agrawal
+//
+// Matrix-vector products with a 2^12 x 2^12 EuclideanMatrix, against the loop they replace: a
+// std::vector<double> copy of each row (through the std::vector conversion) dotted with a copy
+// of the vector.
+//
+// Reports bytes/s of matrix read (bytes_per_second) for the naive loop, Apply and
+// ApplyTransposed on one thread and on a ThreadPool with every hardware thread, and
+// "GFLOPS" for the product of the matrix with a batch of 2^8 vectors.
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "assignments/ev/euclidean_matrix.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/euclidean_vector_testing.h"
+#include "assignments/ev/thread_pool.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+constexpr int kDimensions = 1 << 12;
+constexpr int kBatchVectors = 1 << 8;
+
+ThreadPool& Pool() {
+  static ThreadPool pool{static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
+  return pool;
+}
+
+const std::vector<EuclideanVector>& Rows() {
+  static const auto rows = ev_testing::RandomVectors(kDimensions, kDimensions, 1);
+  return rows;
+}
+
+void SetBytes(benchmark::State& state) {
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(kDimensions) *
+                          kDimensions * static_cast<std::int64_t>(sizeof(double)));
+}
+
+void BM_NaiveApply(benchmark::State& state) {
+  const auto& rows = Rows();
+  const auto v = ev_testing::RandomVectors(1, kDimensions, 2)[0];
+  for (auto _ : state) {
+    const auto x = static_cast<std::vector<double>>(v);
+    std::vector<double> out(kDimensions);
+    for (int r = 0; r < kDimensions; r++) {
+      const auto row = static_cast<std::vector<double>>(rows[r]);
+      double sum = 0.0;
+      for (int c = 0; c < kDimensions; c++)
+        sum += row[c] * x[c];
+      out[r] = sum;
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  SetBytes(state);
+}
+
+void BM_Apply(benchmark::State& state) {
+  const auto m = EuclideanMatrix(Rows());
+  const auto v = ev_testing::RandomVectors(1, kDimensions, 2)[0];
+  ThreadPool* pool = state.range(0) != 0 ? &Pool() : nullptr;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(m.Apply(v, pool));
+  SetBytes(state);
+}
+
+void BM_ApplyTransposed(benchmark::State& state) {
+  const auto m = EuclideanMatrix(Rows());
+  const auto v = ev_testing::RandomVectors(1, kDimensions, 2)[0];
+  ThreadPool* pool = state.range(0) != 0 ? &Pool() : nullptr;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(m.ApplyTransposed(v, pool));
+  SetBytes(state);
+}
+
+void BM_ApplyBatch(benchmark::State& state) {
+  const auto m = EuclideanMatrix(Rows());
+  const auto batch = EuclideanVectorBatch(ev_testing::RandomVectors(kBatchVectors, kDimensions, 3));
+  ThreadPool* pool = state.range(0) != 0 ? &Pool() : nullptr;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(m.Apply(batch, pool));
+  state.counters["GFLOPS"] = benchmark::Counter(
+      static_cast<double>(state.iterations()) * 2.0 * kBatchVectors * kDimensions * kDimensions /
+          1e9,
+      benchmark::Counter::kIsRate);
+}
+
+// The argument is 1 to run on Pool()
+BENCHMARK(BM_NaiveApply)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Apply)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ApplyTransposed)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ApplyBatch)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
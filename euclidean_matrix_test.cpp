@@ -0,0 +1,172 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Every product of an EuclideanMatrix is checked against the same product computed entry by
+  entry with plain loops, within the bound of the dot products it is made of. The matrices have
+  numbers of rows and columns that are not multiples of 4, kMatrixChunkRows or
+  kMatrixChunkColumns, so that the remainder rows, partial chunks and several chunks are all
+  exercised.
+
+  The results with a ThreadPool must be the very same numbers, and the product of a batch must
+  agree with the products of its vectors one by one.
+  Failure scenarios follow the EuclideanVector error messages.
+
+*/
+
+#include <cfloat>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_matrix.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/euclidean_vector_testing.h"
+#include "assignments/ev/thread_pool.h"
+#include "catch.h"
+
+namespace {
+
+// Requires every entry of result to be within 4 * n * DBL_EPSILON * sum |m_i| |v_i| of the
+// product computed entry by entry
+void RequireProduct(const std::vector<EuclideanVector>& rows,
+                    const EuclideanVector& v,
+                    bool transposed,
+                    const EuclideanVector& result) {
+  const int numRows = static_cast<int>(rows.size());
+  const int numColumns = rows.empty() ? 0 : rows[0].GetNumDimensions();
+  const int n = transposed ? numRows : numColumns;
+  REQUIRE(result.GetNumDimensions() == (transposed ? numColumns : numRows));
+  for (int i = 0; i < result.GetNumDimensions(); i++) {
+    double expected = 0.0;
+    double magnitude = 0.0;
+    for (int j = 0; j < n; j++) {
+      const double m = transposed ? rows[j][i] : rows[i][j];
+      expected += m * v[j];
+      magnitude += std::abs(m * v[j]);
+    }
+    REQUIRE(std::abs(result[i] - expected) <= 4 * n * DBL_EPSILON * magnitude);
+  }
+}
+
+}  // namespace
+
+SCENARIO("Apply a matrix and its transpose to a vector") {
+  for (int numRows : {7, 1030}) {
+    const int numColumns = numRows == 7 ? 5 : 2053;
+    GIVEN("That there is a " + std::to_string(numRows) + " x " + std::to_string(numColumns) +
+          " matrix") {
+      const auto rows = ev_testing::RandomVectors(numRows, numColumns, 1);
+      const auto m = EuclideanMatrix(rows);
+      REQUIRE(m.GetNumRows() == numRows);
+      REQUIRE(m.GetNumColumns() == numColumns);
+      WHEN("It is applied to a vector") {
+        const auto v = ev_testing::RandomVectors(1, numColumns, 2)[0];
+        const auto result = m.Apply(v);
+        THEN("Every entry is within the bound of the dot product of its row") {
+          RequireProduct(rows, v, false, result);
+        }
+        AND_WHEN("It is applied with a ThreadPool of 4 threads") {
+          auto pool = ThreadPool(4);
+          THEN("The entries are identical") { REQUIRE(m.Apply(v, &pool) == result); }
+        }
+      }
+      WHEN("Its transpose is applied to a vector") {
+        const auto v = ev_testing::RandomVectors(1, numRows, 3)[0];
+        const auto result = m.ApplyTransposed(v);
+        THEN("Every entry is within the bound of the dot product of its column") {
+          RequireProduct(rows, v, true, result);
+        }
+        AND_WHEN("It is applied with a ThreadPool of 4 threads") {
+          auto pool = ThreadPool(4);
+          THEN("The entries are identical") { REQUIRE(m.ApplyTransposed(v, &pool) == result); }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Apply a matrix to a batch of vectors") {
+  GIVEN("That there is a 130 x 300 matrix and a batch of 137 vectors") {
+    const auto rows = ev_testing::RandomVectors(130, 300, 4);
+    const auto m = EuclideanMatrix(EuclideanVectorBatch(
+        rows, EuclideanVectorBatch::Layout::kStructureOfArrays));
+    const auto vectors = ev_testing::RandomVectors(137, 300, 5);
+    const auto batch = EuclideanVectorBatch(vectors);
+    WHEN("The matrix is applied to the batch") {
+      const auto result = m.Apply(batch);
+      THEN("Every row of the result is within the bound of the product of its vector") {
+        REQUIRE(result.GetNumVectors() == 137);
+        REQUIRE(result.GetNumDimensions() == 130);
+        for (int i = 0; i < 137; i++)
+          RequireProduct(rows, vectors[i], false, EuclideanVector(result.Row(i)));
+      }
+      AND_WHEN("It is applied with a ThreadPool of 4 threads") {
+        auto pool = ThreadPool(4);
+        const auto threaded = m.Apply(batch, &pool);
+        THEN("The entries are identical") {
+          for (int i = 0; i < 137; i++) {
+            for (int r = 0; r < 130; r++)
+              REQUIRE(threaded(i, r) == result(i, r));
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Access the entries of a matrix") {
+  GIVEN("That there is a 2 x 3 matrix of zeros") {
+    auto m = EuclideanMatrix(2, 3);
+    WHEN("Entry (1, 2) is set to 4") {
+      m.at(1, 2) = 4.0;
+      THEN("It is read back and row 1 has it") {
+        REQUIRE(m(1, 2) == 4.0);
+        REQUIRE(m.at(0, 2) == 0.0);
+        const std::vector<double> row{0, 0, 4};
+        REQUIRE(EuclideanVector(m.Row(1)) == EuclideanVector(row.begin(), row.end()));
+      }
+    }
+  }
+}
+
+SCENARIO("Use a matrix with invalid arguments") {
+  GIVEN("That there is a 2 x 3 matrix") {
+    const auto m = EuclideanMatrix(ev_testing::RandomVectors(2, 3, 6));
+    WHEN("It is applied to a vector with 2 dimensions") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(m.Apply(EuclideanVector(2)),
+                            "Dimensions of LHS(3) and RHS(2) do not match");
+      }
+    }
+    WHEN("Its transpose is applied to a vector with 3 dimensions") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(m.ApplyTransposed(EuclideanVector(3)),
+                            "Dimensions of LHS(2) and RHS(3) do not match");
+      }
+    }
+    WHEN("It is applied to a batch of vectors with 4 dimensions") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(m.Apply(EuclideanVectorBatch(5, 4)),
+                            "Dimensions of LHS(3) and RHS(4) do not match");
+      }
+    }
+    WHEN("Entries outside of it are accessed") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(m.at(2, 0), "Index 2 is not valid for this EuclideanMatrix object");
+        REQUIRE_THROWS_WITH(m.at(0, 3), "Column 3 is not valid for this EuclideanMatrix object");
+        REQUIRE_THROWS_WITH(m.Row(-1), "Index -1 is not valid for this EuclideanMatrix object");
+      }
+    }
+  }
+  GIVEN("That there are rows with 3 and 4 dimensions") {
+    std::vector<EuclideanVector> rows{EuclideanVector(3), EuclideanVector(4)};
+    WHEN("A matrix is made of them") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(EuclideanMatrix(rows),
+                            "Dimensions of LHS(3) and RHS(4) do not match");
+      }
+    }
+  }
+}
@@ -1,129 +1,417 @@
 // Created By : Rahil Agrawal
 
 #include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_kernels.h"
 
 #include <algorithm>  // Look at these - they are helpful https://en.cppreference.com/w/cpp/algorithm
 #include <cassert>
+#include <charconv>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <list>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+namespace {
+
+bool IsSpace(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+const char* SkipSpaces(const char* first, const char* last) noexcept {
+  while (first != last && IsSpace(*first))
+    first++;
+  return first;
+}
+
+// Writes magnitudes[0, length) separated by single spaces (and preceded by one if
+// leadingSpace) into [first, last)
+template <typename T>
+std::to_chars_result FormatMagnitudes(char* first,
+                                      char* last,
+                                      const T* magnitudes,
+                                      int length,
+                                      bool leadingSpace) noexcept {
+  for (int i = 0; i < length; i++) {
+    if (i != 0 || leadingSpace) {
+      if (first == last)
+        return {last, std::errc::value_too_large};
+      *first++ = ' ';
+    }
+    auto result = std::to_chars(first, last, magnitudes[i]);
+    if (result.ec != std::errc{})
+      return result;
+    first = result.ptr;
+  }
+  return {first, std::errc{}};
+}
+
+template <typename T>
+std::ostream& WriteMagnitudes(std::ostream& os, const T* magnitudes, int length) noexcept {
+  // A block of magnitudes at a time, so that large vectors do not need a large buffer
+  constexpr int kBlock = 128;
+  char buffer[kBlock * (kMaxFormattedMagnitudeLength + 1)];
+  os.put('[');
+  for (int begin = 0; begin < length; begin += kBlock) {
+    const int count = std::min(kBlock, length - begin);
+    auto result = FormatMagnitudes(buffer, buffer + sizeof(buffer), magnitudes + begin, count,
+                                   begin != 0);
+    os.write(buffer, result.ptr - buffer);
+  }
+  os.put(']');
+  return os;
+}
+
+// Magnitudes converted to double at a time by the accuracy policies for float vectors
+constexpr int kConversionBlock = 256;
+
+// The dot product of the kFast policy, in double
+double FastDot(const double* a, const double* b, int n) noexcept {
+  return ev_kernels::Dot(a, b, n);
+}
+
+double FastDot(const float* a, const float* b, int n) noexcept {
+  return ev_kernels::DotInDouble(a, b, n);
+}
+
+// Calls f(a, b, length) over the magnitudes as doubles: double magnitudes in one call, float
+// magnitudes block by block through a buffer on the stack (the conversion is exact)
+template <typename T, typename F>
+void ForEachDoubleBlock(const T* a, const T* b, int n, F f) {
+  if constexpr (std::is_same<T, double>::value) {
+    f(a, b, n);
+  } else {
+    double aBlock[kConversionBlock];
+    double bBlock[kConversionBlock];
+    for (int begin = 0; begin < n; begin += kConversionBlock) {
+      const int length = std::min(kConversionBlock, n - begin);
+      std::copy(a + begin, a + begin + length, aBlock);
+      if (b != a)
+        std::copy(b + begin, b + begin + length, bBlock);
+      f(aBlock, b != a ? bBlock : aBlock, length);
+    }
+  }
+}
+
+template <typename T>
+double PairwiseDot(const T* a, const T* b, int n) noexcept {
+  if (n <= kPairwiseSummationBlock)
+    return FastDot(a, b, n);
+  // Every leaf but the last is a whole block
+  const int half = (n / kPairwiseSummationBlock + 1) / 2 * kPairwiseSummationBlock;
+  return PairwiseDot(a, b, half) + PairwiseDot(a + half, b + half, n - half);
+}
+
+template <typename T>
+double CompensatedDot(const T* a, const T* b, int n) {
+  double sum = 0.0;
+  double compensation = 0.0;
+  ForEachDoubleBlock(a, b, n, [&](const double* x, const double* y, int length) {
+    ev_kernels::DotCompensated(x, y, length, &sum, &compensation);
+  });
+  return sum + compensation;
+}
+
+template <typename T>
+double MaxAbs(const T* a, int n) {
+  double m = 0.0;
+  ForEachDoubleBlock(a, a, n, [&m](const double* x, const double*, int length) {
+    m = std::max(m, ev_kernels::MaxAbs(x, length));
+  });
+  return m;
+}
+
+// Exponent e such that |magnitude| * 2^-e is in [1, 2) for the largest magnitude, clamped to
+// [-1022, 1022] so that 2^-e is a normal double (2^-1023 is subnormal, and flushed to 0 under
+// -ffast-math). The largest magnitude then scales to [2, 4) above 2^1023 and below 1 under
+// 2^-1022, which still neither overflows nor underflows.
+int ScaleExponent(double maxAbs) noexcept {
+  return std::min(std::max(std::ilogb(maxAbs), -1022), 1022);
+}
+
+template <typename T>
+double ScaledDot(const T* a, const T* b, int n) {
+  const double maxA = MaxAbs(a, n);
+  const double maxB = MaxAbs(b, n);
+  // Zeros, infinities and NaNs have nothing to gain from scaling
+  if (maxA == 0.0 || maxB == 0.0 || !std::isfinite(maxA) || !std::isfinite(maxB))
+    return FastDot(a, b, n);
+
+  const int exponentA = ScaleExponent(maxA);
+  const int exponentB = ScaleExponent(maxB);
+  const double scaleA = std::ldexp(1.0, -exponentA);
+  const double scaleB = std::ldexp(1.0, -exponentB);
+  double sum = 0.0;
+  ForEachDoubleBlock(a, b, n, [&](const double* x, const double* y, int length) {
+    sum += ev_kernels::ScaledDot(x, scaleA, y, scaleB, length);
+  });
+  return std::ldexp(sum, exponentA + exponentB);
+}
+
+template <typename T>
+double ScaledNorm(const T* a, int n) {
+  const double maxA = MaxAbs(a, n);
+  if (maxA == 0.0 || !std::isfinite(maxA))
+    return std::sqrt(FastDot(a, a, n));
+
+  const int exponent = ScaleExponent(maxA);
+  const double scale = std::ldexp(1.0, -exponent);
+  double sum = 0.0;
+  ForEachDoubleBlock(a, a, n, [&](const double* x, const double*, int length) {
+    sum += ev_kernels::ScaledDot(x, scale, x, scale, length);
+  });
+  return std::ldexp(std::sqrt(sum), exponent);
+}
+
+}  // namespace
+
+namespace ev_detail {
+
+void Throw(const std::string& what) {
+#if EUCLIDEAN_VECTOR_EXCEPTIONS
+  throw EuclideanVectorError(what);
+#else
+  std::fprintf(stderr, "EuclideanVectorError: %s\n", what.c_str());
+  std::abort();
+#endif
+}
+
+void ThrowDimensionMismatch(int lhs, int rhs) {
+  std::ostringstream ss;
+  ss << "Dimensions of LHS(" << lhs << ") and RHS(" << rhs << ") do not match";
+  Throw(ss.str());
+}
+
+double ContiguousDot(const double* u, const double* v, int length) {
+  return ev_kernels::Dot(u, v, length);
+}
+
+void ContiguousApply(Plus, double* out, const double* u, const double* v, int length) noexcept {
+  ev_kernels::Add(out, u, v, length);
+}
+
+void ContiguousApply(Minus, double* out, const double* u, const double* v, int length) noexcept {
+  ev_kernels::Subtract(out, u, v, length);
+}
+
+void ContiguousApply(Multiplies, double* out, const double* u, double d, int length) noexcept {
+  ev_kernels::Scale(out, u, d, length);
+}
+
+void ContiguousApply(Divides, double* out, const double* u, double d, int length) noexcept {
+  ev_kernels::Divide(out, u, d, length);
+}
+
+void ContiguousApply(Plus, float* out, const float* u, const float* v, int length) noexcept {
+  ev_kernels::Add(out, u, v, length);
+}
+
+void ContiguousApply(Minus, float* out, const float* u, const float* v, int length) noexcept {
+  ev_kernels::Subtract(out, u, v, length);
+}
+
+void ContiguousApply(Multiplies, float* out, const float* u, float d, int length) noexcept {
+  ev_kernels::Scale(out, u, d, length);
+}
+
+void ContiguousApply(Divides, float* out, const float* u, float d, int length) noexcept {
+  ev_kernels::Divide(out, u, d, length);
+}
+
+std::ostream& WriteText(std::ostream& os, const double* magnitudes, int length) noexcept {
+  return WriteMagnitudes(os, magnitudes, length);
+}
+
+std::ostream& WriteText(std::ostream& os, const float* magnitudes, int length) noexcept {
+  return WriteMagnitudes(os, magnitudes, length);
+}
+
+}  // namespace ev_detail
+
 // Constructors
 
-EuclideanVector::EuclideanVector(int i) : EuclideanVector::EuclideanVector(i, 0.0) {}
+template <typename T>
+BasicEuclideanVector<T>::BasicEuclideanVector(int i, const allocator_type& alloc)
+  : BasicEuclideanVector::BasicEuclideanVector(i, T{0}, alloc) {}
 
-EuclideanVector::EuclideanVector(int i, double d) : vectorLength_{i} {
-  magnitudes_ = std::make_unique<double[]>(i);
+template <typename T>
+BasicEuclideanVector<T>::BasicEuclideanVector(int i, T d, const allocator_type& alloc)
+  : resource_{alloc.resource()} {
+  Allocate(i);
   for (int k = 0; k < i; k++)
     magnitudes_[k] = d;
 }
 
-EuclideanVector::EuclideanVector(std::vector<double>::const_iterator begin,
-                                 std::vector<double>::const_iterator end) {
-  vectorLength_ = end - begin;
-  magnitudes_ = std::make_unique<double[]>(vectorLength_);
-  std::copy(begin, end, magnitudes_.get());
+template <typename T>
+BasicEuclideanVector<T>::BasicEuclideanVector(typename std::vector<T>::const_iterator begin,
+                                              typename std::vector<T>::const_iterator end,
+                                              const allocator_type& alloc)
+  : resource_{alloc.resource()} {
+  Allocate(end - begin);
+  std::copy(begin, end, magnitudes_);
 }
 
-EuclideanVector::EuclideanVector(const EuclideanVector& e) : vectorLength_{e.vectorLength_} {
-  magnitudes_ = std::make_unique<double[]>(vectorLength_);
-  std::copy(e.magnitudes_.get(), e.magnitudes_.get() + e.vectorLength_, magnitudes_.get());
+template <typename T>
+BasicEuclideanVector<T>::BasicEuclideanVector(const BasicEuclideanVector& e)
+  : BasicEuclideanVector::BasicEuclideanVector(e, allocator_type{}) {}
+
+template <typename T>
+BasicEuclideanVector<T>::BasicEuclideanVector(const BasicEuclideanVector& e,
+                                              const allocator_type& alloc)
+  : resource_{alloc.resource()} {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kDeepCopies);
+  Allocate(e.vectorLength_);
+  std::copy(e.magnitudes_, e.magnitudes_ + e.vectorLength_, magnitudes_);
+  CopyNormCache(e);
 }
 
-EuclideanVector::EuclideanVector(EuclideanVector&& e)
-  : magnitudes_{std::move(e.magnitudes_)}, vectorLength_{e.vectorLength_} {
-  e.vectorLength_ = 0;
+template <typename T>
+BasicEuclideanVector<T>::BasicEuclideanVector(BasicEuclideanVector&& e) noexcept
+  : resource_{e.resource_} {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kMoves);
+  CopyNormCache(e);
+  StealFrom(e);
 }
 
-// Operations
-
-EuclideanVector& EuclideanVector::operator=(const EuclideanVector& e) noexcept {
-  vectorLength_ = e.vectorLength_;
-  magnitudes_.release();
-  magnitudes_ = std::make_unique<double[]>(vectorLength_);
-  std::copy(e.magnitudes_.get(), e.magnitudes_.get() + e.vectorLength_, magnitudes_.get());
-  return *this;
+template <typename T>
+BasicEuclideanVector<T>::BasicEuclideanVector(BasicEuclideanVector&& e,
+                                              const allocator_type& alloc)
+  : resource_{alloc.resource()} {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kMoves);
+  CopyNormCache(e);
+  MoveFrom(e);
 }
 
-EuclideanVector& EuclideanVector::operator=(EuclideanVector&& e) noexcept {
-  vectorLength_ = e.vectorLength_;
-  e.vectorLength_ = 0;
-  magnitudes_.release();
-  magnitudes_ = std::move(e.magnitudes_);
-  return *this;
+template <typename T>
+BasicEuclideanVector<T>::~BasicEuclideanVector() {
+  Release();
 }
 
-double& EuclideanVector::operator[](const int index) noexcept {
-  assert(index >= 0 && index < vectorLength_);
+// Friends
 
-  return magnitudes_[index];
-}
+template <typename T>
+double Dot(const BasicEuclideanVector<T>& u,
+           const BasicEuclideanVector<T>& v,
+           Accumulation accumulation) {
+  ev_detail::CheckDimensions(u.GetNumDimensions(), v.GetNumDimensions());
 
-double EuclideanVector::operator[](const int index) const noexcept {
-  assert(index >= 0 && index < vectorLength_);
+  if constexpr (std::is_same<T, float>::value) {
+    if (accumulation == Accumulation::kDouble)
+      return ev_kernels::DotInDouble(u.data(), v.data(), u.GetNumDimensions());
+  }
+  return ev_kernels::Dot(u.data(), v.data(), u.GetNumDimensions());
+}
 
-  return magnitudes_[index];
+template <typename T>
+double Dot(const BasicEuclideanVector<T>& u, const BasicEuclideanVector<T>& v, Accuracy accuracy) {
+  ev_detail::CheckDimensions(u.GetNumDimensions(), v.GetNumDimensions());
+
+  const int n = u.GetNumDimensions();
+  switch (accuracy) {
+    case Accuracy::kPairwise:
+      return PairwiseDot(u.data(), v.data(), n);
+    case Accuracy::kCompensated:
+      return CompensatedDot(u.data(), v.data(), n);
+    case Accuracy::kScaled:
+      return ScaledDot(u.data(), v.data(), n);
+    case Accuracy::kFast:
+      break;
+  }
+  return Dot(u, v);
 }
 
-EuclideanVector& EuclideanVector::operator+=(const EuclideanVector& v) {
-  if (vectorLength_ != v.vectorLength_) {
-    std::ostringstream ss;
-    ss << "Dimensions of LHS(" << vectorLength_ << ") and RHS(" << v.vectorLength_
-       << ") do not match";
-    throw EuclideanVectorError(ss.str());
+// Operations
+
+template <typename T>
+BasicEuclideanVector<T>& BasicEuclideanVector<T>::operator=(
+    const BasicEuclideanVector& e) noexcept {
+  if (this == &e)
+    return *this;
+  ev_instrumentation::Count(ev_instrumentation::Counter::kDeepCopies);
+  // Same number of dimensions: reuse the storage we already have
+  if (vectorLength_ != e.vectorLength_) {
+    Release();
+    Allocate(e.vectorLength_);
   }
+  std::copy(e.magnitudes_, e.magnitudes_ + e.vectorLength_, magnitudes_);
+  InvalidateNorm();
+  return *this;
+}
 
-  for (int i = 0; i < vectorLength_; i++)
-    magnitudes_[i] += v.magnitudes_[i];
+template <typename T>
+BasicEuclideanVector<T>& BasicEuclideanVector<T>::operator=(BasicEuclideanVector&& e) noexcept {
+  if (this == &e)
+    return *this;
+  ev_instrumentation::Count(ev_instrumentation::Counter::kMoves);
+  Release();
+  MoveFrom(e);
+  return *this;
+}
+
+template <typename T>
+BasicEuclideanVector<T>& BasicEuclideanVector<T>::operator+=(const BasicEuclideanVector& v) {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kPlusAssign);
+  ev_detail::CheckDimensions(vectorLength_, v.vectorLength_);
+
+  ev_kernels::Add(magnitudes_, v.magnitudes_, vectorLength_);
+  InvalidateNorm();
 
   return *this;
 }
 
-EuclideanVector& EuclideanVector::operator-=(const EuclideanVector& v) {
-  if (vectorLength_ != v.vectorLength_) {
-    std::ostringstream ss;
-    ss << "Dimensions of LHS(" << vectorLength_ << ") and RHS(" << v.vectorLength_
-       << ") do not match";
-    throw EuclideanVectorError(ss.str());
-  }
+template <typename T>
+BasicEuclideanVector<T>& BasicEuclideanVector<T>::operator-=(const BasicEuclideanVector& v) {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kMinusAssign);
+  ev_detail::CheckDimensions(vectorLength_, v.vectorLength_);
 
-  for (int i = 0; i < vectorLength_; i++)
-    magnitudes_[i] -= v.magnitudes_[i];
+  ev_kernels::Subtract(magnitudes_, v.magnitudes_, vectorLength_);
+  InvalidateNorm();
 
   return *this;
 }
 
-EuclideanVector& EuclideanVector::operator*=(const double d) noexcept {
-  for (int i = 0; i < vectorLength_; i++)
-    magnitudes_[i] *= d;
+template <typename T>
+BasicEuclideanVector<T>& BasicEuclideanVector<T>::operator*=(const T d) noexcept {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kMultiplyAssign);
+  ev_kernels::Scale(magnitudes_, d, vectorLength_);
+  // |d * v| = |d| |v|, so a cached norm stays known
+  KeepScaledNorm(cachedNorm_ * std::abs(static_cast<double>(d)));
 
   return *this;
 }
 
-EuclideanVector& EuclideanVector::operator/=(const double d) {
+template <typename T>
+BasicEuclideanVector<T>& BasicEuclideanVector<T>::operator/=(const T d) {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kDivideAssign);
   if (d == 0)
-    throw EuclideanVectorError("Invalid vector division by 0");
+    ev_detail::Throw("Invalid vector division by 0");
 
-  for (int i = 0; i < vectorLength_; i++)
-    magnitudes_[i] /= d;
+  ev_kernels::Divide(magnitudes_, d, vectorLength_);
+  KeepScaledNorm(cachedNorm_ / std::abs(static_cast<double>(d)));
 
   return *this;
 }
 
-EuclideanVector::operator std::vector<double>() const noexcept {
-  std::vector<double> mags;
+template <typename T>
+BasicEuclideanVector<T>::operator std::vector<T>() const noexcept {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kVectorConversions);
+  std::vector<T> mags;
   for (int i = 0; i < vectorLength_; i++)
     mags.push_back(magnitudes_[i]);
 
   return mags;
 }
 
-EuclideanVector::operator std::list<double>() const noexcept {
-  std::list<double> mags;
+template <typename T>
+BasicEuclideanVector<T>::operator std::list<T>() const noexcept {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kListConversions);
+  std::list<T> mags;
   for (int i = 0; i < vectorLength_; i++)
     mags.push_back(magnitudes_[i]);
 
@@ -131,51 +419,323 @@ EuclideanVector::operator std::list<double>() const noexcept {
 }
 
 // Methods
-double& EuclideanVector::at(int index) {
+template <typename T>
+T& BasicEuclideanVector<T>::at(int index) {
   if (index < 0 || index >= vectorLength_) {
     std::ostringstream ss;
     ss << "Index " << index << " is not valid for this EuclideanVector object";
-    throw EuclideanVectorError(ss.str());
+    ev_detail::Throw(ss.str());
   }
 
+  InvalidateNorm();
   return magnitudes_[index];
 }
 
-double EuclideanVector::at(int index) const {
+template <typename T>
+T BasicEuclideanVector<T>::at(int index) const {
   if (index < 0 || index >= vectorLength_) {
     std::ostringstream ss;
     ss << "Index " << index << " is not valid for this EuclideanVector object";
-    throw EuclideanVectorError(ss.str());
+    ev_detail::Throw(ss.str());
   }
 
   return magnitudes_[index];
 }
 
-int EuclideanVector::GetNumDimensions() const noexcept {
-  return vectorLength_;
+template <typename T>
+double BasicEuclideanVector<T>::GetEuclideanNorm(Accumulation accumulation) const {
+  if (vectorLength_ == 0)
+    ev_detail::Throw("EuclideanVector with no dimensions does not have a norm");
+
+  // Double vectors accumulate in double either way
+  const bool inDouble = std::is_same<T, float>::value && accumulation == Accumulation::kDouble;
+  const auto state = inDouble ? NormState::kDouble : NormState::kNative;
+  if (cacheNorm_ && normState_ == state)
+    return cachedNorm_;
+
+  double sumOfSquares;
+  if constexpr (std::is_same<T, float>::value)
+    sumOfSquares = inDouble ? ev_kernels::SumOfSquaresInDouble(magnitudes_, vectorLength_)
+                            : ev_kernels::SumOfSquares(magnitudes_, vectorLength_);
+  else
+    sumOfSquares = ev_kernels::SumOfSquares(magnitudes_, vectorLength_);
+  const double norm = std::sqrt(sumOfSquares);
+  if (cacheNorm_) {
+    cachedNorm_ = norm;
+    normState_ = state;
+  }
+  return norm;
 }
-double EuclideanVector::GetEuclideanNorm() const {
+
+template <typename T>
+double BasicEuclideanVector<T>::GetEuclideanNorm(Accuracy accuracy) const {
   if (vectorLength_ == 0)
-    throw EuclideanVectorError("EuclideanVector with no dimensions does not have a norm");
+    ev_detail::Throw("EuclideanVector with no dimensions does not have a norm");
+
+  switch (accuracy) {
+    case Accuracy::kPairwise:
+      return std::sqrt(PairwiseDot(magnitudes_, magnitudes_, vectorLength_));
+    case Accuracy::kCompensated:
+      return std::sqrt(CompensatedDot(magnitudes_, magnitudes_, vectorLength_));
+    case Accuracy::kScaled:
+      return ScaledNorm(magnitudes_, vectorLength_);
+    case Accuracy::kFast:
+      break;
+  }
+  return GetEuclideanNorm();
+}
+
+template <typename T>
+void BasicEuclideanVector<T>::SetNormCaching(bool enable) noexcept {
+  cacheNorm_ = enable;
+  InvalidateNorm();
+}
+
+template <typename T>
+BasicEuclideanVector<T> BasicEuclideanVector<T>::CreateUnitVector() const& {
+  return *this / UnitVectorNorm();
+}
+
+template <typename T>
+BasicEuclideanVector<T> BasicEuclideanVector<T>::CreateUnitVector() && {
+  const double norm = UnitVectorNorm();
+  // Evaluated in our own magnitudes by the expiring expression constructor
+  return std::move(*this) / norm;
+}
+
+template <typename T>
+BasicEuclideanVector<T>& BasicEuclideanVector<T>::Axpy(T a, const BasicEuclideanVector& x) {
+  ev_detail::CheckDimensions(vectorLength_, x.vectorLength_);
+
+  ev_kernels::Axpy(magnitudes_, a, x.magnitudes_, vectorLength_);
+  InvalidateNorm();
+
+  return *this;
+}
+
+template <typename T>
+BasicEuclideanVector<T>& BasicEuclideanVector<T>::Axpby(T a, const BasicEuclideanVector& x, T b) {
+  ev_detail::CheckDimensions(vectorLength_, x.vectorLength_);
+
+  ev_kernels::Axpby(magnitudes_, a, x.magnitudes_, b, vectorLength_);
+  InvalidateNorm();
+
+  return *this;
+}
+
+template <typename T>
+BasicEuclideanVector<T>& BasicEuclideanVector<T>::AccumulateWeighted(
+    const std::vector<T>& weights,
+    const std::vector<const BasicEuclideanVector*>& vectors) {
+  if (weights.size() != vectors.size()) {
+    std::ostringstream ss;
+    ss << "Number of weights(" << weights.size() << ") and vectors(" << vectors.size()
+       << ") do not match";
+    ev_detail::Throw(ss.str());
+  }
+  // Validate everything up front so that *this is left untouched on error
+  for (const auto* v : vectors) {
+    assert(v != nullptr);
+    ev_detail::CheckDimensions(vectorLength_, v->vectorLength_);
+  }
+  // The blocks of *this change while the vectors are added, so *this is read from a copy
+  if (std::find(vectors.begin(), vectors.end(), this) != vectors.end()) {
+    const BasicEuclideanVector original = *this;
+    auto replaced = vectors;
+    std::replace(replaced.begin(), replaced.end(), static_cast<const BasicEuclideanVector*>(this),
+                 &original);
+    return AccumulateWeighted(weights, replaced);
+  }
 
-  double norm;
-  for (int i = 0; i < vectorLength_; i++) {
-    norm += pow(magnitudes_[i], 2);
+  // Walk *this once, in blocks small enough to stay in L1 while every input is added to them
+  constexpr int kBlock = 512;
+  for (int begin = 0; begin < vectorLength_; begin += kBlock) {
+    const int length = std::min(kBlock, vectorLength_ - begin);
+    for (std::size_t k = 0; k < vectors.size(); k++)
+      ev_kernels::Axpy(magnitudes_ + begin, weights[k], vectors[k]->magnitudes_ + begin,
+                       length);
   }
+  InvalidateNorm();
 
-  return std::sqrt(norm);
+  return *this;
 }
-EuclideanVector EuclideanVector::CreateUnitVector() const {
+
+template <typename T>
+double BasicEuclideanVector<T>::UnitVectorNorm() const {
   if (GetNumDimensions() == 0)
-    throw EuclideanVectorError("EuclideanVector with no dimensions does not have a unit vector");
+    ev_detail::Throw("EuclideanVector with no dimensions does not have a unit vector");
   double norm = GetEuclideanNorm();
   if (norm == 0.0)
-    throw EuclideanVectorError(
-        "EuclideanVector with euclidean normal of 0 does not have a unit vector");
+    ev_detail::Throw("EuclideanVector with euclidean normal of 0 does not have a unit vector");
 
-  std::vector<double> mags;
-  for (int i = 0; i < vectorLength_; i++)
-    mags.push_back(magnitudes_[i] / norm);
+  return norm;
+}
+
+// Storage
+
+template <typename T>
+void BasicEuclideanVector<T>::Allocate(int length) {
+  if (length < 0) {
+    std::ostringstream ss;
+    ss << "Number of dimensions " << length << " is not valid";
+    ev_detail::Throw(ss.str());
+  }
+  if (length <= kInlineDimensions) {
+    magnitudes_ = inline_;
+  } else {
+    magnitudes_ = static_cast<T*>(resource_->allocate(length * sizeof(T), alignof(T)));
+    ev_instrumentation::Count(ev_instrumentation::Counter::kAllocations);
+    ev_instrumentation::Count(ev_instrumentation::Counter::kBytesAllocated, length * sizeof(T));
+  }
+  vectorLength_ = length;
+}
+
+template <typename T>
+void BasicEuclideanVector<T>::Release() noexcept {
+  if (magnitudes_ != inline_)
+    resource_->deallocate(magnitudes_, vectorLength_ * sizeof(T), alignof(T));
+  magnitudes_ = inline_;
+  vectorLength_ = 0;
+  InvalidateNorm();
+}
+
+template <typename T>
+void BasicEuclideanVector<T>::MoveFrom(BasicEuclideanVector& e) {
+  if (resource_ == e.resource_ || resource_->is_equal(*e.resource_)) {
+    StealFrom(e);
+    return;
+  }
+  // Storage from another resource cannot be adopted; copy it and release the source
+  ev_instrumentation::Count(ev_instrumentation::Counter::kDeepCopies);
+  Allocate(e.vectorLength_);
+  std::copy(e.magnitudes_, e.magnitudes_ + e.vectorLength_, magnitudes_);
+  e.Release();
+}
 
-  return EuclideanVector(mags.begin(), mags.end());
+template <typename T>
+void BasicEuclideanVector<T>::StealFrom(BasicEuclideanVector& e) noexcept {
+  if (e.magnitudes_ == e.inline_) {
+    magnitudes_ = inline_;
+    std::copy(e.inline_, e.inline_ + e.vectorLength_, inline_);
+  } else {
+    magnitudes_ = e.magnitudes_;
+  }
+  vectorLength_ = e.vectorLength_;
+  e.magnitudes_ = e.inline_;
+  e.vectorLength_ = 0;
+  e.InvalidateNorm();
+}
+
+template <typename T>
+void BasicEuclideanVector<T>::KeepScaledNorm(const double scaled) noexcept {
+  cachedNorm_ = scaled;
+  // The magnitudes are scaled in T: past its max they overflow to inf, and below its smallest
+  // normal value they round, so the norm computed again is no longer |d| times the old one.
+  // Written so that a NaN or inf norm is forgotten too.
+  if (!(scaled <= std::numeric_limits<T>::max()) ||
+      (scaled != 0.0 && scaled < std::numeric_limits<T>::min()))
+    InvalidateNorm();
 }
+
+// Text format
+
+template <typename T>
+std::to_chars_result FormatTo(char* first, char* last, const BasicEuclideanVector<T>& v) noexcept {
+  if (first == last)
+    return {last, std::errc::value_too_large};
+  *first++ = '[';
+  auto result = FormatMagnitudes(first, last, v.data(), v.GetNumDimensions(), false);
+  if (result.ec != std::errc{})
+    return result;
+  if (result.ptr == last)
+    return {last, std::errc::value_too_large};
+  *result.ptr++ = ']';
+  return result;
+}
+
+template <typename T>
+std::string ToString(const BasicEuclideanVector<T>& v) {
+  std::string text(2 + static_cast<std::size_t>(v.GetNumDimensions()) *
+                           (kMaxFormattedMagnitudeLength + 1),
+                   '\0');
+  auto result = FormatTo(&text[0], &text[0] + text.size(), v);
+  text.resize(result.ptr - text.data());
+  return text;
+}
+
+template <typename T>
+std::from_chars_result FromChars(const char* first, const char* last, BasicEuclideanVector<T>& v) {
+  if (first == last || *first != '[')
+    return {first, std::errc::invalid_argument};
+
+  // Count the magnitudes first, so that the vector is allocated only once
+  int count = 0;
+  const char* p = SkipSpaces(first + 1, last);
+  while (p != last && *p != ']') {
+    count++;
+    while (p != last && *p != ']' && !IsSpace(*p))
+      p++;
+    p = SkipSpaces(p, last);
+  }
+  if (p == last)
+    return {p, std::errc::invalid_argument};
+
+  auto parsed = BasicEuclideanVector<T>(count, v.get_allocator());
+  p = first + 1;
+  for (int i = 0; i < count; i++) {
+    p = SkipSpaces(p, last);
+    auto result = std::from_chars(p, last, parsed[i]);
+    if (result.ec != std::errc{})
+      return {p, result.ec};
+    // The whole magnitude must be a number: "1.5x" is not
+    if (*result.ptr != ']' && !IsSpace(*result.ptr))
+      return {result.ptr, std::errc::invalid_argument};
+    p = result.ptr;
+  }
+  p = SkipSpaces(p, last);
+
+  v = std::move(parsed);
+  return {p + 1, std::errc{}};
+}
+
+template <typename T>
+std::istream& operator>>(std::istream& is, BasicEuclideanVector<T>& v) {
+  std::string text;
+  is >> std::ws;
+  if (!std::getline(is, text, ']') || is.eof()) {
+    is.setstate(std::ios::failbit);
+    return is;
+  }
+  text.push_back(']');
+
+  auto result = FromChars(text.data(), text.data() + text.size(), v);
+  if (result.ec != std::errc{} || result.ptr != text.data() + text.size())
+    is.setstate(std::ios::failbit);
+  return is;
+}
+
+// The library is built for double and float magnitudes
+
+template class BasicEuclideanVector<double>;
+template class BasicEuclideanVector<float>;
+
+template double Dot(const BasicEuclideanVector<double>&,
+                    const BasicEuclideanVector<double>&,
+                    Accumulation);
+template double Dot(const BasicEuclideanVector<float>&,
+                    const BasicEuclideanVector<float>&,
+                    Accumulation);
+template double Dot(const BasicEuclideanVector<double>&,
+                    const BasicEuclideanVector<double>&,
+                    Accuracy);
+template double Dot(const BasicEuclideanVector<float>&,
+                    const BasicEuclideanVector<float>&,
+                    Accuracy);
+template std::to_chars_result FormatTo(char*, char*, const BasicEuclideanVector<double>&) noexcept;
+template std::to_chars_result FormatTo(char*, char*, const BasicEuclideanVector<float>&) noexcept;
+template std::string ToString(const BasicEuclideanVector<double>&);
+template std::string ToString(const BasicEuclideanVector<float>&);
+template std::from_chars_result FromChars(const char*, const char*, BasicEuclideanVector<double>&);
+template std::from_chars_result FromChars(const char*, const char*, BasicEuclideanVector<float>&);
+template std::istream& operator>>(std::istream&, BasicEuclideanVector<double>&);
+template std::istream& operator>>(std::istream&, BasicEuclideanVector<float>&);
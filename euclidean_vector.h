@@ -3,13 +3,31 @@
 #ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_H_
 #define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_H_
 
+#include <cassert>
+#include <charconv>
 #include <exception>
+#include <functional>
+#include <istream>
 #include <list>
 #include <memory>
+#include <memory_resource>
+#include <ostream>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "assignments/ev/euclidean_vector_counters.h"
+
+// 1 when exceptions are enabled. Built with -fno-exceptions, the library reports every error by
+// printing the message of the EuclideanVectorError it would have thrown and calling std::abort().
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define EUCLIDEAN_VECTOR_EXCEPTIONS 1
+#else
+#define EUCLIDEAN_VECTOR_EXCEPTIONS 0
+#endif
+
 class EuclideanVectorError : public std::exception {
  public:
   explicit EuclideanVectorError(const std::string& what) : what_(what) {}
@@ -19,19 +37,261 @@ class EuclideanVectorError : public std::exception {
   std::string what_;
 };
 
-class EuclideanVector {
+template <typename T>
+class BasicEuclideanVector;
+
+// Vector of double magnitudes
+using EuclideanVector = BasicEuclideanVector<double>;
+
+// Base of every lazily evaluated EuclideanVector expression (CRTP). An expression only has to
+// provide GetNumDimensions(), a const operator[] and get_allocator(); nothing is computed until
+// the expression is assigned to, or used to construct, a EuclideanVector.
+template <typename E>
+class EuclideanVectorExpression {
  public:
+  const E& Derived() const noexcept { return static_cast<const E&>(*this); }
+  int GetNumDimensions() const noexcept { return Derived().GetNumDimensions(); }
+  double operator[](const int index) const noexcept { return Derived()[index]; }
+  // Allocator a EuclideanVector built from this expression uses (that of its leftmost vector)
+  std::pmr::polymorphic_allocator<double> get_allocator() const noexcept {
+    return Derived().get_allocator();
+  }
+};
+
+namespace ev_detail {
+
+// Throws EuclideanVectorError(what), or aborts without exceptions. Kept out of line so the
+// checks that call it stay small enough to inline.
+[[noreturn]] void Throw(const std::string& what);
+[[noreturn]] void ThrowDimensionMismatch(int lhs, int rhs);
+
+inline void CheckDimensions(int lhs, int rhs) {
+  if (lhs != rhs)
+    ThrowDimensionMismatch(lhs, rhs);
+}
+
+// Dot product of two contiguous arrays, computed by the SIMD kernels
+double ContiguousDot(const double* u, const double* v, int length);
+
+// Whether T keeps its magnitudes in one contiguous array of S, exposed through data()
+template <typename T, typename S = double, typename = void>
+struct HasContiguousData : std::false_type {};
+
+template <typename T, typename S>
+struct HasContiguousData<
+    T,
+    S,
+    std::enable_if_t<std::is_convertible<decltype(std::declval<const T&>().data()),
+                                         const S*>::value>> : std::true_type {};
+
+// Whether an expression may be written into an array of T by a SIMD kernel (see
+// EvaluateWithKernel)
+template <typename E, typename T, typename = void>
+struct HasKernelEvaluation : std::false_type {};
+
+template <typename E, typename T>
+struct HasKernelEvaluation<
+    E,
+    T,
+    std::void_t<decltype(std::declval<const E&>().EvaluateWithKernel(std::declval<T*>()))>>
+  : std::true_type {};
+
+// Whether an expression can tell which magnitudes it reads (see ReadsShifted)
+template <typename E, typename = void>
+struct HasReadsShifted : std::false_type {};
+
+template <typename E>
+struct HasReadsShifted<E,
+                       std::void_t<decltype(std::declval<const E&>().ReadsShifted(
+                           std::declval<const double*>(), 0))>> : std::true_type {};
+
+// Whether element i of e reads [first, first + length) at an index other than i, so that
+// writing the result into that array element by element would change elements of e still to
+// be read. Operands that are neither contiguous nor expressions are assumed not to.
+template <typename E>
+bool ReadsShifted(const E& e, const double* first, int length) noexcept {
+  if constexpr (HasContiguousData<E>::value) {
+    const double* data = e.data();
+    const std::less<const double*> before;
+    return data != first && before(data, first + length) &&
+           before(first, data + e.GetNumDimensions());
+  } else if constexpr (HasReadsShifted<E>::value) {
+    return e.ReadsShifted(first, length);
+  } else {
+    return false;
+  }
+}
+
+}  // namespace ev_detail
+
+// How dot products and norms of float vectors accumulate. kDouble still reads floats but
+// multiplies and adds in double, which is as accurate as a double vector at half the SIMD width.
+// Double vectors always accumulate in double.
+enum class Accumulation { kNative, kDouble };
+
+// How Dot and GetEuclideanNorm add up the products of the magnitudes, from fastest to safest.
+// Every policy runs on the SIMD kernels. All but kFast work in double, also for float vectors.
+//   kFast        : several partial sums with fused multiply-add, exactly as u * v and
+//                  GetEuclideanNorm(). Error at most 2 * n * DBL_EPSILON * sum(|u[i] * v[i]|).
+//   kPairwise    : kFast over blocks of kPairwiseSummationBlock magnitudes, whose sums are added
+//                  as a balanced binary tree, so the error grows with log2(n) instead of n.
+//   kCompensated : products and partial sums are split exactly into value and rounding error
+//                  and the errors are added up separately (Dot2 of Ogita, Rump and Oishi), which
+//                  is as accurate as working in twice the precision, even when products cancel.
+//   kScaled      : two passes, like LAPACK dnrm2: the largest |magnitude| gives a power of two
+//                  that scales the magnitudes (exactly) to at most 4 before they are multiplied, so
+//                  nothing overflows or underflows unless the result itself does. The norm of
+//                  {1e200, 1e200} is 1.414e200 instead of inf.
+enum class Accuracy { kFast, kPairwise, kCompensated, kScaled };
+
+constexpr int kPairwiseSummationBlock = 128;
+
+namespace ev_detail {
+
+template <typename T>
+struct IsBasicEuclideanVector : std::false_type {};
+
+template <typename T>
+struct IsBasicEuclideanVector<BasicEuclideanVector<T>> : std::true_type {};
+
+// Expressions convert to a vector implicitly; vectors of another scalar type only explicitly
+template <typename E>
+using EnableIfNotVector = std::enable_if_t<!IsBasicEuclideanVector<E>::value, int>;
+
+// Whether an expression can hand over a BasicEuclideanVector<T> it owns (see the expiring
+// expression constructor of BasicEuclideanVector)
+template <typename T, typename E, typename = void>
+struct HasExpiringVector : std::false_type {};
+
+template <typename T, typename E>
+struct HasExpiringVector<
+    T,
+    E,
+    std::void_t<decltype(std::declval<E&>().template ExpiringVector<T>())>> : std::true_type {};
+
+// Selects rvalue expressions only: a named expression may still be evaluated again
+template <typename T, typename E>
+using EnableIfExpiring =
+    std::enable_if_t<!std::is_reference<E>::value && HasExpiringVector<T, E>::value, int>;
+
+std::ostream& WriteText(std::ostream& os, const double* magnitudes, int length) noexcept;
+std::ostream& WriteText(std::ostream& os, const float* magnitudes, int length) noexcept;
+
+}  // namespace ev_detail
+
+// Dot product computed by the SIMD kernels. u * v is Dot(u, v).
+template <typename T>
+double Dot(const BasicEuclideanVector<T>& u,
+           const BasicEuclideanVector<T>& v,
+           Accumulation = Accumulation::kNative);
+template <typename T>
+double Dot(const BasicEuclideanVector<T>& u, const BasicEuclideanVector<T>& v, Accuracy);
+
+// Vectors with at most this many dimensions keep their magnitudes inside the object instead of
+// on the heap (0 always uses the heap). It sets the size of BasicEuclideanVector, so it must have
+// the same value in the library and in everything that uses it: bazel build --define
+// inline_dimensions=8 ... sets it for all. Never define it in a single file.
+#ifndef EUCLIDEAN_VECTOR_INLINE_DIMENSIONS
+#define EUCLIDEAN_VECTOR_INLINE_DIMENSIONS 4
+#endif
+
+/*
+  BasicEuclideanVector<T> stores its magnitudes as T, double or float (the library is built for
+  both). EuclideanVector is BasicEuclideanVector<double>. float vectors take half the memory and
+  bandwidth and the kernels process twice as many magnitudes per instruction; norms and dot
+  products are returned as double, optionally accumulated in double (see Accumulation).
+
+  Arithmetic expressions are evaluated in double and rounded once when they are stored, so for
+  float vectors u + v gives exactly the result of float arithmetic. Vectors of both scalar types
+  can be mixed inside an expression, but converting a vector to the other scalar type is
+  explicit: EuclideanVector(floatVector).
+
+  BasicEuclideanVector is allocator-aware: heap storage comes from a std::pmr::memory_resource
+  (std::pmr::get_default_resource() unless one is given), so vectors can live on a monotonic
+  arena or a pool and be released all at once. Propagation follows the std::pmr containers:
+    - copy construction uses the default resource, copy assignment keeps the target's resource
+    - move construction takes the source's resource; move assignment between different
+      resources copies the magnitudes into the target's resource
+    - vectors returned by the arithmetic operators use the resource of their leftmost operand
+  Constructors take a trailing allocator, so std::pmr containers of EuclideanVector pass their
+  resource on to their elements.
+
+  Norm caching is opt-in (SetNormCaching(true)). A caching vector computes its euclidean norm
+  once and returns it in O(1) until the magnitudes change: every non-const member (assignment,
+  +=, -=, Axpy, the non-const at(), operator[] and data(), ...) forgets it, except *= and /=,
+  which scale it by |d| (within a rounding of the norm computed again) unless the scaled norm
+  leaves the normal range of T, where the magnitudes overflow or lose precision. Writes through a
+  reference or pointer obtained before the norm was computed are not seen. Copies and moved-to
+  vectors keep the setting and the cached norm; assignment keeps the target's setting.
+  GetEuclideanNorm of a caching vector writes the cache, so it must not be called from several
+  threads at once.
+*/
+template <typename T>
+class BasicEuclideanVector : public EuclideanVectorExpression<BasicEuclideanVector<T>> {
+  static_assert(std::is_same<T, double>::value || std::is_same<T, float>::value,
+                "BasicEuclideanVector is only built for double and float");
+
+ public:
+  using value_type = T;
+  using allocator_type = std::pmr::polymorphic_allocator<T>;
+
+  static constexpr int kInlineDimensions = EUCLIDEAN_VECTOR_INLINE_DIMENSIONS;
+
   // Constructors
-  explicit EuclideanVector(int);
-  EuclideanVector(int, double);
-  EuclideanVector(std::vector<double>::const_iterator, std::vector<double>::const_iterator);
-  EuclideanVector(const EuclideanVector&);
+  explicit BasicEuclideanVector(int, const allocator_type& = {});
+  BasicEuclideanVector(int, T, const allocator_type& = {});
+  BasicEuclideanVector(typename std::vector<T>::const_iterator,
+                       typename std::vector<T>::const_iterator,
+                       const allocator_type& = {});
+  BasicEuclideanVector(const BasicEuclideanVector&);
+  BasicEuclideanVector(const BasicEuclideanVector&, const allocator_type&);
   // Move Constructor will reduce the number of dimensions of the given vector to 0
-  EuclideanVector(EuclideanVector&&);
+  BasicEuclideanVector(BasicEuclideanVector&&) noexcept;
+  BasicEuclideanVector(BasicEuclideanVector&&, const allocator_type&);
+  // Converts from the other scalar type, rounding to nearest when narrowing
+  template <typename U, std::enable_if_t<!std::is_same<U, T>::value, int> = 0>
+  explicit BasicEuclideanVector(const BasicEuclideanVector<U>& v, const allocator_type& alloc = {})
+    : resource_{alloc.resource()} {
+    ev_instrumentation::Count(ev_instrumentation::Counter::kDeepCopies);
+    Allocate(v.GetNumDimensions());
+    Assign(v);
+  }
+  // Evaluates the whole expression in a single pass
+  template <typename E, ev_detail::EnableIfNotVector<E> = 0>
+  BasicEuclideanVector(const EuclideanVectorExpression<E>& e)  // NOLINT(runtime/explicit)
+    : BasicEuclideanVector(e, e.get_allocator()) {}
+  template <typename E, ev_detail::EnableIfNotVector<E> = 0>
+  BasicEuclideanVector(const EuclideanVectorExpression<E>& e, const allocator_type& alloc)
+    : resource_{alloc.resource()} {
+    ev_instrumentation::Count(ev_instrumentation::Counter::kEvaluations);
+    Allocate(e.GetNumDimensions());
+    Assign(e.Derived());
+  }
+  // Evaluates an expiring expression that owns a vector, such as std::move(u) * 2.0 or f() + v,
+  // in that vector's magnitudes instead of allocating new ones
+  template <typename E, ev_detail::EnableIfExpiring<T, E> = 0>
+  BasicEuclideanVector(E&& e)  // NOLINT(runtime/explicit)
+    : BasicEuclideanVector(std::move(e), e.get_allocator()) {}
+  template <typename E, ev_detail::EnableIfExpiring<T, E> = 0>
+  BasicEuclideanVector(E&& e, const allocator_type& alloc) : resource_{alloc.resource()} {
+    BasicEuclideanVector* expiring = e.template ExpiringVector<T>();
+    if (expiring != nullptr &&
+        (expiring->resource_ == resource_ || resource_->is_equal(*expiring->resource_))) {
+      // Element i only reads element i of each operand, so it can be written in place
+      ev_instrumentation::Count(ev_instrumentation::Counter::kInPlaceEvaluations);
+      expiring->Assign(e);
+      StealFrom(*expiring);
+    } else {
+      ev_instrumentation::Count(ev_instrumentation::Counter::kEvaluations);
+      Allocate(e.GetNumDimensions());
+      Assign(e);
+    }
+  }
 
   // Friends
 
-  friend bool operator==(const EuclideanVector& u, const EuclideanVector& v) noexcept {
+  friend bool operator==(const BasicEuclideanVector& u, const BasicEuclideanVector& v) noexcept {
+    ev_instrumentation::Count(ev_instrumentation::Counter::kEqual);
     if (u.vectorLength_ != v.vectorLength_)
       return false;
     for (int i = 0; i < u.vectorLength_; i++) {
@@ -41,115 +301,449 @@ class EuclideanVector {
     return true;
   }
 
-  friend bool operator!=(const EuclideanVector& u, const EuclideanVector& v) noexcept {
+  friend bool operator!=(const BasicEuclideanVector& u, const BasicEuclideanVector& v) noexcept {
     return !(operator==(u, v));
   }
 
-  friend EuclideanVector operator+(const EuclideanVector& u, const EuclideanVector& v) {
-    if (u.vectorLength_ != v.vectorLength_) {
-      std::ostringstream ss;
-      ss << "Dimensions of LHS(" << u.vectorLength_ << ") and RHS(" << v.vectorLength_
-         << ") do not match";
-      throw EuclideanVectorError(ss.str());
-    }
-
-    std::vector<double> mags;
-    for (int i = 0; i < u.vectorLength_; i++)
-      mags.push_back(u.magnitudes_[i] + v.magnitudes_[i]);
+  // Dot product of two vectors, computed by the SIMD kernels
+  friend double operator*(const BasicEuclideanVector& u, const BasicEuclideanVector& v) {
+    ev_instrumentation::Count(ev_instrumentation::Counter::kDot);
+    return Dot(u, v);
+  }
 
-    return EuclideanVector(mags.begin(), mags.end());
+  // Prints [a b c] in the format of FormatTo
+  friend std::ostream& operator<<(std::ostream& os, const BasicEuclideanVector& v) noexcept {
+    return ev_detail::WriteText(os, v.magnitudes_, v.vectorLength_);
   }
 
-  friend EuclideanVector operator-(const EuclideanVector& u, const EuclideanVector& v) {
-    if (u.vectorLength_ != v.vectorLength_) {
-      std::ostringstream ss;
-      ss << "Dimensions of LHS(" << u.vectorLength_ << ") and RHS(" << v.vectorLength_
-         << ") do not match";
-      throw EuclideanVectorError(ss.str());
+  // Operations
+  BasicEuclideanVector& operator=(const BasicEuclideanVector&) noexcept;
+  // Move Assignment will reduce the number of dimensions of the given vector to 0
+  BasicEuclideanVector& operator=(BasicEuclideanVector&&) noexcept;
+  // Evaluates the whole expression in a single pass. The expression may refer to *this.
+  template <typename E, ev_detail::EnableIfNotVector<E> = 0>
+  BasicEuclideanVector& operator=(const EuclideanVectorExpression<E>& e) {
+    if (vectorLength_ != e.GetNumDimensions()) {
+      // A view of part of *this is differently sized, so the expression is evaluated into new
+      // storage before the old magnitudes are released
+      auto result = BasicEuclideanVector(e, get_allocator());
+      Release();
+      StealFrom(result);
+      return *this;
     }
-
-    std::vector<double> mags;
-    for (int i = 0; i < u.vectorLength_; i++)
-      mags.push_back(u.magnitudes_[i] - v.magnitudes_[i]);
-
-    return EuclideanVector(mags.begin(), mags.end());
+    ev_instrumentation::Count(ev_instrumentation::Counter::kEvaluations);
+    Assign(e.Derived());
+    InvalidateNorm();
+    return *this;
   }
+  T& operator[](const int index) noexcept {
+    assert(index >= 0 && index < vectorLength_);
 
-  friend double operator*(const EuclideanVector& u, const EuclideanVector& v) {
-    if (u.vectorLength_ != v.vectorLength_) {
-      std::ostringstream ss;
-      ss << "Dimensions of LHS(" << u.vectorLength_ << ") and RHS(" << v.vectorLength_
-         << ") do not match";
-      throw EuclideanVectorError(ss.str());
-    }
+    InvalidateNorm();
+    return magnitudes_[index];
+  }
+  T operator[](const int index) const noexcept {
+    assert(index >= 0 && index < vectorLength_);
 
-    double dotProd;
-    for (int i = 0; i < u.vectorLength_; i++)
-      dotProd += u.magnitudes_[i] * v.magnitudes_[i];
+    return magnitudes_[index];
+  }
+  BasicEuclideanVector& operator+=(const BasicEuclideanVector&);
+  BasicEuclideanVector& operator-=(const BasicEuclideanVector&);
+  // Adds (subtracts) any expression, such as a view, without first copying it into a vector
+  template <typename E>
+  BasicEuclideanVector& operator+=(const EuclideanVectorExpression<E>& e) {
+    ev_instrumentation::Count(ev_instrumentation::Counter::kPlusAssign);
+    ev_detail::CheckDimensions(vectorLength_, e.GetNumDimensions());
+    const E& expression = e.Derived();
+    for (int i = 0; i < vectorLength_; i++)
+      magnitudes_[i] = static_cast<T>(magnitudes_[i] + expression[i]);
+    InvalidateNorm();
+    return *this;
+  }
+  template <typename E>
+  BasicEuclideanVector& operator-=(const EuclideanVectorExpression<E>& e) {
+    ev_instrumentation::Count(ev_instrumentation::Counter::kMinusAssign);
+    ev_detail::CheckDimensions(vectorLength_, e.GetNumDimensions());
+    const E& expression = e.Derived();
+    for (int i = 0; i < vectorLength_; i++)
+      magnitudes_[i] = static_cast<T>(magnitudes_[i] - expression[i]);
+    InvalidateNorm();
+    return *this;
+  }
+  BasicEuclideanVector& operator*=(const T) noexcept;
+  BasicEuclideanVector& operator/=(const T);
+  explicit operator std::vector<T>() const noexcept;
+  explicit operator std::list<T>() const noexcept;
 
-    return dotProd;
+  // Methods
+  T& at(int);
+  T at(int) const;
+  int GetNumDimensions() const noexcept { return vectorLength_; }
+  allocator_type get_allocator() const noexcept { return resource_; }
+  // Contiguous magnitudes, for the kernels of the other components of the library
+  const T* data() const noexcept { return magnitudes_; }
+  T* data() noexcept {
+    InvalidateNorm();
+    return magnitudes_;
   }
+  // O(1) after the first call while norm caching is on and the magnitudes do not change
+  double GetEuclideanNorm(Accumulation = Accumulation::kNative) const;
+  // Only kFast uses (and fills) the norm cache
+  double GetEuclideanNorm(Accuracy) const;
+  // Turning caching off forgets the cached norm
+  void SetNormCaching(bool) noexcept;
+  bool IsNormCaching() const noexcept { return cacheNorm_; }
+  BasicEuclideanVector CreateUnitVector() const&;
+  // Divides the magnitudes of an expiring vector in place
+  BasicEuclideanVector CreateUnitVector() &&;
+  // In-place fused updates (no temporaries, one pass over *this)
+  // *this += a * x
+  BasicEuclideanVector& Axpy(T a, const BasicEuclideanVector& x);
+  // *this = a * x + b * *this
+  BasicEuclideanVector& Axpby(T a, const BasicEuclideanVector& x, T b);
+  // *this += weights[0] * *vectors[0] + weights[1] * *vectors[1] + ..., reading the vectors
+  // where they are. One of them may be *this, which is then read as it was before the update.
+  BasicEuclideanVector& AccumulateWeighted(const std::vector<T>& weights,
+                                           const std::vector<const BasicEuclideanVector*>& vectors);
 
-  friend EuclideanVector operator*(const EuclideanVector& u, const double d) noexcept {
-    std::vector<double> mags;
-    for (int i = 0; i < u.vectorLength_; i++)
-      mags.push_back(u.magnitudes_[i] * d);
+  // Destructor
+  ~BasicEuclideanVector();
 
-    return EuclideanVector(mags.begin(), mags.end());
+ private:
+  // Which accumulation the cached norm was computed with, if any
+  enum class NormState : unsigned char { kUnknown, kNative, kDouble };
+
+  template <typename E>
+  void Assign(const E& e) noexcept {
+    if constexpr (ev_detail::HasKernelEvaluation<E, T>::value) {
+      if (e.EvaluateWithKernel(magnitudes_))
+        return;
+    }
+    T* out = magnitudes_;
+    for (int i = 0; i < vectorLength_; i++)
+      out[i] = static_cast<T>(e[i]);
   }
 
-  friend EuclideanVector operator*(double d, const EuclideanVector& u) noexcept {
-    return operator*(u, d);
+  // Norm of a vector that has a unit vector
+  double UnitVectorNorm() const;
+  // Points magnitudes_ at inline_ when length <= kInlineDimensions, otherwise at an array from
+  // resource_
+  void Allocate(int length);
+  // Frees heap storage and leaves the vector with 0 dimensions
+  void Release() noexcept;
+  // Takes e's magnitudes and leaves e with 0 dimensions. e must use the same resource.
+  void StealFrom(BasicEuclideanVector& e) noexcept;
+  // As StealFrom, but copies into this vector's resource if e uses a different one
+  void MoveFrom(BasicEuclideanVector& e);
+  void InvalidateNorm() noexcept { normState_ = NormState::kUnknown; }
+  // Caches the norm scaled by *= or /=, or forgets it if that is outside the normal range of T
+  void KeepScaledNorm(double scaled) noexcept;
+  // Takes e's caching setting and cached norm
+  void CopyNormCache(const BasicEuclideanVector& e) noexcept {
+    cacheNorm_ = e.cacheNorm_;
+    normState_ = e.normState_;
+    cachedNorm_ = e.cachedNorm_;
   }
 
-  friend EuclideanVector operator/(const EuclideanVector& u, const double d) {
-    if (d == 0)
-      throw EuclideanVectorError("Invalid vector division by 0");
+  std::pmr::memory_resource* resource_;
+  T* magnitudes_;
+  int vectorLength_;
+  // Fit in the padding after vectorLength_
+  bool cacheNorm_ = false;
+  mutable NormState normState_ = NormState::kUnknown;
+  mutable double cachedNorm_ = 0.0;
+  T inline_[kInlineDimensions > 0 ? kInlineDimensions : 1];
+};
+
+extern template class BasicEuclideanVector<double>;
+extern template class BasicEuclideanVector<float>;
+
+/*
+  Text format
+
+  A vector is written as its magnitudes between square brackets, separated by single spaces:
+  [1.5 2 -0.25]. Each magnitude uses the shortest representation that reads back to exactly
+  the same value (std::to_chars), independent of the locale and of the stream's formatting
+  flags, so ToString and FromChars round-trip every vector.
+*/
+
+// Longest text one magnitude can need, e.g. -2.2250738585072014e-308
+constexpr int kMaxFormattedMagnitudeLength = 24;
+
+// Writes the text format into [first, last). Like std::to_chars, returns the end of the text,
+// or {last, std::errc::value_too_large} if it does not fit (2 + n * 25 characters always do).
+template <typename T>
+std::to_chars_result FormatTo(char* first, char* last, const BasicEuclideanVector<T>&) noexcept;
+template <typename T>
+std::string ToString(const BasicEuclideanVector<T>&);
+// Parses the text format from [first, last) into v, which keeps its allocator. Whitespace is
+// allowed around the magnitudes. Like std::from_chars, returns the end of the parsed text, or
+// a std::errc and the position of the problem, in which case v is left unchanged.
+template <typename T>
+std::from_chars_result FromChars(const char* first, const char* last, BasicEuclideanVector<T>& v);
+// Skips leading whitespace, then reads up to and including ']' and parses it with FromChars.
+// Sets failbit (leaving v unchanged) if that text is not a vector.
+template <typename T>
+std::istream& operator>>(std::istream&, BasicEuclideanVector<T>&);
+
+/*
+  Expression templates
+
+  u + v, u - v, u * d, d * u and u / d build small expression objects instead of vectors, so an
+  expression such as a + b - c * 2.0 is computed element by element in one loop, with a single
+  allocation for the result. Dimension mismatches and division by 0 are still reported when the
+  expression is built, before any element is computed. A single sum, difference, product or
+  quotient of contiguous magnitudes of the result's scalar type (u + v, u * d...) is computed
+  by one SIMD kernel instead of the loop.
 
-    std::vector<double> mags;
-    for (int i = 0; i < u.vectorLength_; i++)
-      mags.push_back(u.magnitudes_[i] / d);
+  EuclideanVector lvalues are held by reference and rvalues are moved into the expression, so
+  an expression never outlives the vectors it reads from. A vector constructed from a temporary
+  expression that owns such an rvalue (of the same scalar type and memory resource) is computed
+  in the rvalue's magnitudes and takes them over, so (std::move(u) + v) * 2.0 and f() - v
+  allocate nothing. Other operands must not read those magnitudes through a view.
+*/
 
-    return EuclideanVector(mags.begin(), mags.end());
+namespace ev_detail {
+
+template <typename T>
+struct IsExpression
+  : std::is_base_of<EuclideanVectorExpression<std::decay_t<T>>, std::decay_t<T>> {};
+
+template <typename T>
+using EnableIfExpression = std::enable_if_t<IsExpression<T>::value, int>;
+
+// How an operand of type T (as forwarded to an operator) is stored inside an expression
+template <typename T>
+using Operand = std::conditional_t<std::is_lvalue_reference<T>::value &&
+                                       IsBasicEuclideanVector<std::decay_t<T>>::value,
+                                   const std::decay_t<T>&,
+                                   std::decay_t<T>>;
+
+// operand if it is a BasicEuclideanVector<T> owned by the expression, or the vector such an
+// operand owns, otherwise nullptr
+template <typename T, typename E>
+BasicEuclideanVector<T>* ExpiringOperand(E& operand) noexcept {
+  if constexpr (std::is_same<E, BasicEuclideanVector<T>>::value)
+    return &operand;
+  else if constexpr (HasExpiringVector<T, E>::value)
+    return operand.template ExpiringVector<T>();
+  else
+    return nullptr;
+}
+
+struct Plus {
+  static double Apply(double a, double b) noexcept { return a + b; }
+};
+
+struct Minus {
+  static double Apply(double a, double b) noexcept { return a - b; }
+};
+
+struct Multiplies {
+  static double Apply(double a, double b) noexcept { return a * b; }
+};
+
+struct Divides {
+  static double Apply(double a, double b) noexcept { return a / b; }
+};
+
+// out[i] = Op::Apply(u[i], v[i]) and out[i] = Op::Apply(u[i], d), computed by the SIMD kernels
+// with exactly the same IEEE operation on every element. out may be u or v.
+void ContiguousApply(Plus, double* out, const double* u, const double* v, int length) noexcept;
+void ContiguousApply(Minus, double* out, const double* u, const double* v, int length) noexcept;
+void ContiguousApply(Multiplies, double* out, const double* u, double d, int length) noexcept;
+void ContiguousApply(Divides, double* out, const double* u, double d, int length) noexcept;
+void ContiguousApply(Plus, float* out, const float* u, const float* v, int length) noexcept;
+void ContiguousApply(Minus, float* out, const float* u, const float* v, int length) noexcept;
+void ContiguousApply(Multiplies, float* out, const float* u, float d, int length) noexcept;
+void ContiguousApply(Divides, float* out, const float* u, float d, int length) noexcept;
+
+// Selects the constructors that leave the checks to assert() (see euclidean_vector_unchecked.h)
+struct UncheckedTag {};
+
+template <typename L, typename R, typename Op>
+class BinaryExpression : public EuclideanVectorExpression<BinaryExpression<L, R, Op>> {
+ public:
+  template <typename LArg, typename RArg>
+  BinaryExpression(LArg&& lhs, RArg&& rhs)
+    : lhs_(std::forward<LArg>(lhs)), rhs_(std::forward<RArg>(rhs)) {
+    CheckDimensions(lhs_.GetNumDimensions(), rhs_.GetNumDimensions());
+  }
+  template <typename LArg, typename RArg>
+  BinaryExpression(UncheckedTag, LArg&& lhs, RArg&& rhs) noexcept(
+      std::is_nothrow_constructible<L, LArg&&>::value &&
+      std::is_nothrow_constructible<R, RArg&&>::value)
+    : lhs_(std::forward<LArg>(lhs)), rhs_(std::forward<RArg>(rhs)) {
+    assert(lhs_.GetNumDimensions() == rhs_.GetNumDimensions());
   }
 
-  friend std::ostream& operator<<(std::ostream& os, const EuclideanVector& v) noexcept {
-    os << "[";
-    if (!(v.vectorLength_ == 0)) {
-      for (auto i = 0; i < v.vectorLength_ - 1; i++)
-        os << v.magnitudes_[i] << " ";
-      os << v.magnitudes_[v.vectorLength_ - 1];
+  int GetNumDimensions() const noexcept { return lhs_.GetNumDimensions(); }
+  std::pmr::polymorphic_allocator<double> get_allocator() const noexcept {
+    return lhs_.get_allocator();
+  }
+  double operator[](const int index) const noexcept {
+    return Op::Apply(lhs_[index], rhs_[index]);
+  }
+  // The first vector of scalar type T that this expression owns, or nullptr
+  template <typename T>
+  BasicEuclideanVector<T>* ExpiringVector() noexcept {
+    if (auto* v = ExpiringOperand<T>(lhs_))
+      return v;
+    return ExpiringOperand<T>(rhs_);
+  }
+  bool ReadsShifted(const double* first, int length) const noexcept {
+    return ev_detail::ReadsShifted(lhs_, first, length) ||
+           ev_detail::ReadsShifted(rhs_, first, length);
+  }
+  // Writes u + v or u - v of two contiguous arrays of T into out with one SIMD kernel. Returns
+  // false, writing nothing, when the expression must be evaluated element by element.
+  template <typename T>
+  bool EvaluateWithKernel(T* out) const noexcept {
+    // The sum or difference of two floats rounds to the same float directly or through double
+    if constexpr (HasContiguousData<L, T>::value && HasContiguousData<R, T>::value &&
+                  (std::is_same<Op, Plus>::value || std::is_same<Op, Minus>::value)) {
+      ContiguousApply(Op{}, out, lhs_.data(), rhs_.data(), GetNumDimensions());
+      return true;
     }
-    os << "]";
-    return os;
+    return false;
   }
 
-  // Operations
-  EuclideanVector& operator=(const EuclideanVector&) noexcept;
-  // Move Assignment will reduce the number of dimensions of the given vector to 0
-  EuclideanVector& operator=(EuclideanVector&&) noexcept;
-  double& operator[](const int) noexcept;
-  double operator[](const int) const noexcept;
-  EuclideanVector& operator+=(const EuclideanVector&);
-  EuclideanVector& operator-=(const EuclideanVector&);
-  EuclideanVector& operator*=(const double) noexcept;
-  EuclideanVector& operator/=(const double);
-  explicit operator std::vector<double>() const noexcept;
-  explicit operator std::list<double>() const noexcept;
+ private:
+  L lhs_;
+  R rhs_;
+};
 
-  // Methods
-  double& at(int);
-  double at(int) const;
-  int GetNumDimensions() const noexcept;
-  double GetEuclideanNorm() const;
-  EuclideanVector CreateUnitVector() const;
+template <typename E, typename Op>
+class ScalarExpression : public EuclideanVectorExpression<ScalarExpression<E, Op>> {
+ public:
+  template <typename EArg>
+  ScalarExpression(EArg&& e, double d) noexcept : e_(std::forward<EArg>(e)), d_{d} {}
 
-  // Destructor
-  ~EuclideanVector() = default;
+  int GetNumDimensions() const noexcept { return e_.GetNumDimensions(); }
+  std::pmr::polymorphic_allocator<double> get_allocator() const noexcept {
+    return e_.get_allocator();
+  }
+  double operator[](const int index) const noexcept { return Op::Apply(e_[index], d_); }
+  template <typename T>
+  BasicEuclideanVector<T>* ExpiringVector() noexcept {
+    return ExpiringOperand<T>(e_);
+  }
+  bool ReadsShifted(const double* first, int length) const noexcept {
+    return ev_detail::ReadsShifted(e_, first, length);
+  }
+  // As BinaryExpression::EvaluateWithKernel, for u * d and u / d
+  template <typename T>
+  bool EvaluateWithKernel(T* out) const noexcept {
+    if constexpr (HasContiguousData<E, T>::value) {
+      // A float kernel only rounds like the double arithmetic if d is itself a float
+      if (static_cast<T>(d_) != d_)
+        return false;
+      ContiguousApply(Op{}, out, e_.data(), static_cast<T>(d_), GetNumDimensions());
+      return true;
+    }
+    return false;
+  }
 
  private:
-  std::unique_ptr<double[]> magnitudes_;
-  int vectorLength_;
+  E e_;
+  double d_;
 };
 
+template <typename L, typename R, typename Op>
+using BinaryExpressionOf = BinaryExpression<Operand<L>, Operand<R>, Op>;
+
+template <typename E, typename Op>
+using ScalarExpressionOf = ScalarExpression<Operand<E>, Op>;
+
+}  // namespace ev_detail
+
+template <typename L, typename R, ev_detail::EnableIfExpression<L> = 0,
+          ev_detail::EnableIfExpression<R> = 0>
+ev_detail::BinaryExpressionOf<L, R, ev_detail::Plus> operator+(L&& u, R&& v) {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kPlus);
+  return {std::forward<L>(u), std::forward<R>(v)};
+}
+
+template <typename L, typename R, ev_detail::EnableIfExpression<L> = 0,
+          ev_detail::EnableIfExpression<R> = 0>
+ev_detail::BinaryExpressionOf<L, R, ev_detail::Minus> operator-(L&& u, R&& v) {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kMinus);
+  return {std::forward<L>(u), std::forward<R>(v)};
+}
+
+// Dot product
+template <typename L, typename R, ev_detail::EnableIfExpression<L> = 0,
+          ev_detail::EnableIfExpression<R> = 0>
+double operator*(const L& u, const R& v) {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kDot);
+  ev_detail::CheckDimensions(u.GetNumDimensions(), v.GetNumDimensions());
+
+  if constexpr (ev_detail::HasContiguousData<L>::value && ev_detail::HasContiguousData<R>::value)
+    return ev_detail::ContiguousDot(u.data(), v.data(), u.GetNumDimensions());
+
+  double dotProd = 0.0;
+  for (int i = 0; i < u.GetNumDimensions(); i++)
+    dotProd += u[i] * v[i];
+
+  return dotProd;
+}
+
+// Element-wise equality of any two expressions (for example a view and a EuclideanVector)
+template <typename L, typename R, ev_detail::EnableIfExpression<L> = 0,
+          ev_detail::EnableIfExpression<R> = 0>
+bool operator==(const L& u, const R& v) noexcept {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kEqual);
+  if (u.GetNumDimensions() != v.GetNumDimensions())
+    return false;
+  for (int i = 0; i < u.GetNumDimensions(); i++) {
+    if (u[i] != v[i])
+      return false;
+  }
+  return true;
+}
+
+template <typename L, typename R, ev_detail::EnableIfExpression<L> = 0,
+          ev_detail::EnableIfExpression<R> = 0>
+bool operator!=(const L& u, const R& v) noexcept {
+  return !(u == v);
+}
+
+template <typename E, ev_detail::EnableIfExpression<E> = 0>
+ev_detail::ScalarExpressionOf<E, ev_detail::Multiplies> operator*(E&& u, const double d) noexcept {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kMultiply);
+  return {std::forward<E>(u), d};
+}
+
+template <typename E, ev_detail::EnableIfExpression<E> = 0>
+ev_detail::ScalarExpressionOf<E, ev_detail::Multiplies> operator*(const double d, E&& u) noexcept {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kMultiply);
+  return {std::forward<E>(u), d};
+}
+
+template <typename E, ev_detail::EnableIfExpression<E> = 0>
+ev_detail::ScalarExpressionOf<E, ev_detail::Divides> operator/(E&& u, const double d) {
+  ev_instrumentation::Count(ev_instrumentation::Counter::kDivide);
+  if (d == 0)
+    ev_detail::Throw("Invalid vector division by 0");
+
+  return {std::forward<E>(u), d};
+}
+
+template <typename E>
+std::ostream& operator<<(std::ostream& os, const EuclideanVectorExpression<E>& e) noexcept {
+  // Same text format as FormatTo, one magnitude at a time
+  const E& expression = e.Derived();
+  char buffer[kMaxFormattedMagnitudeLength + 1];
+  os.put('[');
+  for (int i = 0; i < expression.GetNumDimensions(); i++) {
+    char* first = buffer;
+    if (i != 0)
+      *first++ = ' ';
+    auto result = std::to_chars(first, buffer + sizeof(buffer), expression[i]);
+    os.write(buffer, result.ptr - buffer);
+  }
+  os.put(']');
+  return os;
+}
+
 #endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_H_
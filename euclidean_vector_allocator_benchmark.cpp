@@ -0,0 +1,62 @@
+// Created By : Rahil Agrawal
+//
+// Compares EuclideanVector on the default heap against std::pmr arenas and pools, for the
+// "many short-lived vectors per request" pattern: build a batch of vectors, do some arithmetic
+// with them, then drop them all.
+
+#include <memory_resource>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+constexpr int kVectorsPerRequest = 1024;
+
+void RunRequest(benchmark::State& state, std::pmr::memory_resource* resource) {
+  const int dimensions = static_cast<int>(state.range(0));
+  std::pmr::vector<EuclideanVector> vectors{resource};
+  vectors.reserve(kVectorsPerRequest);
+  for (int i = 0; i < kVectorsPerRequest; i++)
+    vectors.emplace_back(dimensions, static_cast<double>(i));
+  auto acc = EuclideanVector(dimensions, resource);
+  for (const auto& v : vectors)
+    acc = acc + v * 0.5;
+  benchmark::DoNotOptimize(acc.GetEuclideanNorm());
+}
+
+void BM_DefaultHeap(benchmark::State& state) {
+  for (auto _ : state)
+    RunRequest(state, std::pmr::new_delete_resource());
+  state.SetItemsProcessed(state.iterations() * kVectorsPerRequest);
+}
+
+void BM_MonotonicArena(benchmark::State& state) {
+  // One arena per request, sized up front and released in one go at the end of the request
+  std::vector<char> buffer(kVectorsPerRequest * (sizeof(EuclideanVector) + 16 +
+                                                 state.range(0) * sizeof(double)) +
+                           (1 << 16));
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(),
+                                              std::pmr::null_memory_resource()};
+    RunRequest(state, &arena);
+  }
+  state.SetItemsProcessed(state.iterations() * kVectorsPerRequest);
+}
+
+void BM_UnsynchronizedPool(benchmark::State& state) {
+  std::pmr::unsynchronized_pool_resource pool;
+  for (auto _ : state)
+    RunRequest(state, &pool);
+  state.SetItemsProcessed(state.iterations() * kVectorsPerRequest);
+}
+
+// 3 dimensions stay inline and never allocate; the others show the allocator difference
+BENCHMARK(BM_DefaultHeap)->Arg(3)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_MonotonicArena)->Arg(3)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_UnsynchronizedPool)->Arg(3)->Arg(16)->Arg(64)->Arg(256);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,315 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/euclidean_vector_batch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_kernels.h"
+
+namespace {
+
+constexpr std::size_t kAlignment = 64;
+constexpr int kDoublesPerAlignment = kAlignment / sizeof(double);
+
+int PaddedLength(int length) {
+  return (length + kDoublesPerAlignment - 1) / kDoublesPerAlignment * kDoublesPerAlignment;
+}
+
+void ThrowInvalidIndex(int index, const char* object) {
+  std::ostringstream ss;
+  ss << "Index " << index << " is not valid for this " << object << " object";
+  ev_detail::Throw(ss.str());
+}
+
+// Same message as a EuclideanVector with a negative number of dimensions
+void CheckCount(int count, const char* what) {
+  if (count < 0) {
+    std::ostringstream ss;
+    ss << "Number of " << what << " " << count << " is not valid";
+    ev_detail::Throw(ss.str());
+  }
+}
+
+}  // namespace
+
+int EuclideanVectorBatch::maxChunkLength_ = std::numeric_limits<int>::max();
+
+// RowView
+
+double EuclideanVectorBatch::RowView::at(int index) const {
+  if (index < 0 || index >= vectorLength_)
+    ThrowInvalidIndex(index, "EuclideanVector");
+
+  return magnitudes_[index * stride_];
+}
+
+double EuclideanVectorBatch::RowView::GetEuclideanNorm() const {
+  if (vectorLength_ == 0)
+    ev_detail::Throw("EuclideanVector with no dimensions does not have a norm");
+
+  if (stride_ == 1)
+    return std::sqrt(ev_kernels::SumOfSquares(magnitudes_, vectorLength_));
+
+  double norm = 0.0;
+  for (int i = 0; i < vectorLength_; i++)
+    norm += magnitudes_[i * stride_] * magnitudes_[i * stride_];
+  return std::sqrt(norm);
+}
+
+// Constructors
+
+EuclideanVectorBatch::EuclideanVectorBatch(int numVectors, int numDimensions, Layout layout)
+  : numVectors_{numVectors}, numDimensions_{numDimensions}, layout_{layout} {
+  CheckCount(numVectors_, "vectors");
+  CheckCount(numDimensions_, "dimensions");
+  stride_ = PaddedLength(layout_ == Layout::kRowMajor ? numDimensions_ : numVectors_);
+  data_.reset(static_cast<double*>(
+      ::operator new[](Size() * sizeof(double), std::align_val_t{kAlignment})));
+  std::fill(data_.get(), data_.get() + Size(), 0.0);
+}
+
+EuclideanVectorBatch::EuclideanVectorBatch(const std::vector<EuclideanVector>& vectors,
+                                           Layout layout)
+  : EuclideanVectorBatch(static_cast<int>(vectors.size()),
+                         vectors.empty() ? 0 : vectors.front().GetNumDimensions(),
+                         layout) {
+  for (int r = 0; r < numVectors_; r++)
+    SetRow(r, vectors[r]);
+}
+
+EuclideanVectorBatch::EuclideanVectorBatch(const EuclideanVectorBatch& b)
+  : EuclideanVectorBatch(b.numVectors_, b.numDimensions_, b.layout_) {
+  std::copy(b.data_.get(), b.data_.get() + Size(), data_.get());
+}
+
+EuclideanVectorBatch::EuclideanVectorBatch(EuclideanVectorBatch&& b) noexcept
+  : data_{std::move(b.data_)}, numVectors_{b.numVectors_}, numDimensions_{b.numDimensions_},
+    stride_{b.stride_}, layout_{b.layout_} {
+  b.numVectors_ = 0;
+  b.numDimensions_ = 0;
+  b.stride_ = 0;
+}
+
+// Operations
+
+EuclideanVectorBatch& EuclideanVectorBatch::operator=(const EuclideanVectorBatch& b) {
+  if (this != &b)
+    *this = EuclideanVectorBatch(b);
+  return *this;
+}
+
+EuclideanVectorBatch& EuclideanVectorBatch::operator=(EuclideanVectorBatch&& b) noexcept {
+  if (this == &b)
+    return *this;
+  data_ = std::move(b.data_);
+  numVectors_ = b.numVectors_;
+  numDimensions_ = b.numDimensions_;
+  stride_ = b.stride_;
+  layout_ = b.layout_;
+  b.numVectors_ = 0;
+  b.numDimensions_ = 0;
+  b.stride_ = 0;
+  return *this;
+}
+
+EuclideanVectorBatch& EuclideanVectorBatch::operator+=(const EuclideanVectorBatch& b) {
+  CheckShape(b);
+
+  if (layout_ == b.layout_) {
+    // Padding is 0.0 in both batches, so the whole block can be processed at once
+    ev_detail::ForEachChunk(
+        Size(),
+        [&](std::size_t offset, int length) {
+          ev_kernels::Add(data_.get() + offset, b.data_.get() + offset, length);
+        },
+        maxChunkLength_);
+  } else {
+    for (int r = 0; r < numVectors_; r++)
+      for (int d = 0; d < numDimensions_; d++)
+        (*this)(r, d) += b(r, d);
+  }
+
+  return *this;
+}
+
+EuclideanVectorBatch& EuclideanVectorBatch::operator-=(const EuclideanVectorBatch& b) {
+  CheckShape(b);
+
+  if (layout_ == b.layout_) {
+    ev_detail::ForEachChunk(
+        Size(),
+        [&](std::size_t offset, int length) {
+          ev_kernels::Subtract(data_.get() + offset, b.data_.get() + offset, length);
+        },
+        maxChunkLength_);
+  } else {
+    for (int r = 0; r < numVectors_; r++)
+      for (int d = 0; d < numDimensions_; d++)
+        (*this)(r, d) -= b(r, d);
+  }
+
+  return *this;
+}
+
+EuclideanVectorBatch& EuclideanVectorBatch::operator*=(double d) noexcept {
+  ev_detail::ForEachChunk(
+      Size(),
+      [&](std::size_t offset, int length) { ev_kernels::Scale(data_.get() + offset, d, length); },
+      maxChunkLength_);
+
+  return *this;
+}
+
+EuclideanVectorBatch& EuclideanVectorBatch::operator/=(double d) {
+  if (d == 0)
+    ev_detail::Throw("Invalid vector division by 0");
+
+  ev_detail::ForEachChunk(
+      Size(),
+      [&](std::size_t offset, int length) { ev_kernels::Divide(data_.get() + offset, d, length); },
+      maxChunkLength_);
+
+  return *this;
+}
+
+// Methods
+
+double& EuclideanVectorBatch::at(int row, int dimension) {
+  CheckRow(row);
+  if (dimension < 0 || dimension >= numDimensions_)
+    ThrowInvalidIndex(dimension, "EuclideanVector");
+
+  return data_[Offset(row, dimension)];
+}
+
+double EuclideanVectorBatch::at(int row, int dimension) const {
+  CheckRow(row);
+  if (dimension < 0 || dimension >= numDimensions_)
+    ThrowInvalidIndex(dimension, "EuclideanVector");
+
+  return data_[Offset(row, dimension)];
+}
+
+EuclideanVectorBatch::RowView EuclideanVectorBatch::Row(int row) const {
+  CheckRow(row);
+
+  if (layout_ == Layout::kRowMajor)
+    return RowView(data_.get() + Offset(row, 0), numDimensions_, 1);
+  return RowView(data_.get() + Offset(row, 0), numDimensions_, stride_);
+}
+
+void EuclideanVectorBatch::SetRow(int row, const EuclideanVector& v) {
+  CheckRow(row);
+  ev_detail::CheckDimensions(numDimensions_, v.GetNumDimensions());
+
+  for (int d = 0; d < numDimensions_; d++)
+    data_[Offset(row, d)] = v[d];
+}
+
+std::vector<double> EuclideanVectorBatch::GetEuclideanNorms() const {
+  if (numDimensions_ == 0 && numVectors_ > 0)
+    ev_detail::Throw("EuclideanVector with no dimensions does not have a norm");
+
+  std::vector<double> norms(numVectors_, 0.0);
+  if (layout_ == Layout::kRowMajor) {
+    for (int r = 0; r < numVectors_; r++)
+      norms[r] = ev_kernels::SumOfSquares(data_.get() + Offset(r, 0), numDimensions_);
+  } else {
+    // Accumulate one dimension of every vector at a time; this loop vectorises across vectors
+    double* squares = norms.data();
+    for (int d = 0; d < numDimensions_; d++) {
+      const double* column = data_.get() + Offset(0, d);
+      for (int r = 0; r < numVectors_; r++)
+        squares[r] += column[r] * column[r];
+    }
+  }
+  for (auto& norm : norms)
+    norm = std::sqrt(norm);
+
+  return norms;
+}
+
+EuclideanVectorBatch& EuclideanVectorBatch::Normalize() {
+  if (numDimensions_ == 0 && numVectors_ > 0)
+    ev_detail::Throw("EuclideanVector with no dimensions does not have a unit vector");
+  auto norms = GetEuclideanNorms();
+  if (std::find(norms.begin(), norms.end(), 0.0) != norms.end())
+    ev_detail::Throw("EuclideanVector with euclidean normal of 0 does not have a unit vector");
+
+  if (layout_ == Layout::kRowMajor) {
+    for (int r = 0; r < numVectors_; r++)
+      ev_kernels::Divide(data_.get() + Offset(r, 0), norms[r], numDimensions_);
+  } else {
+    for (int d = 0; d < numDimensions_; d++) {
+      double* column = data_.get() + Offset(0, d);
+      for (int r = 0; r < numVectors_; r++)
+        column[r] /= norms[r];
+    }
+  }
+
+  return *this;
+}
+
+std::vector<double> EuclideanVectorBatch::Dot(const EuclideanVector& query) const {
+  ev_detail::CheckDimensions(numDimensions_, query.GetNumDimensions());
+
+  std::vector<double> dots(numVectors_, 0.0);
+  if (layout_ == Layout::kRowMajor) {
+    for (int r = 0; r < numVectors_; r++)
+      dots[r] = ev_kernels::Dot(data_.get() + Offset(r, 0), query.data(), numDimensions_);
+  } else {
+    // dots += query[d] * (magnitude d of every vector)
+    for (int d = 0; d < numDimensions_; d++)
+      ev_kernels::Axpy(dots.data(), query[d], data_.get() + Offset(0, d), numVectors_);
+  }
+
+  return dots;
+}
+
+EuclideanVectorBatch EuclideanVectorBatch::ToLayout(Layout layout) const {
+  auto b = EuclideanVectorBatch(numVectors_, numDimensions_, layout);
+  for (int r = 0; r < numVectors_; r++)
+    for (int d = 0; d < numDimensions_; d++)
+      b(r, d) = (*this)(r, d);
+  return b;
+}
+
+void EuclideanVectorBatch::SetMaxChunkLength(int length) noexcept {
+  assert(length > 0);
+
+  maxChunkLength_ = length;
+}
+
+// Helpers
+
+void EuclideanVectorBatch::AlignedDelete::operator()(double* p) const noexcept {
+  ::operator delete[](p, std::align_val_t{kAlignment});
+}
+
+std::size_t EuclideanVectorBatch::Size() const noexcept {
+  return static_cast<std::size_t>(stride_) *
+         (layout_ == Layout::kRowMajor ? numVectors_ : numDimensions_);
+}
+
+void EuclideanVectorBatch::CheckRow(int row) const {
+  if (row < 0 || row >= numVectors_)
+    ThrowInvalidIndex(row, "EuclideanVectorBatch");
+}
+
+void EuclideanVectorBatch::CheckShape(const EuclideanVectorBatch& b) const {
+  if (numVectors_ != b.numVectors_) {
+    std::ostringstream ss;
+    ss << "Number of vectors of LHS(" << numVectors_ << ") and RHS(" << b.numVectors_
+       << ") do not match";
+    ev_detail::Throw(ss.str());
+  }
+  ev_detail::CheckDimensions(numDimensions_, b.numDimensions_);
+}
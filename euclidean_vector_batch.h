@@ -0,0 +1,162 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_BATCH_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_BATCH_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+
+/*
+  EuclideanVectorBatch stores N vectors with the same number of dimensions in one 64-byte
+  aligned block, instead of one heap allocation per EuclideanVector.
+
+  Layouts
+    kRowMajor          : the magnitudes of each vector are contiguous. Every row starts on a
+                         64-byte boundary (rows are padded with zeros).
+    kStructureOfArrays : magnitude d of every vector is contiguous, so batched kernels run
+                         across vectors rather than along them. Best for low dimensional vectors.
+
+  Row(i) returns a cheap read-only view that can be used anywhere a EuclideanVector expression
+  can (arithmetic, dot products, constructing a EuclideanVector, printing).
+*/
+namespace ev_detail {
+
+// Calls f(offset, length) for consecutive chunks of [0, size) of at most maxLength elements,
+// as the kernels take an int length and a batch can hold more than INT_MAX magnitudes
+template <typename F>
+void ForEachChunk(std::size_t size, F f, int maxLength = std::numeric_limits<int>::max()) {
+  for (std::size_t offset = 0; offset < size; offset += maxLength)
+    f(offset, static_cast<int>(std::min<std::size_t>(maxLength, size - offset)));
+}
+
+}  // namespace ev_detail
+
+class EuclideanVectorBatch {
+ public:
+  enum class Layout { kRowMajor, kStructureOfArrays };
+
+  // Read-only view of one vector of the batch
+  class RowView : public EuclideanVectorExpression<RowView> {
+   public:
+    RowView(const double* magnitudes, int length, int stride) noexcept
+      : magnitudes_{magnitudes}, vectorLength_{length}, stride_{stride} {}
+
+    double operator[](const int index) const noexcept {
+      assert(index >= 0 && index < vectorLength_);
+
+      return magnitudes_[index * stride_];
+    }
+    double at(int) const;
+    int GetNumDimensions() const noexcept { return vectorLength_; }
+    double GetEuclideanNorm() const;
+    std::pmr::polymorphic_allocator<double> get_allocator() const noexcept { return {}; }
+    // Whether this row reads [first, first + length) other than element i for element i
+    bool ReadsShifted(const double* first, int length) const noexcept {
+      if (vectorLength_ == 0 || (stride_ == 1 && magnitudes_ == first))
+        return false;
+      const double* last = magnitudes_ + static_cast<std::ptrdiff_t>(vectorLength_ - 1) * stride_;
+      const std::less<const double*> before;
+      return before(magnitudes_, first + length) && !before(last, first);
+    }
+
+   private:
+    const double* magnitudes_;
+    int vectorLength_;
+    int stride_;
+  };
+
+  // Constructors
+  // numVectors vectors with numDimensions dimensions, all magnitudes 0.0. Throws if either is
+  // negative.
+  EuclideanVectorBatch(int numVectors, int numDimensions, Layout = Layout::kRowMajor);
+  // Copies the given vectors, which must all have the same number of dimensions
+  explicit EuclideanVectorBatch(const std::vector<EuclideanVector>&, Layout = Layout::kRowMajor);
+  EuclideanVectorBatch(const EuclideanVectorBatch&);
+  // Move Constructor will leave the given batch with 0 vectors of 0 dimensions
+  EuclideanVectorBatch(EuclideanVectorBatch&&) noexcept;
+
+  // Operations
+  EuclideanVectorBatch& operator=(const EuclideanVectorBatch&);
+  // Move Assignment will leave the given batch with 0 vectors of 0 dimensions
+  EuclideanVectorBatch& operator=(EuclideanVectorBatch&&) noexcept;
+  // Unchecked access to magnitude `dimension` of vector `row`
+  double& operator()(int row, int dimension) noexcept {
+    assert(row >= 0 && row < numVectors_ && dimension >= 0 && dimension < numDimensions_);
+
+    return data_[Offset(row, dimension)];
+  }
+  double operator()(int row, int dimension) const noexcept {
+    assert(row >= 0 && row < numVectors_ && dimension >= 0 && dimension < numDimensions_);
+
+    return data_[Offset(row, dimension)];
+  }
+  // Element-wise, over every vector of the batch
+  EuclideanVectorBatch& operator+=(const EuclideanVectorBatch&);
+  EuclideanVectorBatch& operator-=(const EuclideanVectorBatch&);
+  EuclideanVectorBatch& operator*=(double) noexcept;
+  EuclideanVectorBatch& operator/=(double);
+
+  // Methods
+  double& at(int row, int dimension);
+  double at(int row, int dimension) const;
+  RowView Row(int) const;
+  void SetRow(int, const EuclideanVector&);
+  int GetNumVectors() const noexcept { return numVectors_; }
+  int GetNumDimensions() const noexcept { return numDimensions_; }
+  Layout GetLayout() const noexcept { return layout_; }
+  // Euclidean norm of every vector
+  std::vector<double> GetEuclideanNorms() const;
+  // Replaces every vector by its unit vector. Nothing is changed if any vector has a norm of 0.
+  EuclideanVectorBatch& Normalize();
+  // Dot product of every vector with the query
+  std::vector<double> Dot(const EuclideanVector& query) const;
+  // Copy of the batch in the other layout
+  EuclideanVectorBatch ToLayout(Layout) const;
+  // Longest run of magnitudes that +=, -=, *= and /= pass to one kernel call: INT_MAX by
+  // default, as the kernels take an int length. Tests lower it to split small batches; it must
+  // not change while one of those operators runs.
+  static void SetMaxChunkLength(int) noexcept;
+  static int GetMaxChunkLength() noexcept { return maxChunkLength_; }
+
+  // Raw storage, for kernels that work on the whole batch. Row-major rows (or structure of
+  // arrays columns) are GetStride() doubles apart and start on 64-byte boundaries.
+  const double* data() const noexcept { return data_.get(); }
+  double* data() noexcept { return data_.get(); }
+  int GetStride() const noexcept { return stride_; }
+
+  // Destructor
+  ~EuclideanVectorBatch() = default;
+
+ private:
+  struct AlignedDelete {
+    void operator()(double* p) const noexcept;
+  };
+
+  std::size_t Offset(int row, int dimension) const noexcept {
+    return layout_ == Layout::kRowMajor
+               ? static_cast<std::size_t>(row) * stride_ + dimension
+               : static_cast<std::size_t>(dimension) * stride_ + row;
+  }
+  std::size_t Size() const noexcept;
+  void CheckRow(int) const;
+  void CheckShape(const EuclideanVectorBatch&) const;
+
+  static int maxChunkLength_;
+
+  std::unique_ptr<double[], AlignedDelete> data_;
+  int numVectors_;
+  int numDimensions_;
+  // Distance between consecutive rows (row-major) or columns (structure of arrays)
+  int stride_;
+  Layout layout_;
+};
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_BATCH_H_
@@ -0,0 +1,248 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Every batched operation is checked in both layouts against the result of the same operation
+  on individual EuclideanVectors, which are already covered by euclidean_vector_test.cpp.
+  The in-place operators process the whole block in chunks of at most INT_MAX magnitudes. A
+  batch that large does not fit in a test, so they are run with the chunk length lowered to 7.
+  Failure scenarios follow the EuclideanVector error messages.
+
+*/
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "catch.h"
+
+namespace {
+
+std::vector<EuclideanVector> SampleVectors() {
+  std::vector<EuclideanVector> vectors;
+  for (int r = 0; r < 11; r++) {
+    std::vector<double> mags;
+    for (int d = 0; d < 5; d++)
+      mags.push_back(r * 5 + d + 1.0);
+    vectors.emplace_back(mags.begin(), mags.end());
+  }
+  return vectors;
+}
+
+const EuclideanVectorBatch::Layout kLayouts[] = {EuclideanVectorBatch::Layout::kRowMajor,
+                                                 EuclideanVectorBatch::Layout::kStructureOfArrays};
+
+}  // namespace
+
+SCENARIO("Create a EuclideanVectorBatch from EuclideanVectors") {
+  for (auto layout : kLayouts) {
+    GIVEN("That there are 11 vectors with 5 dimensions, in layout " +
+          std::to_string(static_cast<int>(layout))) {
+      auto vectors = SampleVectors();
+      WHEN("A batch is created from them") {
+        auto batch = EuclideanVectorBatch(vectors, layout);
+        THEN("The batch has 11 vectors with 5 dimensions") {
+          REQUIRE(batch.GetNumVectors() == 11);
+          REQUIRE(batch.GetNumDimensions() == 5);
+          AND_THEN("Every row view compares equal to the original vector") {
+            for (int r = 0; r < 11; r++)
+              REQUIRE(EuclideanVector(batch.Row(r)) == vectors[r]);
+          }
+        }
+        THEN("Rows are 64-byte aligned in the row-major layout") {
+          if (layout == EuclideanVectorBatch::Layout::kRowMajor) {
+            for (int r = 0; r < 11; r++)
+              REQUIRE(reinterpret_cast<std::uintptr_t>(&batch(r, 0)) % 64 == 0);
+          }
+        }
+        AND_WHEN("The batch is moved") {
+          auto moved{std::move(batch)};
+          THEN("The old batch has 0 vectors") { REQUIRE(batch.GetNumVectors() == 0); }
+          THEN("The new batch has the rows") { REQUIRE(EuclideanVector(moved.Row(3)) == vectors[3]); }
+        }
+      }
+    }
+  }
+  GIVEN("That there is a negative number of vectors or of dimensions") {
+    WHEN("A batch is created with it") {
+      try {
+        auto batch = EuclideanVectorBatch(-1, 3);
+        std::cerr << batch.GetNumVectors() << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Number of vectors -1 is not valid") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Number of vectors -1 is not valid") == 0);
+        }
+      }
+      try {
+        auto batch = EuclideanVectorBatch(3, -1, EuclideanVectorBatch::Layout::kStructureOfArrays);
+        std::cerr << batch.GetNumVectors() << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Number of dimensions -1 is not valid") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Number of dimensions -1 is not valid") == 0);
+        }
+      }
+    }
+  }
+  GIVEN("That there are vectors with different numbers of dimensions") {
+    std::vector<EuclideanVector> vectors{EuclideanVector(3, 1.0), EuclideanVector(2, 1.0)};
+    WHEN("A batch is created from them") {
+      try {
+        auto batch = EuclideanVectorBatch(vectors);
+        std::cerr << batch.GetNumVectors() << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Dimensions of LHS(3) and RHS(2) do not match") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Dimensions of LHS(3) and RHS(2) do not match") == 0);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Use a row of a EuclideanVectorBatch as a EuclideanVector") {
+  for (auto layout : kLayouts) {
+    GIVEN("That there is a batch in layout " + std::to_string(static_cast<int>(layout))) {
+      auto vectors = SampleVectors();
+      auto batch = EuclideanVectorBatch(vectors, layout);
+      WHEN("A row view is read") {
+        auto row = batch.Row(2);
+        THEN("It behaves like the original vector") {
+          REQUIRE(row.GetNumDimensions() == 5);
+          REQUIRE(row[4] == vectors[2][4]);
+          REQUIRE(row.at(1) == vectors[2][1]);
+          REQUIRE(row.GetEuclideanNorm() == Approx(vectors[2].GetEuclideanNorm()));
+          REQUIRE(row * vectors[0] == Approx(vectors[2] * vectors[0]));
+          EuclideanVector sum = row + vectors[1];
+          REQUIRE(sum == vectors[2] + vectors[1]);
+        }
+      }
+      WHEN("An invalid row is requested") {
+        try {
+          auto row = batch.Row(11);
+          std::cerr << row << "is invalid. Control should not reach this line";
+        } catch (const EuclideanVectorError& e) {
+          THEN("Exception is thrown : Index 11 is not valid for this EuclideanVectorBatch object") {
+            std::string err = e.what();
+            REQUIRE(err.compare("Index 11 is not valid for this EuclideanVectorBatch object") == 0);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Run batched kernels over a EuclideanVectorBatch") {
+  for (auto layout : kLayouts) {
+    GIVEN("That there is a batch in layout " + std::to_string(static_cast<int>(layout))) {
+      auto vectors = SampleVectors();
+      auto batch = EuclideanVectorBatch(vectors, layout);
+      WHEN("The norms are obtained") {
+        auto norms = batch.GetEuclideanNorms();
+        THEN("They match the norm of every vector") {
+          for (int r = 0; r < 11; r++)
+            REQUIRE(norms[r] == Approx(vectors[r].GetEuclideanNorm()));
+        }
+      }
+      WHEN("The batch is normalised") {
+        batch.Normalize();
+        THEN("Every row is the unit vector of the original vector") {
+          for (int r = 0; r < 11; r++) {
+            auto unit = vectors[r].CreateUnitVector();
+            for (int d = 0; d < 5; d++)
+              REQUIRE(batch(r, d) == Approx(unit[d]));
+          }
+        }
+      }
+      WHEN("The dot product with a query is obtained") {
+        std::vector<double> q{1.0, -1.0, 0.5, 2.0, 0.0};
+        auto query = EuclideanVector(q.begin(), q.end());
+        auto dots = batch.Dot(query);
+        THEN("It matches the dot product of every vector with the query") {
+          for (int r = 0; r < 11; r++)
+            REQUIRE(dots[r] == Approx(vectors[r] * query));
+        }
+      }
+      WHEN("The batch is added to itself, scaled and divided") {
+        auto other = EuclideanVectorBatch(vectors, kLayouts[0]);
+        batch += other;
+        batch *= 3.0;
+        batch -= other;
+        batch /= 5.0;
+        THEN("Every vector is (2 * 3 - 1) / 5 = 1 times the original") {
+          for (int r = 0; r < 11; r++)
+            REQUIRE(EuclideanVector(batch.Row(r)) == vectors[r]);
+        }
+      }
+      WHEN("A batch with a different number of vectors is added") {
+        auto other = EuclideanVectorBatch(10, 5);
+        try {
+          batch += other;
+          std::cerr << batch.Row(0) << "is invalid. Control should not reach this line";
+        } catch (const EuclideanVectorError& e) {
+          THEN("Exception is thrown : Number of vectors of LHS(11) and RHS(10) do not match") {
+            std::string err = e.what();
+            REQUIRE(err.compare("Number of vectors of LHS(11) and RHS(10) do not match") == 0);
+          }
+        }
+      }
+      WHEN("One vector is zero and the batch is normalised") {
+        batch.SetRow(4, EuclideanVector(5));
+        try {
+          batch.Normalize();
+          std::cerr << batch.Row(0) << "is invalid. Control should not reach this line";
+        } catch (const EuclideanVectorError& e) {
+          THEN("Exception is thrown and no vector has been changed") {
+            std::string err = e.what();
+            REQUIRE(err.compare(
+                        "EuclideanVector with euclidean normal of 0 does not have a unit vector") ==
+                    0);
+            REQUIRE(EuclideanVector(batch.Row(0)) == vectors[0]);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Run the in-place operators of a batch in several chunks") {
+  // Restores the chunk length even if a REQUIRE throws
+  struct ChunkLength {
+    explicit ChunkLength(int length) : previous{EuclideanVectorBatch::GetMaxChunkLength()} {
+      EuclideanVectorBatch::SetMaxChunkLength(length);
+    }
+    ~ChunkLength() { EuclideanVectorBatch::SetMaxChunkLength(previous); }
+    int previous;
+  };
+  for (auto layout : kLayouts) {
+    GIVEN("That there are two batches in layout " + std::to_string(static_cast<int>(layout)) +
+          " and a chunk length of 7") {
+      auto vectors = SampleVectors();
+      auto batch = EuclideanVectorBatch(vectors, layout);
+      auto other = EuclideanVectorBatch(vectors, layout);
+      const ChunkLength chunkLength{7};
+      // Neither block is a multiple of 7 magnitudes long, so the last chunk is shorter
+      const int strides = layout == EuclideanVectorBatch::Layout::kRowMajor ? 11 : 5;
+      REQUIRE(batch.GetStride() * strides % 7 != 0);
+      WHEN("+=, -=, *= and /= are applied") {
+        other *= 3.0;
+        batch += other;
+        auto sum = batch;
+        batch -= EuclideanVectorBatch(vectors, layout);
+        batch /= 2.0;
+        THEN("Every magnitude, up to the last chunk, is the one of the individual vectors") {
+          for (int r = 0; r < 11; r++) {
+            REQUIRE(EuclideanVector(other.Row(r)) == vectors[r] * 3.0);
+            REQUIRE(EuclideanVector(sum.Row(r)) == vectors[r] + vectors[r] * 3.0);
+            REQUIRE(EuclideanVector(batch.Row(r)) == vectors[r] * 3.0 / 2.0);
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,514 @@
+// Created By : Rahil Agrawal
+//
+// Microbenchmarks for every EuclideanVector operation, over 2 to 2^24 dimensions.
+//
+// Every benchmark reports time per operation, bytes/s (magnitudes read plus magnitudes
+// written) and allocs/op (calls to the global operator new). On Linux, running with
+// EV_PERF_COUNTERS=1 in the environment also reports cycles, instructions, cache misses and
+// branch misses per operation through perf_event_open; the counters are skipped when the
+// kernel does not allow them (see /proc/sys/kernel/perf_event_paranoid). Built with
+// EUCLIDEAN_VECTOR_INSTRUMENTATION=1, they also report deep copies/op and moves/op.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <list>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_counters.h"
+#include "assignments/ev/euclidean_vector_unchecked.h"
+#include "benchmark/benchmark.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::atomic<std::int64_t> allocations{0};
+
+}  // namespace
+
+// Count every allocation made through the global operator new. The array and nothrow forms
+// call these two; std::pmr::new_delete_resource() (the default resource of EuclideanVector)
+// uses the aligned one. Kept out of line so the compiler does not pair the
+// inlined malloc/free with the new and delete expressions of the benchmarks.
+__attribute__((noinline)) void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+__attribute__((noinline)) void* operator new(std::size_t size, std::align_val_t alignment) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  const auto align = static_cast<std::size_t>(alignment);
+  // aligned_alloc needs a non-zero size that is a multiple of the alignment
+  const std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+  if (void* p = std::aligned_alloc(align, rounded))
+    return p;
+  throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+#ifdef __linux__
+// Hardware counters for the calling thread, opened as one group so that they are comparable
+class PerfCounters {
+ public:
+  static constexpr int kNumCounters = 4;
+
+  PerfCounters() {
+    const char* enabled = std::getenv("EV_PERF_COUNTERS");
+    if (enabled == nullptr || enabled[0] != '1')
+      return;
+    const std::uint64_t configs[kNumCounters] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < kNumCounters; i++) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[i];
+      attr.disabled = i == 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      const int group = i == 0 ? -1 : fds_[0];
+      fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+      if (fds_[i] < 0) {
+        Close();
+        return;
+      }
+    }
+  }
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+  ~PerfCounters() { Close(); }
+
+  bool IsOpen() const noexcept { return fds_[0] >= 0; }
+  void Start() {
+    ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+  // Stops counting and reads cycles, instructions, cache misses and branch misses
+  bool Stop(std::uint64_t (&values)[kNumCounters]) {
+    ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    std::uint64_t buffer[kNumCounters + 1];
+    if (read(fds_[0], buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)))
+      return false;
+    for (int i = 0; i < kNumCounters; i++)
+      values[i] = buffer[i + 1];
+    return true;
+  }
+
+ private:
+  void Close() noexcept {
+    for (auto& fd : fds_) {
+      if (fd >= 0)
+        close(fd);
+      fd = -1;
+    }
+  }
+
+  int fds_[kNumCounters] = {-1, -1, -1, -1};
+};
+#endif
+
+// Measures one benchmark: created before the timing loop, reports its counters when it goes
+// out of scope after the loop
+class OpCounters {
+ public:
+  // bytesPerOp is the number of bytes of magnitudes each operation reads and writes
+  OpCounters(benchmark::State& state, std::int64_t bytesPerOp)
+    : state_{state}, bytesPerOp_{bytesPerOp},
+      allocationsBefore_{allocations.load(std::memory_order_relaxed)},
+      countersBefore_{ev_instrumentation::GetCounters()} {
+#ifdef __linux__
+    if (perf_.IsOpen())
+      perf_.Start();
+#endif
+  }
+  OpCounters(const OpCounters&) = delete;
+  OpCounters& operator=(const OpCounters&) = delete;
+  ~OpCounters() {
+    const auto iterations = state_.iterations();
+    state_.counters["allocs/op"] = benchmark::Counter(
+        static_cast<double>(allocations.load(std::memory_order_relaxed) - allocationsBefore_),
+        benchmark::Counter::kAvgIterations);
+    if (bytesPerOp_ > 0)
+      state_.SetBytesProcessed(iterations * bytesPerOp_);
+    if (ev_instrumentation::kEnabled) {
+      const auto counters = ev_instrumentation::GetCounters() - countersBefore_;
+      state_.counters["copies/op"] = benchmark::Counter(
+          static_cast<double>(counters[ev_instrumentation::Counter::kDeepCopies]),
+          benchmark::Counter::kAvgIterations);
+      state_.counters["moves/op"] = benchmark::Counter(
+          static_cast<double>(counters[ev_instrumentation::Counter::kMoves]),
+          benchmark::Counter::kAvgIterations);
+    }
+#ifdef __linux__
+    std::uint64_t values[PerfCounters::kNumCounters];
+    if (perf_.IsOpen() && perf_.Stop(values)) {
+      const char* names[PerfCounters::kNumCounters] = {"cycles/op", "instructions/op",
+                                                       "cache-misses/op", "branch-misses/op"};
+      for (int i = 0; i < PerfCounters::kNumCounters; i++)
+        state_.counters[names[i]] = benchmark::Counter(static_cast<double>(values[i]),
+                                                       benchmark::Counter::kAvgIterations);
+    }
+#endif
+  }
+
+ private:
+  benchmark::State& state_;
+  std::int64_t bytesPerOp_;
+  std::int64_t allocationsBefore_;
+  ev_instrumentation::Counters countersBefore_;
+#ifdef __linux__
+  PerfCounters perf_;
+#endif
+};
+
+EuclideanVector MakeVector(int dimensions, double first) {
+  auto v = EuclideanVector(dimensions);
+  for (int i = 0; i < dimensions; i++)
+    v[i] = first + i * 1e-6;
+  return v;
+}
+
+std::int64_t Bytes(benchmark::State& state, int vectorsTouched) {
+  return state.range(0) * static_cast<std::int64_t>(sizeof(double)) * vectorsTouched;
+}
+
+// Construction, copy and move
+
+void BM_ConstructFilled(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  OpCounters counters{state, Bytes(state, 1)};
+  for (auto _ : state) {
+    auto v = EuclideanVector(n, 1.0);
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+
+void BM_ConstructFromIterators(benchmark::State& state) {
+  const auto mags = std::vector<double>(state.range(0), 1.0);
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state) {
+    auto v = EuclideanVector(mags.begin(), mags.end());
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+
+void BM_CopyConstruct(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state) {
+    auto v = u;
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+
+void BM_CopyAssign(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  auto v = MakeVector(static_cast<int>(state.range(0)), 2.0);
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state) {
+    v = u;
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+
+void BM_MoveConstructAndAssign(benchmark::State& state) {
+  auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, 0};
+  for (auto _ : state) {
+    auto v = std::move(u);
+    u = std::move(v);
+    benchmark::DoNotOptimize(u.data());
+  }
+}
+
+// Arithmetic operators, evaluated into a new vector
+
+void BM_Add(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  const auto v = MakeVector(static_cast<int>(state.range(0)), 2.0);
+  OpCounters counters{state, Bytes(state, 3)};
+  for (auto _ : state) {
+    EuclideanVector w = u + v;
+    benchmark::DoNotOptimize(w.data());
+  }
+}
+
+void BM_Subtract(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  const auto v = MakeVector(static_cast<int>(state.range(0)), 2.0);
+  OpCounters counters{state, Bytes(state, 3)};
+  for (auto _ : state) {
+    EuclideanVector w = u - v;
+    benchmark::DoNotOptimize(w.data());
+  }
+}
+
+void BM_MultiplyScalar(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state) {
+    EuclideanVector w = u * 1.5;
+    benchmark::DoNotOptimize(w.data());
+  }
+}
+
+void BM_DivideScalar(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state) {
+    EuclideanVector w = u / 1.5;
+    benchmark::DoNotOptimize(w.data());
+  }
+}
+
+// Each temporary is evaluated in the storage of the one before it: one allocation per iteration
+void BM_ChainedExpiring(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  const auto v = MakeVector(static_cast<int>(state.range(0)), 2.0);
+  OpCounters counters{state, Bytes(state, 9)};
+  for (auto _ : state) {
+    EuclideanVector w = (u + v) * 0.5;
+    EuclideanVector x = std::move(w) - v;
+    auto unit = std::move(x).CreateUnitVector();
+    benchmark::DoNotOptimize(unit.data());
+  }
+}
+
+void BM_Dot(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  const auto v = MakeVector(static_cast<int>(state.range(0)), 2.0);
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(u * v);
+}
+
+void BM_DotUnchecked(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  const auto v = MakeVector(static_cast<int>(state.range(0)), 2.0);
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(ev_unchecked::Dot(u, v));
+}
+
+// The second argument is the Accuracy
+void BM_DotAccuracy(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  const auto v = MakeVector(static_cast<int>(state.range(0)), 2.0);
+  const auto accuracy = static_cast<Accuracy>(state.range(1));
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Dot(u, v, accuracy));
+}
+
+void BM_Equal(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  const auto v = u;
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(u == v);
+}
+
+// Compound assignment. Adding 0 and scaling by 1 keep the magnitudes stable over millions of
+// iterations without changing the work done.
+
+void BM_AddAssign(benchmark::State& state) {
+  auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  const auto v = EuclideanVector(static_cast<int>(state.range(0)), 0.0);
+  OpCounters counters{state, Bytes(state, 3)};
+  for (auto _ : state) {
+    u += v;
+    benchmark::DoNotOptimize(u.data());
+  }
+}
+
+void BM_AddAssignUnchecked(benchmark::State& state) {
+  auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  const auto v = EuclideanVector(static_cast<int>(state.range(0)), 0.0);
+  OpCounters counters{state, Bytes(state, 3)};
+  for (auto _ : state) {
+    ev_unchecked::AddAssign(u, v);
+    benchmark::DoNotOptimize(u.data());
+  }
+}
+
+void BM_SubtractAssign(benchmark::State& state) {
+  auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  const auto v = EuclideanVector(static_cast<int>(state.range(0)), 0.0);
+  OpCounters counters{state, Bytes(state, 3)};
+  for (auto _ : state) {
+    u -= v;
+    benchmark::DoNotOptimize(u.data());
+  }
+}
+
+void BM_MultiplyAssign(benchmark::State& state) {
+  auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state) {
+    u *= 1.0;
+    benchmark::DoNotOptimize(u.data());
+  }
+}
+
+void BM_DivideAssign(benchmark::State& state) {
+  auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state) {
+    u /= 1.0;
+    benchmark::DoNotOptimize(u.data());
+  }
+}
+
+// Element access
+
+void BM_Subscript(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, Bytes(state, 1)};
+  for (auto _ : state) {
+    double sum = 0.0;
+    for (int i = 0; i < u.GetNumDimensions(); i++)
+      sum += u[i];
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+void BM_At(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, Bytes(state, 1)};
+  for (auto _ : state) {
+    double sum = 0.0;
+    for (int i = 0; i < u.GetNumDimensions(); i++)
+      sum += u.at(i);
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+// Methods and conversions
+
+void BM_GetEuclideanNorm(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, Bytes(state, 1)};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(u.GetEuclideanNorm());
+}
+
+// The second argument is the Accuracy. kScaled reads the magnitudes twice.
+void BM_GetEuclideanNormAccuracy(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  const auto accuracy = static_cast<Accuracy>(state.range(1));
+  OpCounters counters{state, Bytes(state, 1)};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(u.GetEuclideanNorm(accuracy));
+}
+
+// A vector that caches its norm only reads its magnitudes on the first call
+void BM_GetEuclideanNormCached(benchmark::State& state) {
+  auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  u.SetNormCaching(true);
+  OpCounters counters{state, 0};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(u.GetEuclideanNorm());
+}
+
+void BM_CreateUnitVector(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, Bytes(state, 3)};
+  for (auto _ : state) {
+    auto unit = u.CreateUnitVector();
+    benchmark::DoNotOptimize(unit.data());
+  }
+}
+
+void BM_ToStdVector(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state) {
+    auto mags = static_cast<std::vector<double>>(u);
+    benchmark::DoNotOptimize(mags.data());
+  }
+}
+
+void BM_ToStdList(benchmark::State& state) {
+  const auto u = MakeVector(static_cast<int>(state.range(0)), 1.0);
+  OpCounters counters{state, Bytes(state, 2)};
+  for (auto _ : state) {
+    auto mags = static_cast<std::list<double>>(u);
+    benchmark::DoNotOptimize(&mags.back());
+  }
+}
+
+// 2, 4, 16, 64, ... 2^22, 2^24 dimensions: from inline storage to far beyond the last level cache
+void Dimensions(benchmark::internal::Benchmark* b) {
+  b->RangeMultiplier(4)->Range(2, 1 << 24);
+}
+
+// Every Accuracy over 16, 1024, 2^16 (in L2) and 2^22 (in memory) dimensions
+void AccuracyDimensions(benchmark::internal::Benchmark* b) {
+  for (int accuracy = 0; accuracy <= static_cast<int>(Accuracy::kScaled); accuracy++) {
+    for (int dimensions : {16, 1 << 10, 1 << 16, 1 << 22})
+      b->Args({dimensions, accuracy});
+  }
+}
+
+BENCHMARK(BM_ConstructFilled)->Apply(Dimensions);
+BENCHMARK(BM_ConstructFromIterators)->Apply(Dimensions);
+BENCHMARK(BM_CopyConstruct)->Apply(Dimensions);
+BENCHMARK(BM_CopyAssign)->Apply(Dimensions);
+BENCHMARK(BM_MoveConstructAndAssign)->Apply(Dimensions);
+BENCHMARK(BM_Add)->Apply(Dimensions);
+BENCHMARK(BM_Subtract)->Apply(Dimensions);
+BENCHMARK(BM_MultiplyScalar)->Apply(Dimensions);
+BENCHMARK(BM_DivideScalar)->Apply(Dimensions);
+BENCHMARK(BM_ChainedExpiring)->Apply(Dimensions);
+BENCHMARK(BM_Dot)->Apply(Dimensions);
+BENCHMARK(BM_DotUnchecked)->Apply(Dimensions);
+BENCHMARK(BM_DotAccuracy)->Apply(AccuracyDimensions);
+BENCHMARK(BM_Equal)->Apply(Dimensions);
+BENCHMARK(BM_AddAssign)->Apply(Dimensions);
+BENCHMARK(BM_AddAssignUnchecked)->Apply(Dimensions);
+BENCHMARK(BM_SubtractAssign)->Apply(Dimensions);
+BENCHMARK(BM_MultiplyAssign)->Apply(Dimensions);
+BENCHMARK(BM_DivideAssign)->Apply(Dimensions);
+BENCHMARK(BM_Subscript)->Apply(Dimensions);
+BENCHMARK(BM_At)->Apply(Dimensions);
+BENCHMARK(BM_GetEuclideanNorm)->Apply(Dimensions);
+BENCHMARK(BM_GetEuclideanNormAccuracy)->Apply(AccuracyDimensions);
+BENCHMARK(BM_GetEuclideanNormCached)->Apply(Dimensions);
+BENCHMARK(BM_CreateUnitVector)->Apply(Dimensions);
+BENCHMARK(BM_ToStdVector)->Apply(Dimensions);
+BENCHMARK(BM_ToStdList)->Apply(Dimensions);
+
+}  // namespace
+
+BENCHMARK_MAIN();
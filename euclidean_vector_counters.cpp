@@ -0,0 +1,80 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/euclidean_vector_counters.h"
+
+#include <sstream>
+#include <string>
+
+namespace ev_instrumentation {
+
+namespace {
+
+// Indexed by Counter
+constexpr const char* kCounterNames[kNumCounters] = {
+    "allocations",
+    "bytes_allocated",
+    "deep_copies",
+    "moves",
+    "evaluations",
+    "in_place_evaluations",
+    "vector_conversions",
+    "list_conversions",
+    "operator+",
+    "operator-",
+    "operator*",
+    "operator/",
+    "dot_product",
+    "operator==",
+    "operator+=",
+    "operator-=",
+    "operator*=",
+    "operator/=",
+};
+
+}  // namespace
+
+Counters operator-(const Counters& lhs, const Counters& rhs) noexcept {
+  Counters result;
+  for (int i = 0; i < kNumCounters; i++)
+    result.counts[i] = lhs.counts[i] - rhs.counts[i];
+  return result;
+}
+
+Counters operator+(const Counters& lhs, const Counters& rhs) noexcept {
+  Counters result;
+  for (int i = 0; i < kNumCounters; i++)
+    result.counts[i] = lhs.counts[i] + rhs.counts[i];
+  return result;
+}
+
+Counters GetCounters() noexcept {
+#if EUCLIDEAN_VECTOR_INSTRUMENTATION
+  return detail::threadCounters;
+#else
+  return Counters{};
+#endif
+}
+
+void ResetCounters() noexcept {
+#if EUCLIDEAN_VECTOR_INSTRUMENTATION
+  detail::threadCounters = Counters{};
+#endif
+}
+
+const char* GetCounterName(Counter c) noexcept {
+  return kCounterNames[static_cast<int>(c)];
+}
+
+std::string ToJson(const Counters& counters) {
+  std::ostringstream ss;
+  ss << '{';
+  for (int i = 0; i < kNumCounters; i++) {
+    if (i != 0)
+      ss << ", ";
+    ss << '"' << kCounterNames[i] << "\": " << counters.counts[i];
+  }
+  ss << '}';
+  return ss.str();
+}
+
+}  // namespace ev_instrumentation
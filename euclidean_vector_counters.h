@@ -0,0 +1,102 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_COUNTERS_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_COUNTERS_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// 1 to count what EuclideanVector does (see below). It must have the same value in the library
+// and in everything that uses it: bazel build --define instrumentation=on ... sets it for all.
+#ifndef EUCLIDEAN_VECTOR_INSTRUMENTATION
+#define EUCLIDEAN_VECTOR_INSTRUMENTATION 0
+#endif
+
+/*
+  Instrumentation counters
+
+  Built with EUCLIDEAN_VECTOR_INSTRUMENTATION=1, BasicEuclideanVector counts, for each thread:
+    - allocations and bytes allocated: storage taken from a memory resource (vectors of at most
+      kInlineDimensions dimensions allocate nothing)
+    - deep copies: copy construction, copy assignment, conversion to the other scalar type and
+      moves between different memory resources, which copy the magnitudes
+    - moves: move construction and move assignment
+    - evaluations: expressions computed into new storage, and in place: expiring expressions
+      computed in the magnitudes of the vector they own
+    - conversions to std::vector and std::list, which always copy
+    - calls of each arithmetic and comparison operator, on vectors and on expressions. u != v
+      counts as u == v, and the operators that build expressions count when the expression is
+      built, not when it is evaluated.
+
+  The counters of a thread are only updated and read by that thread, without synchronization:
+  work run on a ThreadPool is counted by its workers. Add up the Counters of several threads
+  with operator+.
+
+  Built without it (the default), the counting calls are empty inline functions that compile
+  to nothing, and GetCounters() always returns zeros.
+*/
+
+namespace ev_instrumentation {
+
+enum class Counter {
+  kAllocations,
+  kBytesAllocated,
+  kDeepCopies,
+  kMoves,
+  kEvaluations,
+  kInPlaceEvaluations,
+  kVectorConversions,
+  kListConversions,
+  kPlus,
+  kMinus,
+  kMultiply,  // u * d and d * u
+  kDivide,
+  kDot,  // u * v
+  kEqual,  // u == v and u != v
+  kPlusAssign,
+  kMinusAssign,
+  kMultiplyAssign,
+  kDivideAssign,
+};
+
+constexpr int kNumCounters = static_cast<int>(Counter::kDivideAssign) + 1;
+
+constexpr bool kEnabled = EUCLIDEAN_VECTOR_INSTRUMENTATION != 0;
+
+// Snapshot of the counters
+struct Counters {
+  std::int64_t operator[](Counter c) const noexcept { return counts[static_cast<int>(c)]; }
+
+  std::array<std::int64_t, kNumCounters> counts{};
+};
+
+// What happened between two snapshots: GetCounters() - before
+Counters operator-(const Counters&, const Counters&) noexcept;
+Counters operator+(const Counters&, const Counters&) noexcept;
+
+#if EUCLIDEAN_VECTOR_INSTRUMENTATION
+namespace detail {
+inline thread_local Counters threadCounters;
+}  // namespace detail
+#endif
+
+// Adds n to a counter of the calling thread
+inline void Count([[maybe_unused]] Counter c, [[maybe_unused]] std::int64_t n = 1) noexcept {
+#if EUCLIDEAN_VECTOR_INSTRUMENTATION
+  detail::threadCounters.counts[static_cast<int>(c)] += n;
+#endif
+}
+
+// Counters of the calling thread since it started or last called ResetCounters()
+Counters GetCounters() noexcept;
+void ResetCounters() noexcept;
+// Name of the counter in ToJson, such as "deep_copies" or "operator+="
+const char* GetCounterName(Counter) noexcept;
+// One JSON object with every counter by name, in the order of Counter:
+// {"allocations": 2, "bytes_allocated": 160, ...}
+std::string ToJson(const Counters&);
+
+}  // namespace ev_instrumentation
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_COUNTERS_H_
@@ -0,0 +1,198 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Each scenario resets the counters of the test thread, performs a few operations whose hidden
+  copies and allocations are known exactly, and compares every counter it expects to change
+  (and the ones that must not). Large vectors have kInlineDimensions + 4 dimensions, so their
+  storage comes from the heap; small vectors of kInlineDimensions must allocate nothing. Both
+  follow --define inline_dimensions.
+
+  The tests run in both builds. With EUCLIDEAN_VECTOR_INSTRUMENTATION=1 (bazel test --define
+  instrumentation=on) the counts are checked; without it every counter must stay 0, which is
+  the whole behaviour of the disabled build. The JSON dump is checked in both.
+
+*/
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_counters.h"
+#include "catch.h"
+
+namespace {
+
+using ev_instrumentation::Counter;
+
+// Expected value of a counter: count when instrumentation is enabled, 0 otherwise
+std::int64_t Expected(std::int64_t count) {
+  return ev_instrumentation::kEnabled ? count : 0;
+}
+
+std::int64_t Get(Counter c) {
+  return ev_instrumentation::GetCounters()[c];
+}
+
+// Dimensions of vectors stored on the heap and inside the object
+constexpr int kLarge = EuclideanVector::kInlineDimensions + 4;
+constexpr int kSmall = EuclideanVector::kInlineDimensions;
+
+}  // namespace
+
+SCENARIO("Count the copies, moves and allocations of EuclideanVectors") {
+  GIVEN("That there is a large vector and the counters are reset") {
+    auto u = EuclideanVector(kLarge, 1.0);
+    ev_instrumentation::ResetCounters();
+    WHEN("It is copy constructed") {
+      auto copy = u;
+      THEN("There is one deep copy and one allocation of its magnitudes") {
+        REQUIRE(Get(Counter::kDeepCopies) == Expected(1));
+        REQUIRE(Get(Counter::kAllocations) == Expected(1));
+        REQUIRE(Get(Counter::kBytesAllocated) == Expected(kLarge * sizeof(double)));
+        REQUIRE(Get(Counter::kMoves) == 0);
+      }
+    }
+    WHEN("It is copy assigned to a vector with the same number of dimensions") {
+      auto v = EuclideanVector(kLarge);
+      ev_instrumentation::ResetCounters();
+      v = u;
+      THEN("There is one deep copy and the storage of the target is reused") {
+        REQUIRE(Get(Counter::kDeepCopies) == Expected(1));
+        REQUIRE(Get(Counter::kAllocations) == 0);
+      }
+    }
+    WHEN("It is move constructed and then move assigned") {
+      auto moved = std::move(u);
+      auto v = EuclideanVector(kLarge);
+      v = std::move(moved);
+      THEN("There are two moves and only the construction of v allocates") {
+        REQUIRE(Get(Counter::kMoves) == Expected(2));
+        REQUIRE(Get(Counter::kDeepCopies) == 0);
+        REQUIRE(Get(Counter::kAllocations) == Expected(1));
+      }
+    }
+    WHEN("It is converted to a std::vector, a std::list and a float vector") {
+      const auto magnitudes = static_cast<std::vector<double>>(u);
+      const auto list = static_cast<std::list<double>>(u);
+      const auto narrow = BasicEuclideanVector<float>(u);
+      THEN("Each conversion is counted and only the float vector allocates storage") {
+        REQUIRE(Get(Counter::kVectorConversions) == Expected(1));
+        REQUIRE(Get(Counter::kListConversions) == Expected(1));
+        REQUIRE(Get(Counter::kDeepCopies) == Expected(1));
+        REQUIRE(Get(Counter::kAllocations) == Expected(1));
+        REQUIRE(Get(Counter::kBytesAllocated) == Expected(kLarge * sizeof(float)));
+      }
+    }
+  }
+  GIVEN("That there is a small vector and the counters are reset") {
+    auto u = EuclideanVector(kSmall, 1.0);
+    ev_instrumentation::ResetCounters();
+    WHEN("It is copied") {
+      auto copy = u;
+      THEN("The copy is counted but allocates nothing") {
+        REQUIRE(Get(Counter::kDeepCopies) == Expected(1));
+        REQUIRE(Get(Counter::kAllocations) == 0);
+        REQUIRE(Get(Counter::kBytesAllocated) == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Count the operators and evaluations of EuclideanVector expressions") {
+  GIVEN("That there are three large vectors and the counters are reset") {
+    auto a = EuclideanVector(kLarge, 1.0);
+    auto b = EuclideanVector(kLarge, 2.0);
+    auto c = EuclideanVector(kLarge, 3.0);
+    ev_instrumentation::ResetCounters();
+    WHEN("a + b - c * 2.0 / 4.0 is evaluated into a new vector") {
+      EuclideanVector result = a + b - c * 2.0 / 4.0;
+      THEN("Each operator is counted once and there is one evaluation and one allocation") {
+        REQUIRE(Get(Counter::kPlus) == Expected(1));
+        REQUIRE(Get(Counter::kMinus) == Expected(1));
+        REQUIRE(Get(Counter::kMultiply) == Expected(1));
+        REQUIRE(Get(Counter::kDivide) == Expected(1));
+        REQUIRE(Get(Counter::kEvaluations) == Expected(1));
+        REQUIRE(Get(Counter::kInPlaceEvaluations) == 0);
+        REQUIRE(Get(Counter::kAllocations) == Expected(1));
+        REQUIRE(Get(Counter::kDeepCopies) == 0);
+      }
+    }
+    WHEN("(std::move(a) + b) * 2.0 is evaluated into a new vector") {
+      EuclideanVector result = (std::move(a) + b) * 2.0;
+      THEN("It is evaluated in place in the magnitudes of a, without an allocation") {
+        REQUIRE(Get(Counter::kInPlaceEvaluations) == Expected(1));
+        REQUIRE(Get(Counter::kEvaluations) == 0);
+        REQUIRE(Get(Counter::kAllocations) == 0);
+      }
+    }
+    WHEN("The compound assignments, dot product and comparisons are used") {
+      a += b;
+      a -= c;
+      a += b * 2.0;
+      a *= 2.0;
+      a /= 2.0;
+      const double dot = a * b;
+      const bool equal = a == b;
+      const bool notEqual = a != b;
+      THEN("Each of them is counted, and none allocates") {
+        REQUIRE(dot != 0.0);
+        REQUIRE(notEqual != equal);
+        REQUIRE(Get(Counter::kPlusAssign) == Expected(2));
+        REQUIRE(Get(Counter::kMinusAssign) == Expected(1));
+        REQUIRE(Get(Counter::kMultiplyAssign) == Expected(1));
+        REQUIRE(Get(Counter::kDivideAssign) == Expected(1));
+        REQUIRE(Get(Counter::kMultiply) == Expected(1));
+        REQUIRE(Get(Counter::kDot) == Expected(1));
+        REQUIRE(Get(Counter::kEqual) == Expected(2));
+        REQUIRE(Get(Counter::kAllocations) == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Read, reset and dump the counters") {
+  GIVEN("That a large vector has been copied after the counters were reset") {
+    ev_instrumentation::ResetCounters();
+    const auto before = ev_instrumentation::GetCounters();
+    auto u = EuclideanVector(kLarge);
+    auto copy = u;
+    WHEN("The counters are read on this thread and on another thread") {
+      const auto difference = ev_instrumentation::GetCounters() - before;
+      auto other = ev_instrumentation::GetCounters();
+      std::thread thread{[&other] { other = ev_instrumentation::GetCounters(); }};
+      thread.join();
+      THEN("This thread counted the two allocations and the other thread nothing") {
+        REQUIRE(difference[Counter::kAllocations] == Expected(2));
+        REQUIRE(difference[Counter::kDeepCopies] == Expected(1));
+        REQUIRE((difference + difference)[Counter::kAllocations] == Expected(4));
+        REQUIRE(other[Counter::kAllocations] == 0);
+      }
+    }
+    WHEN("They are dumped as JSON") {
+      const auto json = ev_instrumentation::ToJson(ev_instrumentation::GetCounters());
+      THEN("Every counter is written by name, in order") {
+        const std::string expected = std::string{"{\"allocations\": "} +
+                                     (ev_instrumentation::kEnabled ? "2" : "0") +
+                                     ", \"bytes_allocated\": ";
+        REQUIRE(json.compare(0, expected.size(), expected) == 0);
+        REQUIRE(json.find("\"deep_copies\": ") != std::string::npos);
+        REQUIRE(json.find("\"operator+=\": 0") != std::string::npos);
+        REQUIRE(json.back() == '}');
+        REQUIRE(std::string{ev_instrumentation::GetCounterName(Counter::kDivideAssign)} ==
+                "operator/=");
+      }
+    }
+    WHEN("They are reset") {
+      ev_instrumentation::ResetCounters();
+      THEN("Every counter is 0") {
+        for (const auto count : ev_instrumentation::GetCounters().counts)
+          REQUIRE(count == 0);
+      }
+    }
+  }
+}
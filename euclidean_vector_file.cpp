@@ -0,0 +1,211 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/euclidean_vector_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+
+constexpr char EuclideanVectorFileHeader::kMagic[8];
+
+namespace {
+
+[[noreturn]] void ThrowFileError(const std::string& path, const std::string& problem) {
+  ev_detail::Throw("EuclideanVector file " + path + " " + problem);
+}
+
+EuclideanVectorFileHeader MakeHeader(int numDimensions, int numVectors) {
+  EuclideanVectorFileHeader header{};
+  std::memcpy(header.magic, EuclideanVectorFileHeader::kMagic, sizeof(header.magic));
+  header.version = EuclideanVectorFileHeader::kVersion;
+  header.byteOrder = EuclideanVectorFileHeader::kByteOrderMarker;
+  header.scalarType = EuclideanVectorFileHeader::kScalarDouble;
+  header.scalarSize = sizeof(double);
+  header.numDimensions = static_cast<std::uint64_t>(numDimensions);
+  header.numVectors = static_cast<std::uint64_t>(numVectors);
+  header.dataOffset = sizeof(EuclideanVectorFileHeader);
+  return header;
+}
+
+void CheckHeader(const std::string& path,
+                 const EuclideanVectorFileHeader& header,
+                 std::size_t fileSize) {
+  if (std::memcmp(header.magic, EuclideanVectorFileHeader::kMagic, sizeof(header.magic)) != 0)
+    ThrowFileError(path, "is not a EuclideanVector file");
+  if (header.byteOrder != EuclideanVectorFileHeader::kByteOrderMarker)
+    ThrowFileError(path, "was written on a machine with a different byte order");
+  if (header.version != EuclideanVectorFileHeader::kVersion)
+    ThrowFileError(path, "has unsupported version " + std::to_string(header.version));
+  if (header.scalarType != EuclideanVectorFileHeader::kScalarDouble ||
+      header.scalarSize != sizeof(double))
+    ThrowFileError(path, "has unsupported scalar type " + std::to_string(header.scalarType));
+  constexpr auto kMaxCount = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+  if (header.numDimensions > kMaxCount || header.numVectors > kMaxCount ||
+      header.dataOffset % alignof(double) != 0 || header.dataOffset > fileSize)
+    ThrowFileError(path, "is truncated or corrupt");
+  const std::uint64_t storedMagnitudes = (fileSize - header.dataOffset) / sizeof(double);
+  if (header.numDimensions != 0 && storedMagnitudes / header.numDimensions < header.numVectors)
+    ThrowFileError(path, "is truncated or corrupt");
+}
+
+}  // namespace
+
+// EuclideanVectorFileWriter
+
+EuclideanVectorFileWriter::EuclideanVectorFileWriter(const std::string& path, int numDimensions)
+  : path_{path}, numDimensions_{numDimensions}, numVectors_{0} {
+  if (numDimensions_ < 0) {
+    std::ostringstream ss;
+    ss << "Number of dimensions " << numDimensions_ << " is not valid";
+    ev_detail::Throw(ss.str());
+  }
+  file_.open(path_, std::ios::binary | std::ios::trunc);
+  if (!file_)
+    ThrowFileError(path_, "could not be created");
+  // The count is not known yet; Close() writes the header again once it is
+  WriteHeader();
+}
+
+void EuclideanVectorFileWriter::Write(EuclideanVectorView v) {
+  if (!file_.is_open())
+    ThrowFileError(path_, "is already closed");
+  ev_detail::CheckDimensions(numDimensions_, v.GetNumDimensions());
+
+  file_.write(reinterpret_cast<const char*>(v.data()),
+              static_cast<std::streamsize>(v.GetNumDimensions() * sizeof(double)));
+  if (!file_)
+    ThrowFileError(path_, "could not be written");
+  numVectors_++;
+}
+
+void EuclideanVectorFileWriter::Close() {
+  if (!file_.is_open())
+    return;
+  file_.seekp(0);
+  WriteHeader();
+  file_.close();
+  if (!file_)
+    ThrowFileError(path_, "could not be written");
+}
+
+EuclideanVectorFileWriter::~EuclideanVectorFileWriter() {
+#if EUCLIDEAN_VECTOR_EXCEPTIONS
+  try {
+    Close();
+  } catch (const EuclideanVectorError&) {
+  }
+#else
+  Close();
+#endif
+}
+
+void EuclideanVectorFileWriter::WriteHeader() {
+  const auto header = MakeHeader(numDimensions_, numVectors_);
+  file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!file_)
+    ThrowFileError(path_, "could not be written");
+}
+
+// EuclideanVectorFileReader
+
+EuclideanVectorFileReader::EuclideanVectorFileReader(const std::string& path, Access access)
+  : mapping_{nullptr}, mappingSize_{0}, data_{nullptr}, numVectors_{0}, numDimensions_{0} {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    ThrowFileError(path, std::string("could not be opened: ") + std::strerror(errno));
+  struct stat status;
+  if (::fstat(fd, &status) != 0) {
+    ::close(fd);
+    ThrowFileError(path, std::string("could not be opened: ") + std::strerror(errno));
+  }
+  const auto fileSize = static_cast<std::size_t>(status.st_size);
+  if (fileSize < sizeof(EuclideanVectorFileHeader)) {
+    ::close(fd);
+    ThrowFileError(path, "is not a EuclideanVector file");
+  }
+
+  void* mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps the file alive on its own
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+    ThrowFileError(path, std::string("could not be mapped: ") + std::strerror(errno));
+  mapping_ = mapping;
+  mappingSize_ = fileSize;
+
+  EuclideanVectorFileHeader header;
+  std::memcpy(&header, mapping_, sizeof(header));
+#if EUCLIDEAN_VECTOR_EXCEPTIONS
+  try {
+    CheckHeader(path, header, fileSize);
+  } catch (...) {
+    Unmap();
+    throw;
+  }
+#else
+  CheckHeader(path, header, fileSize);
+#endif
+  // The views allow any order, so read-ahead is only changed when asked for
+  if (access == Access::kSequential)
+    ::madvise(mapping_, mappingSize_, MADV_SEQUENTIAL);
+  else if (access == Access::kRandom)
+    ::madvise(mapping_, mappingSize_, MADV_RANDOM);
+
+  data_ = reinterpret_cast<const double*>(static_cast<const char*>(mapping_) + header.dataOffset);
+  numVectors_ = static_cast<int>(header.numVectors);
+  numDimensions_ = static_cast<int>(header.numDimensions);
+}
+
+EuclideanVectorFileReader::EuclideanVectorFileReader(EuclideanVectorFileReader&& r) noexcept
+  : mapping_{r.mapping_}, mappingSize_{r.mappingSize_}, data_{r.data_},
+    numVectors_{r.numVectors_}, numDimensions_{r.numDimensions_} {
+  r.mapping_ = nullptr;
+  r.mappingSize_ = 0;
+  r.data_ = nullptr;
+  r.numVectors_ = 0;
+  r.numDimensions_ = 0;
+}
+
+EuclideanVectorFileReader& EuclideanVectorFileReader::
+operator=(EuclideanVectorFileReader&& r) noexcept {
+  if (this == &r)
+    return *this;
+  Unmap();
+  std::swap(mapping_, r.mapping_);
+  std::swap(mappingSize_, r.mappingSize_);
+  std::swap(data_, r.data_);
+  std::swap(numVectors_, r.numVectors_);
+  std::swap(numDimensions_, r.numDimensions_);
+  return *this;
+}
+
+EuclideanVectorView EuclideanVectorFileReader::at(int index) const {
+  if (index < 0 || index >= numVectors_) {
+    std::ostringstream ss;
+    ss << "Index " << index << " is not valid for this EuclideanVectorFileReader object";
+    ev_detail::Throw(ss.str());
+  }
+
+  return (*this)[index];
+}
+
+EuclideanVectorFileReader::~EuclideanVectorFileReader() {
+  Unmap();
+}
+
+void EuclideanVectorFileReader::Unmap() noexcept {
+  if (mapping_ != nullptr)
+    ::munmap(mapping_, mappingSize_);
+  mapping_ = nullptr;
+  mappingSize_ = 0;
+  data_ = nullptr;
+  numVectors_ = 0;
+  numDimensions_ = 0;
+}
@@ -0,0 +1,129 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_FILE_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_FILE_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_view.h"
+
+/*
+  Binary file format for collections of vectors that all have the same number of dimensions.
+
+  Layout (version 1)
+    bytes  0 -  7 : magic "EVECTORS"
+    bytes  8 - 11 : format version (uint32)
+    bytes 12 - 15 : byte order marker 0x01020304 (uint32), in the byte order of the writer
+    bytes 16 - 19 : scalar type (uint32, 1 = IEEE 754 double)
+    bytes 20 - 23 : scalar size in bytes (uint32)
+    bytes 24 - 31 : number of dimensions (uint64)
+    bytes 32 - 39 : number of vectors (uint64)
+    bytes 40 - 47 : offset of the magnitudes from the start of the file (uint64)
+    bytes 48 - 63 : reserved, 0
+  followed by the magnitudes of every vector, one vector after the other, starting on a
+  64-byte boundary. All fields use the byte order of the machine that wrote the file.
+
+  EuclideanVectorFileWriter streams vectors to disk one at a time. EuclideanVectorFileReader
+  maps the file into memory and hands out EuclideanVectorViews that point straight into the
+  mapping, so opening a file costs a header check and the pages are read as they are used.
+*/
+
+struct EuclideanVectorFileHeader {
+  static constexpr char kMagic[8] = {'E', 'V', 'E', 'C', 'T', 'O', 'R', 'S'};
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::uint32_t kByteOrderMarker = 0x01020304;
+  static constexpr std::uint32_t kScalarDouble = 1;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byteOrder;
+  std::uint32_t scalarType;
+  std::uint32_t scalarSize;
+  std::uint64_t numDimensions;
+  std::uint64_t numVectors;
+  std::uint64_t dataOffset;
+  std::uint8_t reserved[16];
+};
+
+static_assert(sizeof(EuclideanVectorFileHeader) == 64, "The file header must be 64 bytes");
+
+class EuclideanVectorFileWriter {
+ public:
+  // Constructors
+  // Creates (or truncates) the file at path for vectors with numDimensions dimensions. Throws,
+  // without touching the file, if numDimensions is negative.
+  EuclideanVectorFileWriter(const std::string& path, int numDimensions);
+  EuclideanVectorFileWriter(const EuclideanVectorFileWriter&) = delete;
+
+  // Operations
+  EuclideanVectorFileWriter& operator=(const EuclideanVectorFileWriter&) = delete;
+
+  // Methods
+  // Appends one vector (a EuclideanVector, a view, or a vector of the batch through a view)
+  void Write(EuclideanVectorView);
+  int GetNumVectors() const noexcept { return numVectors_; }
+  // Writes the final header and closes the file. No vector can be written afterwards.
+  void Close();
+
+  // Destructor
+  // Closes the file if Close() was not called; errors are then ignored (without exceptions
+  // they abort like any other error)
+  ~EuclideanVectorFileWriter();
+
+ private:
+  void WriteHeader();
+
+  std::string path_;
+  std::ofstream file_;
+  int numDimensions_;
+  int numVectors_;
+};
+
+class EuclideanVectorFileReader {
+ public:
+  // How the views will be read, passed on to the kernel as a hint for paging the file in
+  enum class Access { kNormal, kSequential, kRandom };
+
+  // Constructors
+  explicit EuclideanVectorFileReader(const std::string& path, Access = Access::kNormal);
+  EuclideanVectorFileReader(const EuclideanVectorFileReader&) = delete;
+  // Move Constructor will leave the given reader with no vectors
+  EuclideanVectorFileReader(EuclideanVectorFileReader&&) noexcept;
+
+  // Operations
+  EuclideanVectorFileReader& operator=(const EuclideanVectorFileReader&) = delete;
+  // Move Assignment will leave the given reader with no vectors
+  EuclideanVectorFileReader& operator=(EuclideanVectorFileReader&&) noexcept;
+  // View of vector `index`, valid while the reader is alive
+  EuclideanVectorView operator[](const int index) const noexcept {
+    assert(index >= 0 && index < numVectors_);
+
+    return {data_ + static_cast<std::size_t>(index) * numDimensions_, numDimensions_};
+  }
+
+  // Methods
+  EuclideanVectorView at(int) const;
+  int GetNumVectors() const noexcept { return numVectors_; }
+  int GetNumDimensions() const noexcept { return numDimensions_; }
+  // Magnitudes of every vector, one vector after the other
+  const double* data() const noexcept { return data_; }
+
+  // Destructor
+  ~EuclideanVectorFileReader();
+
+ private:
+  void Unmap() noexcept;
+
+  void* mapping_;
+  std::size_t mappingSize_;
+  const double* data_;
+  int numVectors_;
+  int numDimensions_;
+};
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_FILE_H_
@@ -0,0 +1,236 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Files are written to the temporary directory and read back. The tests check that what is read
+  back is what was written, that the reader hands out views into the mapped file rather than
+  copies, and that every kind of invalid file is rejected with an error instead of being read.
+
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_file.h"
+#include "assignments/ev/euclidean_vector_view.h"
+#include "catch.h"
+
+namespace {
+
+std::string TempPath(const std::string& name) {
+  const auto directory = std::filesystem::temp_directory_path();
+  return (directory / ("euclidean_vector_file_test_" + name)).string();
+}
+
+std::vector<EuclideanVector> SampleVectors() {
+  std::vector<EuclideanVector> vectors;
+  for (int r = 0; r < 7; r++) {
+    std::vector<double> mags;
+    for (int d = 0; d < 3; d++)
+      mags.push_back(r * 3 + d + 0.25);
+    vectors.emplace_back(mags.begin(), mags.end());
+  }
+  return vectors;
+}
+
+void WriteSampleFile(const std::string& path) {
+  EuclideanVectorFileWriter writer{path, 3};
+  for (const auto& v : SampleVectors())
+    writer.Write(v);
+  writer.Close();
+}
+
+// Overwrites `length` bytes at `offset` of the file
+void Patch(const std::string& path, std::size_t offset, const void* bytes, std::size_t length) {
+  std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+  file.seekp(static_cast<std::streamoff>(offset));
+  file.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(length));
+}
+
+std::string OpenError(const std::string& path) {
+  try {
+    EuclideanVectorFileReader reader{path};
+  } catch (const EuclideanVectorError& e) {
+    return e.what();
+  }
+  return "";
+}
+
+}  // namespace
+
+SCENARIO("Write vectors to a file and map them back") {
+  GIVEN("That 7 vectors with 3 dimensions have been written to a file") {
+    const auto path = TempPath("roundtrip");
+    auto vectors = SampleVectors();
+    EuclideanVectorFileWriter writer{path, 3};
+    for (const auto& v : vectors)
+      writer.Write(v);
+    REQUIRE(writer.GetNumVectors() == 7);
+    writer.Close();
+    WHEN("The file is opened with a reader") {
+      EuclideanVectorFileReader reader{path};
+      THEN("It has 7 vectors with 3 dimensions, equal to the ones written") {
+        REQUIRE(reader.GetNumVectors() == 7);
+        REQUIRE(reader.GetNumDimensions() == 3);
+        for (int i = 0; i < 7; i++)
+          REQUIRE(reader[i] == vectors[i]);
+      }
+      THEN("The views point into the mapped file, which starts on a 64-byte boundary") {
+        REQUIRE(reader.at(2).data() == reader.data() + 6);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(reader.data()) % 64 == 0);
+      }
+      THEN("The views can be used in expressions") {
+        EuclideanVector sum = reader[0] + reader[1] * 2.0;
+        REQUIRE(sum == vectors[0] + vectors[1] * 2.0);
+        REQUIRE(reader[3] * reader[4] == vectors[3] * vectors[4]);
+      }
+      AND_WHEN("The file is opened again for sequential and for random access") {
+        EuclideanVectorFileReader sequential{path, EuclideanVectorFileReader::Access::kSequential};
+        EuclideanVectorFileReader random{path, EuclideanVectorFileReader::Access::kRandom};
+        THEN("Both readers read the same vectors") {
+          for (int i = 6; i >= 0; i--) {
+            REQUIRE(sequential[i] == vectors[i]);
+            REQUIRE(random[i] == vectors[i]);
+          }
+        }
+      }
+      AND_WHEN("The reader is moved") {
+        auto moved = std::move(reader);
+        THEN("The views of the new reader still refer to the file, the old one is empty") {
+          REQUIRE(moved[6] == vectors[6]);
+          REQUIRE(reader.GetNumVectors() == 0);
+        }
+      }
+    }
+    std::remove(path.c_str());
+  }
+  GIVEN("That a writer is destroyed without being closed") {
+    const auto path = TempPath("unclosed");
+    {
+      EuclideanVectorFileWriter writer{path, 2};
+      writer.Write(EuclideanVector(2, 1.5));
+      writer.Write(EuclideanVector(2, 2.5));
+    }
+    WHEN("The file is opened") {
+      EuclideanVectorFileReader reader{path};
+      THEN("It has both vectors") {
+        REQUIRE(reader.GetNumVectors() == 2);
+        REQUIRE(reader[1] == EuclideanVector(2, 2.5));
+      }
+    }
+    std::remove(path.c_str());
+  }
+  GIVEN("That a file has no vectors") {
+    const auto path = TempPath("empty");
+    EuclideanVectorFileWriter{path, 4}.Close();
+    WHEN("The file is opened") {
+      EuclideanVectorFileReader reader{path};
+      THEN("It has no vectors of 4 dimensions") {
+        REQUIRE(reader.GetNumVectors() == 0);
+        REQUIRE(reader.GetNumDimensions() == 4);
+      }
+    }
+    std::remove(path.c_str());
+  }
+}
+
+SCENARIO("Reject invalid writes and files") {
+  GIVEN("That there is a writer for vectors with 3 dimensions") {
+    const auto path = TempPath("mismatch");
+    EuclideanVectorFileWriter writer{path, 3};
+    WHEN("A vector with 2 dimensions is written") {
+      try {
+        writer.Write(EuclideanVector(2));
+        std::cerr << "Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Dimensions of LHS(3) and RHS(2) do not match") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Dimensions of LHS(3) and RHS(2) do not match") == 0);
+          REQUIRE(writer.GetNumVectors() == 0);
+        }
+      }
+    }
+    writer.Close();
+    std::remove(path.c_str());
+  }
+  GIVEN("That there is no file") {
+    const auto path = TempPath("negative");
+    std::remove(path.c_str());
+    WHEN("A writer for vectors with -1 dimensions is created") {
+      try {
+        EuclideanVectorFileWriter writer{path, -1};
+        std::cerr << writer.GetNumVectors() << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Number of dimensions -1 is not valid") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Number of dimensions -1 is not valid") == 0);
+          REQUIRE_FALSE(std::filesystem::exists(path));
+        }
+      }
+    }
+  }
+  GIVEN("That there is a valid file") {
+    const auto path = TempPath("invalid");
+    WriteSampleFile(path);
+    WHEN("Vector 7 is accessed") {
+      EuclideanVectorFileReader reader{path};
+      try {
+        auto v = reader.at(7);
+        std::cerr << v << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Index 7 is not valid for this EuclideanVectorFileReader "
+             "object") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Index 7 is not valid for this EuclideanVectorFileReader object") ==
+                  0);
+        }
+      }
+    }
+    WHEN("Its magic is overwritten") {
+      Patch(path, 0, "NOTVECTS", 8);
+      THEN("Opening it fails : is not a EuclideanVector file") {
+        REQUIRE(OpenError(path) ==
+                "EuclideanVector file " + path + " is not a EuclideanVector file");
+      }
+    }
+    WHEN("Its byte order marker is reversed") {
+      const std::uint32_t swapped = 0x04030201;
+      Patch(path, 12, &swapped, sizeof(swapped));
+      THEN("Opening it fails : was written on a machine with a different byte order") {
+        REQUIRE(OpenError(path) == "EuclideanVector file " + path +
+                                       " was written on a machine with a different byte order");
+      }
+    }
+    WHEN("Its version is changed to 2") {
+      const std::uint32_t version = 2;
+      Patch(path, 8, &version, sizeof(version));
+      THEN("Opening it fails : has unsupported version 2") {
+        REQUIRE(OpenError(path) == "EuclideanVector file " + path + " has unsupported version 2");
+      }
+    }
+    WHEN("Its header claims more vectors than the file holds") {
+      const std::uint64_t count = 8;
+      Patch(path, 32, &count, sizeof(count));
+      THEN("Opening it fails : is truncated or corrupt") {
+        REQUIRE(OpenError(path) == "EuclideanVector file " + path + " is truncated or corrupt");
+      }
+    }
+    std::remove(path.c_str());
+  }
+  GIVEN("That there is no file") {
+    const auto path = TempPath("missing");
+    std::remove(path.c_str());
+    WHEN("It is opened") {
+      THEN("Opening it fails : could not be opened") {
+        REQUIRE(OpenError(path).find("could not be opened") != std::string::npos);
+      }
+    }
+  }
+}
@@ -0,0 +1,547 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/euclidean_vector_hnsw.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_kernels.h"
+
+constexpr char HnswFileHeader::kMagic[8];
+
+namespace {
+
+// Highest layer a node can be on; far above anything reached with 2^31 nodes and m >= 2
+constexpr int kMaxLevels = 64;
+
+[[noreturn]] void ThrowFileError(const std::string& path, const std::string& problem) {
+  ev_detail::Throw("HnswIndex file " + path + " " + problem);
+}
+
+[[noreturn]] void ThrowInvalidParameter(const std::string& name, long value) {
+  std::ostringstream ss;
+  ss << "HnswIndex parameter " << name << " " << value << " is not valid";
+  ev_detail::Throw(ss.str());
+}
+
+void CheckNeighbours(int k) {
+  if (k < 0) {
+    std::ostringstream ss;
+    ss << "Number of neighbours " << k << " is not valid";
+    ev_detail::Throw(ss.str());
+  }
+}
+
+// Layer of node `index`: floor(-ln(u) / ln(m)) for u uniform in (0, 1], with u taken from a
+// SplitMix64 hash of the seed and the index so that it does not depend on the insertion order
+int RandomLevel(std::uint64_t seed, int index, int m) noexcept {
+  std::uint64_t x = seed + 0x9E3779B97F4A7C15ULL * (static_cast<std::uint64_t>(index) + 1);
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  x ^= x >> 31;
+  const double u = static_cast<double>((x >> 11) + 1) * 0x1.0p-53;
+  const auto level = static_cast<int>(-std::log(u) / std::log(static_cast<double>(m)));
+  return std::min(level, kMaxLevels - 1);
+}
+
+// Nodes seen by one graph search. Entries are tagged with the search that set them, so
+// starting a search costs nothing rather than clearing one flag per node.
+class VisitedSet {
+ public:
+  void Reset(int numNodes) {
+    if (static_cast<int>(marks_.size()) < numNodes)
+      marks_.resize(numNodes, 0);
+    if (++generation_ == 0) {
+      std::fill(marks_.begin(), marks_.end(), 0);
+      generation_ = 1;
+    }
+  }
+  // False if the node was already visited
+  bool Insert(int node) noexcept {
+    if (marks_[node] == generation_)
+      return false;
+    marks_[node] = generation_;
+    return true;
+  }
+
+ private:
+  std::vector<std::uint32_t> marks_;
+  std::uint32_t generation_ = 0;
+};
+
+VisitedSet& ThreadVisitedSet() {
+  thread_local VisitedSet visited;
+  return visited;
+}
+
+template <typename T>
+void WriteValues(std::ofstream& file, const std::string& path, const T* values, std::size_t n) {
+  file.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(n * sizeof(T)));
+  if (!file)
+    ThrowFileError(path, "could not be written");
+}
+
+template <typename T>
+void ReadValues(std::ifstream& file, const std::string& path, T* values, std::size_t n) {
+  file.read(reinterpret_cast<char*>(values), static_cast<std::streamsize>(n * sizeof(T)));
+  if (!file)
+    ThrowFileError(path, "is truncated or corrupt");
+}
+
+}  // namespace
+
+// Constructors
+
+HnswIndex::HnswIndex(int numDimensions, Metric metric, const HnswParameters& parameters)
+  : numDimensions_{numDimensions}, numVectors_{0}, metric_{metric}, parameters_{parameters},
+    entryPoint_{-1}, maxLevel_{-1}, nodeLocks_{new std::mutex[kNodeLocks]},
+    entryLock_{new std::mutex} {
+  if (numDimensions < 0)
+    ThrowInvalidParameter("numDimensions", numDimensions);
+  if (parameters.m < 2)
+    ThrowInvalidParameter("m", parameters.m);
+  if (parameters.efConstruction < 1)
+    ThrowInvalidParameter("efConstruction", parameters.efConstruction);
+}
+
+HnswIndex::HnswIndex(HnswIndex&& index) noexcept
+  : numDimensions_{index.numDimensions_}, numVectors_{index.numVectors_},
+    metric_{index.metric_}, parameters_{index.parameters_},
+    magnitudes_{std::move(index.magnitudes_)}, squaredNorms_{std::move(index.squaredNorms_)},
+    links_{std::move(index.links_)}, entryPoint_{index.entryPoint_},
+    maxLevel_{index.maxLevel_}, nodeLocks_{std::move(index.nodeLocks_)},
+    entryLock_{std::move(index.entryLock_)} {
+  index.Clear();
+}
+
+// Operations
+
+HnswIndex& HnswIndex::operator=(HnswIndex&& index) noexcept {
+  if (this == &index)
+    return *this;
+  numDimensions_ = index.numDimensions_;
+  numVectors_ = index.numVectors_;
+  metric_ = index.metric_;
+  parameters_ = index.parameters_;
+  magnitudes_ = std::move(index.magnitudes_);
+  squaredNorms_ = std::move(index.squaredNorms_);
+  links_ = std::move(index.links_);
+  entryPoint_ = index.entryPoint_;
+  maxLevel_ = index.maxLevel_;
+  nodeLocks_ = std::move(index.nodeLocks_);
+  entryLock_ = std::move(index.entryLock_);
+  index.Clear();
+  return *this;
+}
+
+// Methods
+
+int HnswIndex::Add(const EuclideanVector& v) {
+  ev_detail::CheckDimensions(v.GetNumDimensions(), numDimensions_);
+  const int node = Append(v);
+  Link(node);
+  return node;
+}
+
+void HnswIndex::Add(const std::vector<EuclideanVector>& vectors, ThreadPool* pool) {
+  for (const auto& v : vectors)
+    ev_detail::CheckDimensions(v.GetNumDimensions(), numDimensions_);
+  // Checked before anything is stored, so a failure leaves the index unchanged
+  if (metric_ == Metric::kCosine) {
+    for (const auto& v : vectors)
+      static_cast<void>(v.CreateUnitVector());
+  }
+
+  const int first = numVectors_;
+  const auto count = static_cast<int>(vectors.size());
+  magnitudes_.reserve(magnitudes_.size() + vectors.size() * numDimensions_);
+  links_.reserve(links_.size() + vectors.size());
+  // Every node is stored before any is linked, so the storage does not move while the pool's
+  // threads follow links into it
+  for (const auto& v : vectors)
+    Append(v);
+  if (pool != nullptr) {
+    pool->ParallelFor(count, [this, first](int i) { Link(first + i); });
+  } else {
+    for (int i = 0; i < count; i++)
+      Link(first + i);
+  }
+}
+
+std::vector<Neighbour> HnswIndex::Search(const EuclideanVector& query,
+                                         int k,
+                                         int efSearch) const {
+  CheckNeighbours(k);
+  ev_detail::CheckDimensions(query.GetNumDimensions(), numDimensions_);
+  if (numVectors_ == 0 || k == 0)
+    return {};
+
+  // Cosine compares unit vectors; the other metrics use the query as it is
+  auto unit = EuclideanVector(0);
+  const double* q = query.data();
+  if (metric_ == Metric::kCosine) {
+    unit = query.CreateUnitVector();
+    q = unit.data();
+  }
+  const double querySquaredNorm =
+      metric_ == Metric::kSquaredL2 ? ev_kernels::SumOfSquares(q, numDimensions_) : 0.0;
+
+  int start = entryPoint_;
+  for (int level = maxLevel_; level > 0; level--)
+    start = GreedyClosest(q, querySquaredNorm, start, level, false);
+  auto found = SearchLayer(q, querySquaredNorm, start, std::max(efSearch, k), 0, false);
+
+  const int count = std::min(k, static_cast<int>(found.size()));
+  std::partial_sort(found.begin(), found.begin() + count, found.end(), Nearer);
+  std::vector<Neighbour> result;
+  result.reserve(count);
+  for (int i = 0; i < count; i++) {
+    // Rounding can take the squared distance of (nearly) identical vectors just below 0
+    const double score =
+        metric_ == Metric::kSquaredL2 ? std::max(found[i].key, 0.0) : -found[i].key;
+    result.push_back(Neighbour{found[i].index, score});
+  }
+  return result;
+}
+
+std::vector<std::vector<Neighbour>> HnswIndex::Search(const std::vector<EuclideanVector>& queries,
+                                                      int k,
+                                                      int efSearch,
+                                                      ThreadPool* pool) const {
+  CheckNeighbours(k);
+  for (const auto& query : queries)
+    ev_detail::CheckDimensions(query.GetNumDimensions(), numDimensions_);
+
+  const auto numQueries = static_cast<int>(queries.size());
+  std::vector<std::vector<Neighbour>> results(numQueries);
+  auto searchOne = [&](int q) { results[q] = Search(queries[q], k, efSearch); };
+  if (pool != nullptr) {
+    pool->ParallelFor(numQueries, searchOne);
+  } else {
+    for (int q = 0; q < numQueries; q++)
+      searchOne(q);
+  }
+  return results;
+}
+
+void HnswIndex::Save(const std::string& path) const {
+  std::ofstream file{path, std::ios::binary | std::ios::trunc};
+  if (!file)
+    ThrowFileError(path, "could not be created");
+
+  HnswFileHeader header{};
+  std::memcpy(header.magic, HnswFileHeader::kMagic, sizeof(header.magic));
+  header.version = HnswFileHeader::kVersion;
+  header.byteOrder = HnswFileHeader::kByteOrderMarker;
+  header.metric = static_cast<std::uint32_t>(metric_);
+  header.m = static_cast<std::uint32_t>(parameters_.m);
+  header.efConstruction = static_cast<std::uint32_t>(parameters_.efConstruction);
+  header.entryPoint = entryPoint_;
+  header.seed = parameters_.seed;
+  header.numDimensions = static_cast<std::uint64_t>(numDimensions_);
+  header.numVectors = static_cast<std::uint64_t>(numVectors_);
+  header.maxLevel = maxLevel_;
+  WriteValues(file, path, &header, 1);
+
+  // The magnitudes of every node, then for every node its number of layers and, for each
+  // layer, its number of links followed by the links
+  WriteValues(file, path, magnitudes_.data(), magnitudes_.size());
+  for (const auto& nodeLinks : links_) {
+    const auto levels = static_cast<std::uint32_t>(nodeLinks.size());
+    WriteValues(file, path, &levels, 1);
+    for (const auto& levelLinks : nodeLinks) {
+      const auto count = static_cast<std::uint32_t>(levelLinks.size());
+      WriteValues(file, path, &count, 1);
+      WriteValues(file, path, levelLinks.data(), levelLinks.size());
+    }
+  }
+  file.close();
+  if (!file)
+    ThrowFileError(path, "could not be written");
+}
+
+HnswIndex HnswIndex::Load(const std::string& path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file)
+    ThrowFileError(path, "could not be opened");
+
+  HnswFileHeader header;
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!file || std::memcmp(header.magic, HnswFileHeader::kMagic, sizeof(header.magic)) != 0)
+    ThrowFileError(path, "is not a HnswIndex file");
+  if (header.byteOrder != HnswFileHeader::kByteOrderMarker)
+    ThrowFileError(path, "was written on a machine with a different byte order");
+  if (header.version != HnswFileHeader::kVersion)
+    ThrowFileError(path, "has unsupported version " + std::to_string(header.version));
+  constexpr auto kMaxCount = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+  if (header.metric > static_cast<std::uint32_t>(Metric::kCosine) || header.m < 2 ||
+      header.m > kMaxCount / 2 || header.efConstruction < 1 ||
+      header.efConstruction > kMaxCount || header.numDimensions > kMaxCount ||
+      header.numVectors > kMaxCount || header.maxLevel >= kMaxLevels ||
+      (header.numVectors == 0) != (header.entryPoint == -1) ||
+      (header.numVectors == 0) != (header.maxLevel == -1) || header.entryPoint < -1 ||
+      static_cast<std::int64_t>(header.entryPoint) >= static_cast<std::int64_t>(header.numVectors))
+    ThrowFileError(path, "is truncated or corrupt");
+
+  HnswParameters parameters;
+  parameters.m = static_cast<int>(header.m);
+  parameters.efConstruction = static_cast<int>(header.efConstruction);
+  parameters.seed = header.seed;
+  auto index = HnswIndex(static_cast<int>(header.numDimensions),
+                         static_cast<Metric>(header.metric), parameters);
+  const auto numVectors = static_cast<int>(header.numVectors);
+
+  index.magnitudes_.resize(header.numVectors * header.numDimensions);
+  ReadValues(file, path, index.magnitudes_.data(), index.magnitudes_.size());
+  index.links_.resize(numVectors);
+  for (auto& nodeLinks : index.links_) {
+    std::uint32_t levels;
+    ReadValues(file, path, &levels, 1);
+    if (levels < 1 || levels > kMaxLevels)
+      ThrowFileError(path, "is truncated or corrupt");
+    nodeLinks.resize(levels);
+    for (int level = 0; level < static_cast<int>(levels); level++) {
+      std::uint32_t count;
+      ReadValues(file, path, &count, 1);
+      if (count > static_cast<std::uint32_t>(index.MaxLinks(level)))
+        ThrowFileError(path, "is truncated or corrupt");
+      nodeLinks[level].resize(count);
+      ReadValues(file, path, nodeLinks[level].data(), count);
+    }
+  }
+  // Searches follow links without checking them, so every link must lead to a node on its layer
+  for (const auto& nodeLinks : index.links_) {
+    for (int level = 0; level < static_cast<int>(nodeLinks.size()); level++) {
+      for (int link : nodeLinks[level]) {
+        if (link < 0 || link >= numVectors ||
+            static_cast<int>(index.links_[link].size()) <= level)
+          ThrowFileError(path, "is truncated or corrupt");
+      }
+    }
+  }
+  if (numVectors > 0 &&
+      static_cast<int>(index.links_[header.entryPoint].size()) != header.maxLevel + 1)
+    ThrowFileError(path, "is truncated or corrupt");
+
+  index.numVectors_ = numVectors;
+  index.entryPoint_ = header.entryPoint;
+  index.maxLevel_ = header.maxLevel;
+  if (index.metric_ == Metric::kSquaredL2) {
+    index.squaredNorms_.resize(numVectors);
+    for (int node = 0; node < numVectors; node++)
+      index.squaredNorms_[node] = ev_kernels::SumOfSquares(index.Magnitudes(node),
+                                                           index.numDimensions_);
+  }
+  return index;
+}
+
+const std::vector<int>& HnswIndex::GetLinks(int index, int level) const {
+  if (index < 0 || index >= numVectors_) {
+    std::ostringstream ss;
+    ss << "Index " << index << " is not valid for this HnswIndex object";
+    ev_detail::Throw(ss.str());
+  }
+  if (level < 0 || level >= static_cast<int>(links_[index].size())) {
+    std::ostringstream ss;
+    ss << "Level " << level << " is not valid for node " << index << " of this HnswIndex object";
+    ev_detail::Throw(ss.str());
+  }
+
+  return links_[index][level];
+}
+
+// Private
+
+bool HnswIndex::Nearer(const Candidate& a, const Candidate& b) noexcept {
+  return a.key < b.key || (a.key == b.key && a.index < b.index);
+}
+
+void HnswIndex::Clear() noexcept {
+  numDimensions_ = 0;
+  numVectors_ = 0;
+  magnitudes_.clear();
+  squaredNorms_.clear();
+  links_.clear();
+  entryPoint_ = -1;
+  maxLevel_ = -1;
+}
+
+int HnswIndex::Append(const EuclideanVector& v) {
+  // A moved-from index gets its locks back when it is used again
+  if (!nodeLocks_) {
+    nodeLocks_.reset(new std::mutex[kNodeLocks]);
+    entryLock_.reset(new std::mutex);
+  }
+  auto unit = EuclideanVector(0);
+  const double* stored = v.data();
+  if (metric_ == Metric::kCosine) {
+    unit = v.CreateUnitVector();
+    stored = unit.data();
+  }
+  magnitudes_.insert(magnitudes_.end(), stored, stored + numDimensions_);
+  if (metric_ == Metric::kSquaredL2)
+    squaredNorms_.push_back(ev_kernels::SumOfSquares(stored, numDimensions_));
+  links_.emplace_back(RandomLevel(parameters_.seed, numVectors_, parameters_.m) + 1);
+  return numVectors_++;
+}
+
+void HnswIndex::Link(int node) {
+  const int level = static_cast<int>(links_[node].size()) - 1;
+  const double* q = Magnitudes(node);
+  const double querySquaredNorm = metric_ == Metric::kSquaredL2 ? squaredNorms_[node] : 0.0;
+
+  // A node that will become the new top of the graph keeps the entry point locked until it is
+  // linked, so no other node starts from it half-linked
+  std::unique_lock<std::mutex> entryGuard{*entryLock_};
+  if (entryPoint_ < 0) {
+    entryPoint_ = node;
+    maxLevel_ = level;
+    return;
+  }
+  int start = entryPoint_;
+  const int top = maxLevel_;
+  if (level <= top)
+    entryGuard.unlock();
+
+  for (int l = top; l > level; l--)
+    start = GreedyClosest(q, querySquaredNorm, start, l, true);
+  for (int l = std::min(level, top); l >= 0; l--) {
+    auto found = SearchLayer(q, querySquaredNorm, start, parameters_.efConstruction, l, true);
+    start = std::min_element(found.begin(), found.end(), Nearer)->index;
+    auto neighbours = SelectNeighbours(std::move(found), parameters_.m);
+    {
+      std::lock_guard<std::mutex> guard{NodeLock(node)};
+      links_[node][l] = neighbours;
+    }
+    for (int e : neighbours) {
+      std::lock_guard<std::mutex> guard{NodeLock(e)};
+      auto& eLinks = links_[e][l];
+      if (static_cast<int>(eLinks.size()) < MaxLinks(l)) {
+        eLinks.push_back(node);
+        continue;
+      }
+      // Full: keep the best spread of the old links and the new one
+      std::vector<Candidate> candidates;
+      candidates.reserve(eLinks.size() + 1);
+      for (int link : eLinks)
+        candidates.push_back(Candidate{Key(e, link), link});
+      candidates.push_back(Candidate{Key(e, node), node});
+      eLinks = SelectNeighbours(std::move(candidates), MaxLinks(l));
+    }
+  }
+  if (level > top) {
+    entryPoint_ = node;
+    maxLevel_ = level;
+  }
+}
+
+double HnswIndex::Key(const double* query, double querySquaredNorm, int node) const noexcept {
+  const double dot = ev_kernels::Dot(query, Magnitudes(node), numDimensions_);
+  // Same order of operations as ExactSearch, so equal vectors get equal scores
+  return metric_ == Metric::kSquaredL2 ? squaredNorms_[node] - 2 * dot + querySquaredNorm : -dot;
+}
+
+double HnswIndex::Key(int a, int b) const noexcept {
+  return Key(Magnitudes(a), metric_ == Metric::kSquaredL2 ? squaredNorms_[a] : 0.0, b);
+}
+
+int HnswIndex::GreedyClosest(const double* query,
+                             double querySquaredNorm,
+                             int start,
+                             int level,
+                             bool lock) const {
+  auto best = Candidate{Key(query, querySquaredNorm, start), start};
+  std::vector<int> copied;
+  for (bool moved = true; moved;) {
+    moved = false;
+    const std::vector<int>* links = &links_[best.index][level];
+    if (lock) {
+      std::lock_guard<std::mutex> guard{NodeLock(best.index)};
+      copied = *links;
+      links = &copied;
+    }
+    for (int link : *links) {
+      const auto candidate = Candidate{Key(query, querySquaredNorm, link), link};
+      if (Nearer(candidate, best)) {
+        best = candidate;
+        moved = true;
+      }
+    }
+  }
+  return best.index;
+}
+
+std::vector<HnswIndex::Candidate> HnswIndex::SearchLayer(const double* query,
+                                                         double querySquaredNorm,
+                                                         int start,
+                                                         int ef,
+                                                         int level,
+                                                         bool lock) const {
+  auto farther = [](const Candidate& a, const Candidate& b) { return Nearer(b, a); };
+  auto& visited = ThreadVisitedSet();
+  visited.Reset(numVectors_);
+  visited.Insert(start);
+
+  // Min-heap of the nodes still to expand, and max-heap of the ef nearest found so far
+  const auto first = Candidate{Key(query, querySquaredNorm, start), start};
+  std::vector<Candidate> toExpand{first};
+  std::vector<Candidate> nearest{first};
+  std::vector<int> copied;
+  while (!toExpand.empty()) {
+    std::pop_heap(toExpand.begin(), toExpand.end(), farther);
+    const auto current = toExpand.back();
+    toExpand.pop_back();
+    // Every node left to expand is farther than the farthest of a full result
+    if (static_cast<int>(nearest.size()) >= ef && Nearer(nearest.front(), current))
+      break;
+
+    const std::vector<int>* links = &links_[current.index][level];
+    if (lock) {
+      std::lock_guard<std::mutex> guard{NodeLock(current.index)};
+      copied = *links;
+      links = &copied;
+    }
+    for (int link : *links) {
+      if (!visited.Insert(link))
+        continue;
+      const auto candidate = Candidate{Key(query, querySquaredNorm, link), link};
+      if (static_cast<int>(nearest.size()) < ef || Nearer(candidate, nearest.front())) {
+        toExpand.push_back(candidate);
+        std::push_heap(toExpand.begin(), toExpand.end(), farther);
+        nearest.push_back(candidate);
+        std::push_heap(nearest.begin(), nearest.end(), Nearer);
+        if (static_cast<int>(nearest.size()) > ef) {
+          std::pop_heap(nearest.begin(), nearest.end(), Nearer);
+          nearest.pop_back();
+        }
+      }
+    }
+  }
+  return nearest;
+}
+
+std::vector<int> HnswIndex::SelectNeighbours(std::vector<Candidate> candidates,
+                                             int maxLinks) const {
+  // A candidate is kept only if it is nearer to the new node than to every candidate already
+  // kept, which spreads the links in different directions instead of into one cluster
+  std::sort(candidates.begin(), candidates.end(), Nearer);
+  std::vector<int> selected;
+  selected.reserve(maxLinks);
+  for (const auto& candidate : candidates) {
+    if (static_cast<int>(selected.size()) >= maxLinks)
+      break;
+    const bool diverse = std::none_of(selected.begin(), selected.end(), [&](int kept) {
+      return Key(candidate.index, kept) < candidate.key;
+    });
+    if (diverse)
+      selected.push_back(candidate.index);
+  }
+  return selected;
+}
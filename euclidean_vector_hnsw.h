@@ -0,0 +1,157 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_HNSW_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_HNSW_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_search.h"
+#include "assignments/ev/thread_pool.h"
+
+/*
+  Approximate k-nearest-neighbour search with a hierarchical navigable small world (HNSW) graph.
+
+  Every vector is a node of the graph on layer 0, and on each layer above it with probability
+  1 / M per layer. A search walks greedily down from the single node of the top layer and then
+  explores layer 0 keeping the efSearch best candidates seen so far, so it visits a few thousand
+  nodes instead of the whole collection. Larger efSearch (and efConstruction) trade speed for
+  recall; the recall of a configuration is best measured against ExactSearch, as
+  euclidean_vector_hnsw_benchmark.cpp does.
+
+  Parameters
+    m              : links per node on the upper layers, 2 * m on layer 0. At least 2.
+    efConstruction : candidates kept while linking a new node. At least 1.
+    seed           : the layer of node i is a function of seed and i only, so building from the
+                     same vectors gives the same layers whatever the number of threads.
+
+  Metrics and scores are those of ExactSearch (squared L2 expanded around precomputed norms,
+  inner product, cosine on vectors normalised when they are added). Inner product is not a
+  distance, so its graph is a heuristic and its recall is usually lower than for the others.
+
+  Add with a ThreadPool links the new vectors concurrently, with a lock guarding the links of
+  every node. The graph (and so the results) then depends on thread timing; its quality does
+  not. Search is safe to call from several threads at once, but not while vectors are added.
+
+  Save writes the vectors and the graph to one binary file (byte order and format checked on
+  Load like EuclideanVectorFile), so a built index can be reloaded without rebuilding it.
+*/
+
+struct HnswParameters {
+  int m = 16;
+  int efConstruction = 200;
+  std::uint64_t seed = 42;
+};
+
+struct HnswFileHeader {
+  static constexpr char kMagic[8] = {'E', 'V', 'H', 'N', 'S', 'W', 'I', 'X'};
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::uint32_t kByteOrderMarker = 0x01020304;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byteOrder;
+  std::uint32_t metric;
+  std::uint32_t m;
+  std::uint32_t efConstruction;
+  std::int32_t entryPoint;
+  std::uint64_t seed;
+  std::uint64_t numDimensions;
+  std::uint64_t numVectors;
+  std::int32_t maxLevel;
+  std::uint8_t reserved[4];
+};
+
+static_assert(sizeof(HnswFileHeader) == 64, "The file header must be 64 bytes");
+
+class HnswIndex {
+ public:
+  // Constructors
+  explicit HnswIndex(int numDimensions,
+                     Metric = Metric::kSquaredL2,
+                     const HnswParameters& = HnswParameters{});
+  HnswIndex(const HnswIndex&) = delete;
+  // Move Constructor will leave the given index with no vectors
+  HnswIndex(HnswIndex&&) noexcept;
+
+  // Operations
+  HnswIndex& operator=(const HnswIndex&) = delete;
+  // Move Assignment will leave the given index with no vectors
+  HnswIndex& operator=(HnswIndex&&) noexcept;
+
+  // Methods
+  // Adds the vector as node GetNumVectors() and returns its index
+  int Add(const EuclideanVector&);
+  // Adds the vectors in order, linking them on the pool's threads if one is given
+  void Add(const std::vector<EuclideanVector>&, ThreadPool* = nullptr);
+  // The min(k, GetNumVectors()) nearest vectors found, nearest first, exploring
+  // max(efSearch, k) candidates on layer 0
+  std::vector<Neighbour> Search(const EuclideanVector& query, int k, int efSearch) const;
+  std::vector<std::vector<Neighbour>> Search(const std::vector<EuclideanVector>& queries,
+                                             int k,
+                                             int efSearch,
+                                             ThreadPool* = nullptr) const;
+  void Save(const std::string& path) const;
+  static HnswIndex Load(const std::string& path);
+  int GetNumVectors() const noexcept { return numVectors_; }
+  int GetNumDimensions() const noexcept { return numDimensions_; }
+  Metric GetMetric() const noexcept { return metric_; }
+  const HnswParameters& GetParameters() const noexcept { return parameters_; }
+  // Highest layer of the graph, -1 while it is empty
+  int GetMaxLevel() const noexcept { return maxLevel_; }
+  // Links of node `index` on `level`; for inspecting the graph
+  const std::vector<int>& GetLinks(int index, int level) const;
+
+  // Destructor
+  ~HnswIndex() = default;
+
+ private:
+  struct Candidate {
+    double key;
+    int index;
+  };
+
+  static bool Nearer(const Candidate&, const Candidate&) noexcept;
+  void Clear() noexcept;
+  // Appends the magnitudes and the (empty) links of one node without linking it
+  int Append(const EuclideanVector&);
+  void Link(int node);
+  double Key(const double* query, double querySquaredNorm, int node) const noexcept;
+  double Key(int a, int b) const noexcept;
+  int GreedyClosest(const double* query, double querySquaredNorm, int start, int level,
+                    bool lock) const;
+  std::vector<Candidate> SearchLayer(const double* query, double querySquaredNorm, int start,
+                                     int ef, int level, bool lock) const;
+  std::vector<int> SelectNeighbours(std::vector<Candidate> candidates, int maxLinks) const;
+  int MaxLinks(int level) const noexcept {
+    return level == 0 ? 2 * parameters_.m : parameters_.m;
+  }
+  const double* Magnitudes(int node) const noexcept {
+    return magnitudes_.data() + static_cast<std::size_t>(node) * numDimensions_;
+  }
+  std::mutex& NodeLock(int node) const noexcept { return nodeLocks_[node % kNodeLocks]; }
+
+  static constexpr int kNodeLocks = 1 << 12;
+
+  int numDimensions_;
+  int numVectors_;
+  Metric metric_;
+  HnswParameters parameters_;
+  // Magnitudes of every node, one after the other (unit vectors for kCosine)
+  std::vector<double> magnitudes_;
+  // |x|^2 of every node, for kSquaredL2
+  std::vector<double> squaredNorms_;
+  // links_[node][level]: neighbours of the node on each layer it belongs to
+  std::vector<std::vector<std::vector<int>>> links_;
+  int entryPoint_;
+  int maxLevel_;
+  // Locks guarding the links of the nodes (node % kNodeLocks), and the entry point
+  std::unique_ptr<std::mutex[]> nodeLocks_;
+  std::unique_ptr<std::mutex> entryLock_;
+};
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_HNSW_H_
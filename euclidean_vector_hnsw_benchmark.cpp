@@ -0,0 +1,139 @@
+// Created By : Rahil Agrawal
+//
+// Recall against latency for HnswIndex, with ExactSearch over the same vectors as the baseline.
+//
+// The data is synthetic and generated here: 2^17 vectors with 64 dimensions drawn around 256
+// random centres, which is closer to embeddings than uniform noise. BM_HnswSearch reports the
+// recall@10 of 256 queries (counter "recall") and queries/s for each efSearch, so the curve can
+// be read off one run:
+//   euclidean_vector_hnsw_benchmark --benchmark_counters_tabular=true
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_hnsw.h"
+#include "assignments/ev/euclidean_vector_search.h"
+#include "assignments/ev/thread_pool.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+constexpr int kDatabaseVectors = 1 << 17;
+constexpr int kDimensions = 64;
+constexpr int kClusters = 256;
+constexpr int kQueries = 256;
+constexpr int kNeighbours = 10;
+
+std::vector<EuclideanVector> ClusteredVectors(int count, unsigned seed) {
+  std::mt19937 gen{seed};
+  // The centres are the same for the database and the queries
+  std::mt19937 centreGen{0};
+  std::uniform_real_distribution<double> centreDist{-1.0, 1.0};
+  std::vector<EuclideanVector> centres;
+  for (int c = 0; c < kClusters; c++) {
+    auto centre = EuclideanVector(kDimensions);
+    for (int i = 0; i < kDimensions; i++)
+      centre[i] = centreDist(centreGen);
+    centres.push_back(std::move(centre));
+  }
+  std::uniform_int_distribution<int> pick{0, kClusters - 1};
+  std::normal_distribution<double> noise{0.0, 0.25};
+  std::vector<EuclideanVector> vectors;
+  for (int v = 0; v < count; v++) {
+    auto ev = EuclideanVector(centres[pick(gen)]);
+    for (int i = 0; i < kDimensions; i++)
+      ev[i] += noise(gen);
+    vectors.push_back(std::move(ev));
+  }
+  return vectors;
+}
+
+ThreadPool& Pool() {
+  static ThreadPool pool{static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
+  return pool;
+}
+
+// Built once and shared by every benchmark
+struct Data {
+  std::vector<EuclideanVector> vectors = ClusteredVectors(kDatabaseVectors, 1);
+  std::vector<EuclideanVector> queries = ClusteredVectors(kQueries, 2);
+  ExactSearch exact{vectors};
+  std::vector<std::vector<Neighbour>> truth = exact.Search(queries, kNeighbours, &Pool());
+  HnswIndex index = [this] {
+    auto index = HnswIndex(kDimensions);
+    index.Add(vectors, &Pool());
+    return index;
+  }();
+};
+
+const Data& GetData() {
+  static const Data data;
+  return data;
+}
+
+double Recall(const std::vector<std::vector<Neighbour>>& found) {
+  const auto& truth = GetData().truth;
+  int hits = 0;
+  for (int q = 0; q < kQueries; q++) {
+    std::set<int> expected;
+    for (const auto& neighbour : truth[q])
+      expected.insert(neighbour.index);
+    for (const auto& neighbour : found[q])
+      hits += static_cast<int>(expected.count(neighbour.index));
+  }
+  return static_cast<double>(hits) / (kQueries * kNeighbours);
+}
+
+void BM_ExactSearch(benchmark::State& state) {
+  const auto& data = GetData();
+  int q = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data.exact.Search(data.queries[q], kNeighbours));
+    q = (q + 1) % kQueries;
+  }
+  state.counters["recall"] = 1.0;
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_HnswSearch(benchmark::State& state) {
+  const auto& data = GetData();
+  const int efSearch = static_cast<int>(state.range(0));
+  int q = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data.index.Search(data.queries[q], kNeighbours, efSearch));
+    q = (q + 1) % kQueries;
+  }
+  state.counters["recall"] = Recall(data.index.Search(data.queries, kNeighbours, efSearch));
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Builds an index over the first 2^15 vectors with 1 thread and with every hardware thread
+void BM_HnswBuild(benchmark::State& state) {
+  const auto& data = GetData();
+  const std::vector<EuclideanVector> vectors(data.vectors.begin(),
+                                             data.vectors.begin() + (1 << 15));
+  auto pool = ThreadPool(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    auto index = HnswIndex(kDimensions);
+    index.Add(vectors, &pool);
+    benchmark::DoNotOptimize(index.GetMaxLevel());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int>(vectors.size()));
+}
+
+BENCHMARK(BM_ExactSearch);
+BENCHMARK(BM_HnswSearch)->RangeMultiplier(2)->Range(10, 640);
+BENCHMARK(BM_HnswBuild)
+    ->Arg(1)
+    ->Arg(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
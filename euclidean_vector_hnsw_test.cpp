@@ -0,0 +1,387 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  HnswIndex is approximate, so its results are checked against ExactSearch over the same
+  vectors: the fraction of the true 10 nearest neighbours it finds (the recall) must be high
+  for every metric, whether the index was built one vector at a time or on a ThreadPool, and
+  the scores it reports must be the exact scores of the vectors it returns.
+
+  The parts that are exact are checked exactly: results are sorted nearest first, a vector of
+  the index is its own nearest neighbour, building twice without threads gives the same graph,
+  and an index saved and loaded again answers every query identically. The graph itself is
+  checked for links that stay within their limits and lead to nodes on the same layer.
+  Failure scenarios follow the EuclideanVector error messages and the EuclideanVector file ones.
+
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_hnsw.h"
+#include "assignments/ev/euclidean_vector_search.h"
+#include "assignments/ev/euclidean_vector_testing.h"
+#include "assignments/ev/thread_pool.h"
+#include "catch.h"
+
+namespace {
+
+std::string TempPath(const std::string& name) {
+  const auto directory = std::filesystem::temp_directory_path();
+  return (directory / ("euclidean_vector_hnsw_test_" + name)).string();
+}
+
+// Fraction of the exact neighbours that were found
+double Recall(const std::vector<std::vector<Neighbour>>& found,
+              const std::vector<std::vector<Neighbour>>& exact) {
+  int hits = 0;
+  int total = 0;
+  for (std::size_t q = 0; q < exact.size(); q++) {
+    std::set<int> expected;
+    for (const auto& neighbour : exact[q])
+      expected.insert(neighbour.index);
+    for (const auto& neighbour : found[q])
+      hits += static_cast<int>(expected.count(neighbour.index));
+    total += static_cast<int>(exact[q].size());
+  }
+  return static_cast<double>(hits) / total;
+}
+
+bool SameResults(const std::vector<std::vector<Neighbour>>& a,
+                 const std::vector<std::vector<Neighbour>>& b) {
+  if (a.size() != b.size())
+    return false;
+  for (std::size_t q = 0; q < a.size(); q++) {
+    if (a[q].size() != b[q].size())
+      return false;
+    for (std::size_t i = 0; i < a[q].size(); i++) {
+      if (a[q][i].index != b[q][i].index || a[q][i].score != b[q][i].score)
+        return false;
+    }
+  }
+  return true;
+}
+
+// Every link leads to another node on the same layer, and no node has too many links
+bool ValidGraph(const HnswIndex& index) {
+  for (int node = 0; node < index.GetNumVectors(); node++) {
+    for (int level = 0;; level++) {
+      std::vector<int> links;
+      try {
+        links = index.GetLinks(node, level);
+      } catch (const EuclideanVectorError&) {
+        break;
+      }
+      const int maxLinks = (level == 0 ? 2 : 1) * index.GetParameters().m;
+      if (static_cast<int>(links.size()) > maxLinks)
+        return false;
+      for (int link : links) {
+        if (link == node || link < 0 || link >= index.GetNumVectors())
+          return false;
+        try {
+          index.GetLinks(link, level);
+        } catch (const EuclideanVectorError&) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+HnswParameters TestParameters() {
+  HnswParameters parameters;
+  parameters.m = 12;
+  parameters.efConstruction = 100;
+  return parameters;
+}
+
+}  // namespace
+
+SCENARIO("Find approximate nearest neighbours") {
+  const auto vectors = ev_testing::RandomVectors(3000, 16, 1);
+  const auto queries = ev_testing::RandomVectors(40, 16, 2);
+  for (auto metric : {Metric::kSquaredL2, Metric::kInnerProduct, Metric::kCosine}) {
+    GIVEN("That there is an index over 3000 vectors with metric " +
+          std::to_string(static_cast<int>(metric))) {
+      auto index = HnswIndex(16, metric, TestParameters());
+      index.Add(vectors);
+      const auto exact = ExactSearch(vectors, metric).Search(queries, 10);
+      REQUIRE(index.GetNumVectors() == 3000);
+      REQUIRE(index.GetNumDimensions() == 16);
+      REQUIRE(index.GetMetric() == metric);
+      REQUIRE(index.GetMaxLevel() >= 1);
+      REQUIRE(ValidGraph(index));
+      WHEN("The 10 nearest neighbours of 40 queries are searched with efSearch 100") {
+        auto results = index.Search(queries, 10, 100);
+        THEN("Nearly all of the exact neighbours are found") {
+          REQUIRE(Recall(results, exact) >= 0.95);
+        }
+        THEN("The results are sorted and have the exact scores") {
+          const auto all = ExactSearch(vectors, metric).Search(queries, 3000);
+          for (int q = 0; q < 40; q++) {
+            REQUIRE(results[q].size() == 10);
+            std::vector<double> scores(3000);
+            for (const auto& neighbour : all[q])
+              scores[neighbour.index] = neighbour.score;
+            for (int i = 0; i < 10; i++) {
+              REQUIRE(results[q][i].score == Approx(scores[results[q][i].index]).margin(1e-12));
+              if (i > 0 && metric == Metric::kSquaredL2)
+                REQUIRE(results[q][i - 1].score <= results[q][i].score);
+              if (i > 0 && metric != Metric::kSquaredL2)
+                REQUIRE(results[q][i - 1].score >= results[q][i].score);
+            }
+          }
+        }
+        AND_WHEN("They are searched one at a time and on a ThreadPool") {
+          auto pool = ThreadPool(4);
+          auto parallel = index.Search(queries, 10, 100, &pool);
+          std::vector<std::vector<Neighbour>> single;
+          for (const auto& query : queries)
+            single.push_back(index.Search(query, 10, 100));
+          THEN("The results are identical") {
+            REQUIRE(SameResults(parallel, results));
+            REQUIRE(SameResults(single, results));
+          }
+        }
+      }
+      WHEN("The efSearch is larger") {
+        THEN("The recall does not get worse") {
+          REQUIRE(Recall(index.Search(queries, 10, 400), exact) >=
+                  Recall(index.Search(queries, 10, 10), exact));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Build an index on several threads") {
+  GIVEN("That there are 3000 vectors") {
+    const auto vectors = ev_testing::RandomVectors(3000, 16, 3);
+    const auto queries = ev_testing::RandomVectors(40, 16, 4);
+    const auto exact = ExactSearch(vectors).Search(queries, 10);
+    WHEN("An index is built from them on a ThreadPool of 4 threads") {
+      auto pool = ThreadPool(4);
+      auto index = HnswIndex(16, Metric::kSquaredL2, TestParameters());
+      index.Add(vectors, &pool);
+      THEN("The graph is valid and nearly all of the exact neighbours are found") {
+        REQUIRE(index.GetNumVectors() == 3000);
+        REQUIRE(ValidGraph(index));
+        REQUIRE(Recall(index.Search(queries, 10, 100), exact) >= 0.95);
+      }
+    }
+    WHEN("Two indices are built from them without threads") {
+      auto index1 = HnswIndex(16, Metric::kSquaredL2, TestParameters());
+      auto index2 = HnswIndex(16, Metric::kSquaredL2, TestParameters());
+      index1.Add(vectors);
+      for (const auto& v : vectors)
+        index2.Add(v);
+      THEN("They have the same graph and give the same results") {
+        for (int node = 0; node < 3000; node++)
+          REQUIRE(index1.GetLinks(node, 0) == index2.GetLinks(node, 0));
+        REQUIRE(SameResults(index1.Search(queries, 10, 50), index2.Search(queries, 10, 50)));
+      }
+    }
+  }
+}
+
+SCENARIO("Search indices with few vectors") {
+  GIVEN("That there is an empty index") {
+    auto index = HnswIndex(4);
+    WHEN("It is searched") {
+      THEN("Nothing is found") {
+        REQUIRE(index.GetMaxLevel() == -1);
+        REQUIRE(index.Search(EuclideanVector(4), 3, 10).empty());
+      }
+    }
+  }
+  GIVEN("That there is an index over 5 vectors") {
+    auto vectors = ev_testing::RandomVectors(5, 4, 5);
+    auto index = HnswIndex(4);
+    for (int i = 0; i < 5; i++)
+      REQUIRE(index.Add(vectors[i]) == i);
+    WHEN("Each vector is searched for") {
+      THEN("It is its own nearest neighbour, at distance 0") {
+        for (int i = 0; i < 5; i++) {
+          auto results = index.Search(vectors[i], 1, 10);
+          REQUIRE(results.size() == 1);
+          REQUIRE(results[0].index == i);
+          REQUIRE(results[0].score == Approx(0.0).margin(1e-12));
+        }
+      }
+    }
+    WHEN("More neighbours than vectors are searched") {
+      THEN("Every vector is returned") { REQUIRE(index.Search(vectors[0], 10, 1).size() == 5); }
+    }
+    WHEN("0 neighbours are searched") {
+      THEN("Nothing is returned") { REQUIRE(index.Search(vectors[0], 0, 10).empty()); }
+    }
+    WHEN("It is moved") {
+      auto moved = std::move(index);
+      THEN("The moved-from index has no vectors and can be used again") {
+        REQUIRE(moved.GetNumVectors() == 5);
+        REQUIRE(index.GetNumVectors() == 0);  // NOLINT(bugprone-use-after-move)
+        REQUIRE(index.Search(EuclideanVector(0), 1, 10).empty());
+        index = HnswIndex(2);
+        REQUIRE(index.Add(EuclideanVector(2, 1.0)) == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Save an index and load it back") {
+  GIVEN("That an index over 1000 vectors has been saved") {
+    const auto path = TempPath("roundtrip");
+    const auto vectors = ev_testing::RandomVectors(1000, 8, 6);
+    const auto queries = ev_testing::RandomVectors(20, 8, 7);
+    auto index = HnswIndex(8, Metric::kCosine, TestParameters());
+    index.Add(vectors);
+    index.Save(path);
+    WHEN("It is loaded") {
+      auto loaded = HnswIndex::Load(path);
+      THEN("It has the same vectors, parameters and graph") {
+        REQUIRE(loaded.GetNumVectors() == 1000);
+        REQUIRE(loaded.GetNumDimensions() == 8);
+        REQUIRE(loaded.GetMetric() == Metric::kCosine);
+        REQUIRE(loaded.GetParameters().m == 12);
+        REQUIRE(loaded.GetParameters().efConstruction == 100);
+        REQUIRE(loaded.GetParameters().seed == index.GetParameters().seed);
+        REQUIRE(loaded.GetMaxLevel() == index.GetMaxLevel());
+        for (int node = 0; node < 1000; node++)
+          REQUIRE(loaded.GetLinks(node, 0) == index.GetLinks(node, 0));
+      }
+      THEN("It gives the same results") {
+        REQUIRE(SameResults(loaded.Search(queries, 10, 50), index.Search(queries, 10, 50)));
+      }
+      AND_WHEN("More vectors are added to both") {
+        const auto more = ev_testing::RandomVectors(100, 8, 8);
+        index.Add(more);
+        loaded.Add(more);
+        THEN("They still give the same results") {
+          REQUIRE(SameResults(loaded.Search(queries, 10, 50), index.Search(queries, 10, 50)));
+        }
+      }
+    }
+    std::remove(path.c_str());
+  }
+  GIVEN("That an empty index has been saved") {
+    const auto path = TempPath("empty");
+    HnswIndex(3, Metric::kInnerProduct).Save(path);
+    WHEN("It is loaded") {
+      auto loaded = HnswIndex::Load(path);
+      THEN("It is empty") {
+        REQUIRE(loaded.GetNumVectors() == 0);
+        REQUIRE(loaded.GetNumDimensions() == 3);
+        REQUIRE(loaded.GetMetric() == Metric::kInnerProduct);
+      }
+    }
+    std::remove(path.c_str());
+  }
+}
+
+SCENARIO("Load invalid index files") {
+  GIVEN("That a valid index file has been saved") {
+    const auto path = TempPath("invalid");
+    auto index = HnswIndex(4);
+    index.Add(ev_testing::RandomVectors(50, 4, 9));
+    index.Save(path);
+    const auto size = std::filesystem::file_size(path);
+    WHEN("It is truncated") {
+      std::filesystem::resize_file(path, size - 4);
+      THEN("Loading it throws") {
+        REQUIRE_THROWS_WITH(HnswIndex::Load(path),
+                            "HnswIndex file " + path + " is truncated or corrupt");
+      }
+    }
+    WHEN("A link is changed to a node that does not exist") {
+      // The last four bytes are the last link of the last node on its top layer
+      std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+      const std::int32_t link = 50;
+      file.seekp(static_cast<std::streamoff>(size - sizeof(link)));
+      file.write(reinterpret_cast<const char*>(&link), sizeof(link));
+      file.close();
+      THEN("Loading it throws") {
+        REQUIRE_THROWS_WITH(HnswIndex::Load(path),
+                            "HnswIndex file " + path + " is truncated or corrupt");
+      }
+    }
+    WHEN("Its magic is changed") {
+      std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+      file.write("EVECTORS", 8);
+      file.close();
+      THEN("Loading it throws") {
+        REQUIRE_THROWS_WITH(HnswIndex::Load(path), "HnswIndex file " + path +
+                                                       " is not a HnswIndex file");
+      }
+    }
+    std::remove(path.c_str());
+  }
+  GIVEN("That there is no file") {
+    THEN("Loading it throws") {
+      REQUIRE_THROWS_WITH(HnswIndex::Load(TempPath("missing")),
+                          "HnswIndex file " + TempPath("missing") + " could not be opened");
+    }
+  }
+}
+
+SCENARIO("Use an index with invalid arguments") {
+  GIVEN("That there are invalid parameters") {
+    HnswParameters smallM;
+    smallM.m = 1;
+    HnswParameters noCandidates;
+    noCandidates.efConstruction = 0;
+    THEN("Creating an index throws") {
+      REQUIRE_THROWS_WITH(HnswIndex(4, Metric::kSquaredL2, smallM),
+                          "HnswIndex parameter m 1 is not valid");
+      REQUIRE_THROWS_WITH(HnswIndex(4, Metric::kSquaredL2, noCandidates),
+                          "HnswIndex parameter efConstruction 0 is not valid");
+    }
+  }
+  GIVEN("That there is an index over vectors with 4 dimensions") {
+    auto index = HnswIndex(4, Metric::kCosine);
+    index.Add(ev_testing::RandomVectors(10, 4, 10));
+    WHEN("Vectors with 5 dimensions are added or searched") {
+      THEN("An exception is thrown and nothing is added") {
+        REQUIRE_THROWS_WITH(index.Add(EuclideanVector(5)),
+                            "Dimensions of LHS(5) and RHS(4) do not match");
+        REQUIRE_THROWS_WITH(index.Add(std::vector<EuclideanVector>{EuclideanVector(4, 1.0),
+                                                                   EuclideanVector(5, 1.0)}),
+                            "Dimensions of LHS(5) and RHS(4) do not match");
+        REQUIRE_THROWS_WITH(index.Search(EuclideanVector(5), 1, 10),
+                            "Dimensions of LHS(5) and RHS(4) do not match");
+        REQUIRE(index.GetNumVectors() == 10);
+      }
+    }
+    WHEN("A zero vector is added or searched for") {
+      THEN("An exception is thrown and nothing is added") {
+        REQUIRE_THROWS_WITH(
+            index.Add(std::vector<EuclideanVector>{EuclideanVector(4, 1.0), EuclideanVector(4)}),
+            "EuclideanVector with euclidean normal of 0 does not have a unit vector");
+        REQUIRE_THROWS_WITH(
+            index.Search(EuclideanVector(4), 1, 10),
+            "EuclideanVector with euclidean normal of 0 does not have a unit vector");
+        REQUIRE(index.GetNumVectors() == 10);
+      }
+    }
+    WHEN("A negative number of neighbours is searched") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(index.Search(EuclideanVector(4, 1.0), -1, 10),
+                            "Number of neighbours -1 is not valid");
+      }
+    }
+    WHEN("The links of an invalid node or level are read") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(index.GetLinks(10, 0), "Index 10 is not valid for this HnswIndex object");
+        REQUIRE_THROWS_WITH(index.GetLinks(0, 64),
+                            "Level 64 is not valid for node 0 of this HnswIndex object");
+      }
+    }
+  }
+}
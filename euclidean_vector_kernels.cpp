@@ -0,0 +1,1670 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/euclidean_vector_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define EV_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace ev_kernels {
+
+namespace {
+
+/*
+  Scalar
+*/
+
+double DotScalar(const double* a, const double* b, int n) noexcept {
+  double sum = 0.0;
+  for (int i = 0; i < n; i++)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+double SumOfSquaresScalar(const double* a, int n) noexcept {
+  double sum = 0.0;
+  for (int i = 0; i < n; i++)
+    sum += a[i] * a[i];
+  return sum;
+}
+
+void AddScalar(double* dst, const double* a, const double* b, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] + b[i];
+}
+
+void SubtractScalar(double* dst, const double* a, const double* b, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] - b[i];
+}
+
+void ScaleScalar(double* dst, const double* a, double d, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] * d;
+}
+
+void DivideScalar(double* dst, const double* a, double d, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] / d;
+}
+
+void AxpyScalar(double* dst, double a, const double* x, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] += a * x[i];
+}
+
+void AxpbyScalar(double* dst, double a, const double* x, double b, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] = a * x[i] + b * dst[i];
+}
+
+float DotFloatScalar(const float* a, const float* b, int n) noexcept {
+  float sum = 0.0f;
+  for (int i = 0; i < n; i++)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+float SumOfSquaresFloatScalar(const float* a, int n) noexcept {
+  return DotFloatScalar(a, a, n);
+}
+
+double DotFloatInDoubleScalar(const float* a, const float* b, int n) noexcept {
+  double sum = 0.0;
+  for (int i = 0; i < n; i++)
+    sum += static_cast<double>(a[i]) * b[i];
+  return sum;
+}
+
+double SumOfSquaresFloatInDoubleScalar(const float* a, int n) noexcept {
+  return DotFloatInDoubleScalar(a, a, n);
+}
+
+void AddFloatScalar(float* dst, const float* a, const float* b, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] + b[i];
+}
+
+void SubtractFloatScalar(float* dst, const float* a, const float* b, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] - b[i];
+}
+
+void ScaleFloatScalar(float* dst, const float* a, float d, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] * d;
+}
+
+void DivideFloatScalar(float* dst, const float* a, float d, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] / d;
+}
+
+void AxpyFloatScalar(float* dst, float a, const float* x, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] += a * x[i];
+}
+
+void AxpbyFloatScalar(float* dst, float a, const float* x, float b, int n) noexcept {
+  for (int i = 0; i < n; i++)
+    dst[i] = a * x[i] + b * dst[i];
+}
+
+std::int32_t DotInt8Scalar(const std::int8_t* a, const std::int8_t* b, int n) noexcept {
+  std::int32_t sum = 0;
+  for (int i = 0; i < n; i++)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+double SparseDotScalar(const int* indices, const double* values, int nnz,
+                       const double* dense) noexcept {
+  double sum = 0.0;
+  for (int k = 0; k < nnz; k++)
+    sum += values[k] * dense[indices[k]];
+  return sum;
+}
+
+void SparseAxpyScalar(double* dense, double a, const int* indices, const double* values,
+                      int nnz) noexcept {
+  for (int k = 0; k < nnz; k++)
+    dense[indices[k]] += a * values[k];
+}
+
+void Dot4Scalar(const double* x, const double* const* queries, int n, double* out) noexcept {
+  double sum0 = 0.0;
+  double sum1 = 0.0;
+  double sum2 = 0.0;
+  double sum3 = 0.0;
+  for (int i = 0; i < n; i++) {
+    sum0 += x[i] * queries[0][i];
+    sum1 += x[i] * queries[1][i];
+    sum2 += x[i] * queries[2][i];
+    sum3 += x[i] * queries[3][i];
+  }
+  out[0] = sum0;
+  out[1] = sum1;
+  out[2] = sum2;
+  out[3] = sum3;
+}
+
+void DotPanelScalar(const double* a, const double* b, int n, double* out,
+                    int outStride) noexcept {
+  double sums[kPanelVectors][kPanelVectors] = {};
+  for (int i = 0; i < n; i++) {
+    const double* ai = a + i * kPanelVectors;
+    const double* bi = b + i * kPanelVectors;
+    for (int r = 0; r < kPanelVectors; r++) {
+      for (int c = 0; c < kPanelVectors; c++)
+        sums[r][c] += ai[r] * bi[c];
+    }
+  }
+  for (int r = 0; r < kPanelVectors; r++) {
+    for (int c = 0; c < kPanelVectors; c++)
+      out[r * outStride + c] += sums[r][c];
+  }
+}
+
+// No contraction into fused multiply-add, even when the whole library is built for an FMA CPU
+__attribute__((optimize("fp-contract=off"))) void WelfordUpdateScalar(const double* x,
+                                                                      double inverseCount,
+                                                                      int n,
+                                                                      double* mean,
+                                                                      double* m2,
+                                                                      double* min,
+                                                                      double* max) noexcept {
+  for (int i = 0; i < n; i++) {
+    const double delta = x[i] - mean[i];
+    mean[i] += delta * inverseCount;
+    m2[i] += delta * (x[i] - mean[i]);
+    min[i] = std::min(min[i], x[i]);
+    max[i] = std::max(max[i], x[i]);
+  }
+}
+
+// s + t == a + b exactly (Knuth's TwoSum); only additions, so nothing can be contracted
+inline void TwoSum(double a, double b, double& s, double& t) noexcept {
+  s = a + b;
+  const double z = s - a;
+  t = (a - (s - z)) + (b - z);
+}
+
+// Adds the sum s (with compensation c) of one call into the caller's running sum
+inline void MergeCompensated(double s, double c, double* sum, double* compensation) noexcept {
+  double t;
+  TwoSum(*sum, s, *sum, t);
+  *compensation += t + c;
+}
+
+__attribute__((optimize("fp-contract=off"))) void DotCompensatedScalar(
+    const double* a,
+    const double* b,
+    int n,
+    double* sum,
+    double* compensation) noexcept {
+  double s = 0.0;
+  double c = 0.0;
+  for (int i = 0; i < n; i++) {
+    const double p = a[i] * b[i];
+    const double e = std::fma(a[i], b[i], -p);
+    double t;
+    TwoSum(s, p, s, t);
+    c += t + e;
+  }
+  MergeCompensated(s, c, sum, compensation);
+}
+
+double MaxAbsScalar(const double* a, int n) noexcept {
+  double m = 0.0;
+  for (int i = 0; i < n; i++)
+    m = std::max(m, std::abs(a[i]));
+  return m;
+}
+
+double ScaledDotScalar(const double* a, double sa, const double* b, double sb, int n) noexcept {
+  double sum = 0.0;
+  for (int i = 0; i < n; i++)
+    sum += (a[i] * sa) * (b[i] * sb);
+  return sum;
+}
+
+#ifdef EV_KERNELS_X86
+
+/*
+  SSE2 (2 doubles per register)
+*/
+
+__attribute__((target("sse2"))) double HorizontalSum(__m128d v) noexcept {
+  return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+__attribute__((target("sse2"))) double DotSse2(const double* a, const double* b, int n) noexcept {
+  __m128d acc0 = _mm_setzero_pd();
+  __m128d acc1 = _mm_setzero_pd();
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+  }
+  double sum = HorizontalSum(_mm_add_pd(acc0, acc1));
+  for (; i < n; i++)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+__attribute__((target("sse2"))) double SumOfSquaresSse2(const double* a, int n) noexcept {
+  return DotSse2(a, a, n);
+}
+
+__attribute__((target("sse2"))) void AddSse2(double* dst, const double* a,
+                                             const double* b, int n) noexcept {
+  int i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm_storeu_pd(dst + i, _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+  for (; i < n; i++)
+    dst[i] = a[i] + b[i];
+}
+
+__attribute__((target("sse2"))) void SubtractSse2(double* dst, const double* a,
+                                                  const double* b, int n) noexcept {
+  int i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm_storeu_pd(dst + i, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+  for (; i < n; i++)
+    dst[i] = a[i] - b[i];
+}
+
+__attribute__((target("sse2"))) void ScaleSse2(double* dst, const double* a, double d,
+                                               int n) noexcept {
+  const __m128d vd = _mm_set1_pd(d);
+  int i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm_storeu_pd(dst + i, _mm_mul_pd(_mm_loadu_pd(a + i), vd));
+  for (; i < n; i++)
+    dst[i] = a[i] * d;
+}
+
+__attribute__((target("sse2"))) void DivideSse2(double* dst, const double* a, double d,
+                                                int n) noexcept {
+  const __m128d vd = _mm_set1_pd(d);
+  int i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm_storeu_pd(dst + i, _mm_div_pd(_mm_loadu_pd(a + i), vd));
+  for (; i < n; i++)
+    dst[i] = a[i] / d;
+}
+
+__attribute__((target("sse2"))) void AxpySse2(double* dst, double a, const double* x,
+                                              int n) noexcept {
+  const __m128d va = _mm_set1_pd(a);
+  int i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm_storeu_pd(dst + i, _mm_add_pd(_mm_loadu_pd(dst + i), _mm_mul_pd(va, _mm_loadu_pd(x + i))));
+  for (; i < n; i++)
+    dst[i] += a * x[i];
+}
+
+__attribute__((target("sse2"))) void AxpbySse2(double* dst, double a, const double* x, double b,
+                                               int n) noexcept {
+  const __m128d va = _mm_set1_pd(a);
+  const __m128d vb = _mm_set1_pd(b);
+  int i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(dst + i, _mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + i)),
+                                      _mm_mul_pd(vb, _mm_loadu_pd(dst + i))));
+  }
+  for (; i < n; i++)
+    dst[i] = a * x[i] + b * dst[i];
+}
+
+/*
+  SSE2, float (4 floats per register)
+*/
+
+__attribute__((target("sse2"))) float HorizontalSum(__m128 v) noexcept {
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 1)));
+}
+
+__attribute__((target("sse2"))) float DotFloatSse2(const float* a, const float* b,
+                                                   int n) noexcept {
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  float sum = HorizontalSum(_mm_add_ps(acc0, acc1));
+  for (; i < n; i++)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+__attribute__((target("sse2"))) float SumOfSquaresFloatSse2(const float* a, int n) noexcept {
+  return DotFloatSse2(a, a, n);
+}
+
+// Two floats, widened to doubles
+__attribute__((target("sse2"))) __m128d LoadFloatsAsDoubles(const float* a) noexcept {
+  return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(a))));
+}
+
+__attribute__((target("sse2"))) double DotFloatInDoubleSse2(const float* a, const float* b,
+                                                            int n) noexcept {
+  __m128d acc0 = _mm_setzero_pd();
+  __m128d acc1 = _mm_setzero_pd();
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc0 = _mm_add_pd(acc0, _mm_mul_pd(LoadFloatsAsDoubles(a + i), LoadFloatsAsDoubles(b + i)));
+    acc1 = _mm_add_pd(acc1,
+                      _mm_mul_pd(LoadFloatsAsDoubles(a + i + 2), LoadFloatsAsDoubles(b + i + 2)));
+  }
+  double sum = HorizontalSum(_mm_add_pd(acc0, acc1));
+  for (; i < n; i++)
+    sum += static_cast<double>(a[i]) * b[i];
+  return sum;
+}
+
+__attribute__((target("sse2"))) double SumOfSquaresFloatInDoubleSse2(const float* a,
+                                                                     int n) noexcept {
+  return DotFloatInDoubleSse2(a, a, n);
+}
+
+__attribute__((target("sse2"))) void AddFloatSse2(float* dst, const float* a,
+                                                  const float* b, int n) noexcept {
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  for (; i < n; i++)
+    dst[i] = a[i] + b[i];
+}
+
+__attribute__((target("sse2"))) void SubtractFloatSse2(float* dst, const float* a,
+                                                       const float* b, int n) noexcept {
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i, _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  for (; i < n; i++)
+    dst[i] = a[i] - b[i];
+}
+
+__attribute__((target("sse2"))) void ScaleFloatSse2(float* dst, const float* a, float d,
+                                                    int n) noexcept {
+  const __m128 vd = _mm_set1_ps(d);
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(a + i), vd));
+  for (; i < n; i++)
+    dst[i] = a[i] * d;
+}
+
+__attribute__((target("sse2"))) void DivideFloatSse2(float* dst, const float* a, float d,
+                                                     int n) noexcept {
+  const __m128 vd = _mm_set1_ps(d);
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i, _mm_div_ps(_mm_loadu_ps(a + i), vd));
+  for (; i < n; i++)
+    dst[i] = a[i] / d;
+}
+
+__attribute__((target("sse2"))) void AxpyFloatSse2(float* dst, float a, const float* x,
+                                                   int n) noexcept {
+  const __m128 va = _mm_set1_ps(a);
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(va, _mm_loadu_ps(x + i))));
+  for (; i < n; i++)
+    dst[i] += a * x[i];
+}
+
+__attribute__((target("sse2"))) void AxpbyFloatSse2(float* dst, float a, const float* x, float b,
+                                                    int n) noexcept {
+  const __m128 va = _mm_set1_ps(a);
+  const __m128 vb = _mm_set1_ps(b);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(va, _mm_loadu_ps(x + i)),
+                                      _mm_mul_ps(vb, _mm_loadu_ps(dst + i))));
+  }
+  for (; i < n; i++)
+    dst[i] = a * x[i] + b * dst[i];
+}
+
+/*
+  AVX2 + FMA (4 doubles per register)
+*/
+
+__attribute__((target("avx2,fma"))) double HorizontalSum(__m256d v) noexcept {
+  __m128d lo = _mm256_castpd256_pd128(v);
+  __m128d hi = _mm256_extractf128_pd(v, 1);
+  lo = _mm_add_pd(lo, hi);
+  return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+__attribute__((target("avx2,fma"))) double DotAvx2(const double* a, const double* b, int n) noexcept {
+  __m256d acc0 = _mm256_setzero_pd();
+  __m256d acc1 = _mm256_setzero_pd();
+  __m256d acc2 = _mm256_setzero_pd();
+  __m256d acc3 = _mm256_setzero_pd();
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+    acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+    acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), acc2);
+    acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), acc3);
+  }
+  for (; i + 4 <= n; i += 4)
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+  double sum = HorizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+  for (; i < n; i++)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+__attribute__((target("avx2,fma"))) double SumOfSquaresAvx2(const double* a, int n) noexcept {
+  return DotAvx2(a, a, n);
+}
+
+__attribute__((target("avx2,fma"))) void AddAvx2(double* dst, const double* a,
+                                                 const double* b, int n) noexcept {
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+  for (; i < n; i++)
+    dst[i] = a[i] + b[i];
+}
+
+__attribute__((target("avx2,fma"))) void SubtractAvx2(double* dst, const double* a,
+                                                      const double* b, int n) noexcept {
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(dst + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+  for (; i < n; i++)
+    dst[i] = a[i] - b[i];
+}
+
+__attribute__((target("avx2,fma"))) void ScaleAvx2(double* dst, const double* a,
+                                                   double d, int n) noexcept {
+  const __m256d vd = _mm256_set1_pd(d);
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(dst + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), vd));
+  for (; i < n; i++)
+    dst[i] = a[i] * d;
+}
+
+__attribute__((target("avx2,fma"))) void DivideAvx2(double* dst, const double* a,
+                                                    double d, int n) noexcept {
+  const __m256d vd = _mm256_set1_pd(d);
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(dst + i, _mm256_div_pd(_mm256_loadu_pd(a + i), vd));
+  for (; i < n; i++)
+    dst[i] = a[i] / d;
+}
+
+__attribute__((target("avx2,fma"))) void AxpyAvx2(double* dst, double a, const double* x,
+                                                 int n) noexcept {
+  const __m256d va = _mm256_set1_pd(a);
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(dst + i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), _mm256_loadu_pd(dst + i)));
+  for (; i < n; i++)
+    dst[i] = std::fma(a, x[i], dst[i]);
+}
+
+__attribute__((target("avx2,fma"))) void AxpbyAvx2(double* dst, double a, const double* x,
+                                                  double b, int n) noexcept {
+  const __m256d va = _mm256_set1_pd(a);
+  const __m256d vb = _mm256_set1_pd(b);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(dst + i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i),
+                                              _mm256_mul_pd(vb, _mm256_loadu_pd(dst + i))));
+  }
+  for (; i < n; i++)
+    dst[i] = std::fma(a, x[i], b * dst[i]);
+}
+
+/*
+  AVX2 + FMA, float (8 floats per register)
+*/
+
+__attribute__((target("avx2,fma"))) float HorizontalSum(__m256 v) noexcept {
+  __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+  return _mm_cvtss_f32(_mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 1)));
+}
+
+__attribute__((target("avx2,fma"))) float DotFloatAvx2(const float* a, const float* b,
+                                                       int n) noexcept {
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  __m256 acc2 = _mm256_setzero_ps();
+  __m256 acc3 = _mm256_setzero_ps();
+  int i = 0;
+  for (; i + 32 <= n; i += 32) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), acc2);
+    acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), acc3);
+  }
+  for (; i + 8 <= n; i += 8)
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+  float sum = HorizontalSum(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+  for (; i < n; i++)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+__attribute__((target("avx2,fma"))) float SumOfSquaresFloatAvx2(const float* a, int n) noexcept {
+  return DotFloatAvx2(a, a, n);
+}
+
+__attribute__((target("avx2,fma"))) double DotFloatInDoubleAvx2(const float* a, const float* b,
+                                                                int n) noexcept {
+  __m256d acc0 = _mm256_setzero_pd();
+  __m256d acc1 = _mm256_setzero_pd();
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)),
+                           _mm256_cvtps_pd(_mm_loadu_ps(b + i)), acc0);
+    acc1 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i + 4)),
+                           _mm256_cvtps_pd(_mm_loadu_ps(b + i + 4)), acc1);
+  }
+  double sum = HorizontalSum(_mm256_add_pd(acc0, acc1));
+  for (; i < n; i++)
+    sum += static_cast<double>(a[i]) * b[i];
+  return sum;
+}
+
+__attribute__((target("avx2,fma"))) double SumOfSquaresFloatInDoubleAvx2(const float* a,
+                                                                         int n) noexcept {
+  return DotFloatInDoubleAvx2(a, a, n);
+}
+
+__attribute__((target("avx2,fma"))) void AddFloatAvx2(float* dst, const float* a,
+                                                      const float* b, int n) noexcept {
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  for (; i < n; i++)
+    dst[i] = a[i] + b[i];
+}
+
+__attribute__((target("avx2,fma"))) void SubtractFloatAvx2(float* dst, const float* a,
+                                                           const float* b, int n) noexcept {
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  for (; i < n; i++)
+    dst[i] = a[i] - b[i];
+}
+
+__attribute__((target("avx2,fma"))) void ScaleFloatAvx2(float* dst, const float* a,
+                                                        float d, int n) noexcept {
+  const __m256 vd = _mm256_set1_ps(d);
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), vd));
+  for (; i < n; i++)
+    dst[i] = a[i] * d;
+}
+
+__attribute__((target("avx2,fma"))) void DivideFloatAvx2(float* dst, const float* a,
+                                                         float d, int n) noexcept {
+  const __m256 vd = _mm256_set1_ps(d);
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_div_ps(_mm256_loadu_ps(a + i), vd));
+  for (; i < n; i++)
+    dst[i] = a[i] / d;
+}
+
+__attribute__((target("avx2,fma"))) void AxpyFloatAvx2(float* dst, float a, const float* x,
+                                                       int n) noexcept {
+  const __m256 va = _mm256_set1_ps(a);
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(dst + i)));
+  for (; i < n; i++)
+    dst[i] = std::fma(a, x[i], dst[i]);
+}
+
+__attribute__((target("avx2,fma"))) void AxpbyFloatAvx2(float* dst, float a, const float* x,
+                                                        float b, int n) noexcept {
+  const __m256 va = _mm256_set1_ps(a);
+  const __m256 vb = _mm256_set1_ps(b);
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i),
+                                              _mm256_mul_ps(vb, _mm256_loadu_ps(dst + i))));
+  }
+  for (; i < n; i++)
+    dst[i] = std::fma(a, x[i], b * dst[i]);
+}
+
+/*
+  AVX-512 (8 doubles per register, tails handled with masked loads and stores)
+*/
+
+__attribute__((target("avx512f"))) __mmask8 TailMask(int remaining) noexcept {
+  return static_cast<__mmask8>((1u << remaining) - 1u);
+}
+
+__attribute__((target("avx512f"))) double DotAvx512(const double* a, const double* b,
+                                                   int n) noexcept {
+  __m512d acc0 = _mm512_setzero_pd();
+  __m512d acc1 = _mm512_setzero_pd();
+  __m512d acc2 = _mm512_setzero_pd();
+  __m512d acc3 = _mm512_setzero_pd();
+  int i = 0;
+  for (; i + 32 <= n; i += 32) {
+    acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+    acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), acc1);
+    acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), acc2);
+    acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), acc3);
+  }
+  for (; i + 8 <= n; i += 8)
+    acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+  if (i < n) {
+    const __mmask8 m = TailMask(n - i);
+    acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i), acc1);
+  }
+  return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+}
+
+__attribute__((target("avx512f"))) double SumOfSquaresAvx512(const double* a, int n) noexcept {
+  return DotAvx512(a, a, n);
+}
+
+__attribute__((target("avx512f"))) void AddAvx512(double* dst, const double* a,
+                                                  const double* b, int n) noexcept {
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(dst + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+  if (i < n) {
+    const __mmask8 m = TailMask(n - i);
+    _mm512_mask_storeu_pd(
+        dst + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void SubtractAvx512(double* dst, const double* a,
+                                                       const double* b, int n) noexcept {
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(dst + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+  if (i < n) {
+    const __mmask8 m = TailMask(n - i);
+    _mm512_mask_storeu_pd(
+        dst + i, m, _mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512(double* dst, const double* a,
+                                                    double d, int n) noexcept {
+  const __m512d vd = _mm512_set1_pd(d);
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(dst + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), vd));
+  if (i < n) {
+    const __mmask8 m = TailMask(n - i);
+    _mm512_mask_storeu_pd(dst + i, m, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, a + i), vd));
+  }
+}
+
+__attribute__((target("avx512f"))) void DivideAvx512(double* dst, const double* a,
+                                                     double d, int n) noexcept {
+  const __m512d vd = _mm512_set1_pd(d);
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(dst + i, _mm512_div_pd(_mm512_loadu_pd(a + i), vd));
+  if (i < n) {
+    const __mmask8 m = TailMask(n - i);
+    _mm512_mask_storeu_pd(dst + i, m, _mm512_div_pd(_mm512_maskz_loadu_pd(m, a + i), vd));
+  }
+}
+
+__attribute__((target("avx512f"))) void AxpyAvx512(double* dst, double a, const double* x,
+                                                  int n) noexcept {
+  const __m512d va = _mm512_set1_pd(a);
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(dst + i, _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i), _mm512_loadu_pd(dst + i)));
+  if (i < n) {
+    const __mmask8 m = TailMask(n - i);
+    _mm512_mask_storeu_pd(
+        dst + i, m,
+        _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(m, x + i), _mm512_maskz_loadu_pd(m, dst + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void AxpbyAvx512(double* dst, double a, const double* x,
+                                                   double b, int n) noexcept {
+  const __m512d va = _mm512_set1_pd(a);
+  const __m512d vb = _mm512_set1_pd(b);
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(dst + i, _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i),
+                                              _mm512_mul_pd(vb, _mm512_loadu_pd(dst + i))));
+  }
+  if (i < n) {
+    const __mmask8 m = TailMask(n - i);
+    _mm512_mask_storeu_pd(dst + i, m,
+                          _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(m, x + i),
+                                          _mm512_mul_pd(vb, _mm512_maskz_loadu_pd(m, dst + i))));
+  }
+}
+
+/*
+  AVX-512, float (16 floats per register)
+*/
+
+__attribute__((target("avx512f"))) __mmask16 TailMask16(int remaining) noexcept {
+  return static_cast<__mmask16>((1u << remaining) - 1u);
+}
+
+__attribute__((target("avx512f"))) float DotFloatAvx512(const float* a, const float* b,
+                                                       int n) noexcept {
+  __m512 acc0 = _mm512_setzero_ps();
+  __m512 acc1 = _mm512_setzero_ps();
+  __m512 acc2 = _mm512_setzero_ps();
+  __m512 acc3 = _mm512_setzero_ps();
+  int i = 0;
+  for (; i + 64 <= n; i += 64) {
+    acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+    acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 32), _mm512_loadu_ps(b + i + 32), acc2);
+    acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 48), _mm512_loadu_ps(b + i + 48), acc3);
+  }
+  for (; i + 16 <= n; i += 16)
+    acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+  if (i < n) {
+    const __mmask16 m = TailMask16(n - i);
+    acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i), acc1);
+  }
+  return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+
+__attribute__((target("avx512f"))) float SumOfSquaresFloatAvx512(const float* a, int n) noexcept {
+  return DotFloatAvx512(a, a, n);
+}
+
+// Eight floats (fewer with a mask), widened to doubles
+__attribute__((target("avx512f"))) __m512d LoadFloatsAsDoubles(const float* a,
+                                                              __mmask16 m) noexcept {
+  return _mm512_cvtps_pd(_mm512_castps512_ps256(_mm512_maskz_loadu_ps(m, a)));
+}
+
+__attribute__((target("avx512f"))) double DotFloatInDoubleAvx512(const float* a, const float* b,
+                                                                int n) noexcept {
+  __m512d acc0 = _mm512_setzero_pd();
+  __m512d acc1 = _mm512_setzero_pd();
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i)),
+                           _mm512_cvtps_pd(_mm256_loadu_ps(b + i)), acc0);
+    acc1 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i + 8)),
+                           _mm512_cvtps_pd(_mm256_loadu_ps(b + i + 8)), acc1);
+  }
+  for (; i < n; i += 8) {
+    const __mmask16 m = TailMask16(n - i < 8 ? n - i : 8);
+    acc0 = _mm512_fmadd_pd(LoadFloatsAsDoubles(a + i, m), LoadFloatsAsDoubles(b + i, m), acc0);
+  }
+  return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+}
+
+__attribute__((target("avx512f"))) double SumOfSquaresFloatInDoubleAvx512(const float* a,
+                                                                          int n) noexcept {
+  return DotFloatInDoubleAvx512(a, a, n);
+}
+
+__attribute__((target("avx512f"))) void AddFloatAvx512(float* dst, const float* a,
+                                                       const float* b, int n) noexcept {
+  int i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_add_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+  if (i < n) {
+    const __mmask16 m = TailMask16(n - i);
+    _mm512_mask_storeu_ps(
+        dst + i, m, _mm512_add_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void SubtractFloatAvx512(float* dst, const float* a,
+                                                            const float* b, int n) noexcept {
+  int i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+  if (i < n) {
+    const __mmask16 m = TailMask16(n - i);
+    _mm512_mask_storeu_ps(
+        dst + i, m, _mm512_sub_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void ScaleFloatAvx512(float* dst, const float* a,
+                                                         float d, int n) noexcept {
+  const __m512 vd = _mm512_set1_ps(d);
+  int i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_loadu_ps(a + i), vd));
+  if (i < n) {
+    const __mmask16 m = TailMask16(n - i);
+    _mm512_mask_storeu_ps(dst + i, m, _mm512_mul_ps(_mm512_maskz_loadu_ps(m, a + i), vd));
+  }
+}
+
+__attribute__((target("avx512f"))) void DivideFloatAvx512(float* dst, const float* a,
+                                                          float d, int n) noexcept {
+  const __m512 vd = _mm512_set1_ps(d);
+  int i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_div_ps(_mm512_loadu_ps(a + i), vd));
+  if (i < n) {
+    const __mmask16 m = TailMask16(n - i);
+    _mm512_mask_storeu_ps(dst + i, m, _mm512_div_ps(_mm512_maskz_loadu_ps(m, a + i), vd));
+  }
+}
+
+__attribute__((target("avx512f"))) void AxpyFloatAvx512(float* dst, float a, const float* x,
+                                                       int n) noexcept {
+  const __m512 va = _mm512_set1_ps(a);
+  int i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i), _mm512_loadu_ps(dst + i)));
+  if (i < n) {
+    const __mmask16 m = TailMask16(n - i);
+    _mm512_mask_storeu_ps(
+        dst + i, m,
+        _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(m, x + i), _mm512_maskz_loadu_ps(m, dst + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void AxpbyFloatAvx512(float* dst, float a, const float* x,
+                                                        float b, int n) noexcept {
+  const __m512 va = _mm512_set1_ps(a);
+  const __m512 vb = _mm512_set1_ps(b);
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    _mm512_storeu_ps(dst + i, _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i),
+                                              _mm512_mul_ps(vb, _mm512_loadu_ps(dst + i))));
+  }
+  if (i < n) {
+    const __mmask16 m = TailMask16(n - i);
+    _mm512_mask_storeu_ps(dst + i, m,
+                          _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(m, x + i),
+                                          _mm512_mul_ps(vb, _mm512_maskz_loadu_ps(m, dst + i))));
+  }
+}
+
+/*
+  int8 codes
+    SSE2 sign-extends to 16 bits and uses pmaddwd. AVX2 uses pmaddubsw, which multiplies
+    unsigned by signed bytes: |a| times b with the sign of a gives the same products, and with
+    codes in [-127, 127] the pairwise sums (at most 2 * 127 * 127) never saturate. AVX-512 VNNI
+    does the same with vpdpbusd, which also accumulates into 32 bits in one instruction.
+*/
+
+__attribute__((target("sse2"))) std::int32_t DotInt8Sse2(const std::int8_t* a,
+                                                         const std::int8_t* b,
+                                                         int n) noexcept {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i acc = _mm_setzero_si128();
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    const __m128i signA = _mm_cmpgt_epi8(zero, va);
+    const __m128i signB = _mm_cmpgt_epi8(zero, vb);
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(va, signA),
+                                            _mm_unpacklo_epi8(vb, signB)));
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi8(va, signA),
+                                            _mm_unpackhi_epi8(vb, signB)));
+  }
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+  std::int32_t sum = _mm_cvtsi128_si32(acc);
+  for (; i < n; i++)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+__attribute__((target("avx2"))) std::int32_t DotInt8Avx2(const std::int8_t* a,
+                                                         const std::int8_t* b,
+                                                         int n) noexcept {
+  const __m256i ones = _mm256_set1_epi16(1);
+  __m256i acc = _mm256_setzero_si256();
+  int i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    const __m256i pairs =
+        _mm256_maddubs_epi16(_mm256_sign_epi8(va, va), _mm256_sign_epi8(vb, va));
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, ones));
+  }
+  __m128i sum4 = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+  sum4 = _mm_add_epi32(sum4, _mm_shuffle_epi32(sum4, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum4 = _mm_add_epi32(sum4, _mm_shuffle_epi32(sum4, _MM_SHUFFLE(2, 3, 0, 1)));
+  std::int32_t sum = _mm_cvtsi128_si32(sum4);
+  for (; i < n; i++)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vnni"))) std::int32_t DotInt8Avx512Vnni(
+    const std::int8_t* a,
+    const std::int8_t* b,
+    int n) noexcept {
+  const __m512i zero = _mm512_setzero_si512();
+  __m512i acc = _mm512_setzero_si512();
+  int i = 0;
+  for (; i + 64 <= n; i += 64) {
+    const __m512i va = _mm512_loadu_si512(a + i);
+    const __m512i vb = _mm512_loadu_si512(b + i);
+    const __m512i signedB = _mm512_mask_sub_epi8(vb, _mm512_movepi8_mask(va), zero, vb);
+    acc = _mm512_dpbusd_epi32(acc, _mm512_abs_epi8(va), signedB);
+  }
+  if (i < n) {
+    const __mmask64 m = ~std::uint64_t{0} >> (64 - (n - i));
+    const __m512i va = _mm512_maskz_loadu_epi8(m, a + i);
+    const __m512i vb = _mm512_maskz_loadu_epi8(m, b + i);
+    const __m512i signedB = _mm512_mask_sub_epi8(vb, _mm512_movepi8_mask(va), zero, vb);
+    acc = _mm512_dpbusd_epi32(acc, _mm512_abs_epi8(va), signedB);
+  }
+  return _mm512_reduce_add_epi32(acc);
+}
+
+/*
+  Sparse (gather and scatter)
+    SSE2 has neither, so it uses the scalar kernels. AVX2 gathers 4 dense magnitudes at a time.
+    AVX-512 gathers 8 and also scatters them back for the axpy; the indices of a sparse vector
+    are distinct, so the lanes of a scatter never conflict.
+*/
+
+__attribute__((target("avx2,fma"))) double SparseDotAvx2(const int* indices,
+                                                         const double* values,
+                                                         int nnz,
+                                                         const double* dense) noexcept {
+  __m256d acc0 = _mm256_setzero_pd();
+  __m256d acc1 = _mm256_setzero_pd();
+  int k = 0;
+  for (; k + 8 <= nnz; k += 8) {
+    const __m128i index0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + k));
+    const __m128i index1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + k + 4));
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(values + k), _mm256_i32gather_pd(dense, index0, 8),
+                           acc0);
+    acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(values + k + 4),
+                           _mm256_i32gather_pd(dense, index1, 8), acc1);
+  }
+  double sum = HorizontalSum(_mm256_add_pd(acc0, acc1));
+  for (; k < nnz; k++)
+    sum += values[k] * dense[indices[k]];
+  return sum;
+}
+
+__attribute__((target("avx512f"))) double SparseDotAvx512(const int* indices,
+                                                          const double* values,
+                                                          int nnz,
+                                                          const double* dense) noexcept {
+  __m512d acc0 = _mm512_setzero_pd();
+  __m512d acc1 = _mm512_setzero_pd();
+  int k = 0;
+  for (; k + 16 <= nnz; k += 16) {
+    const __m256i index0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + k));
+    const __m256i index1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + k + 8));
+    acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(values + k), _mm512_i32gather_pd(index0, dense, 8),
+                           acc0);
+    acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(values + k + 8),
+                           _mm512_i32gather_pd(index1, dense, 8), acc1);
+  }
+  double sum = _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+  for (; k < nnz; k++)
+    sum += values[k] * dense[indices[k]];
+  return sum;
+}
+
+__attribute__((target("avx512f"))) void SparseAxpyAvx512(double* dense,
+                                                         double a,
+                                                         const int* indices,
+                                                         const double* values,
+                                                         int nnz) noexcept {
+  const __m512d va = _mm512_set1_pd(a);
+  int k = 0;
+  for (; k + 8 <= nnz; k += 8) {
+    const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + k));
+    const __m512d updated = _mm512_fmadd_pd(va, _mm512_loadu_pd(values + k),
+                                            _mm512_i32gather_pd(index, dense, 8));
+    _mm512_i32scatter_pd(dense, index, updated, 8);
+  }
+  for (; k < nnz; k++)
+    dense[indices[k]] += a * values[k];
+}
+
+/*
+  One vector against four (blocked search)
+    x is loaded once per step and multiplied with the same step of four other vectors, so a
+    block of database vectors is read from memory once per four queries.
+*/
+
+__attribute__((target("sse2"))) void Dot4Sse2(const double* x,
+                                              const double* const* queries,
+                                              int n,
+                                              double* out) noexcept {
+  const double* q0 = queries[0];
+  const double* q1 = queries[1];
+  const double* q2 = queries[2];
+  const double* q3 = queries[3];
+  __m128d acc0 = _mm_setzero_pd();
+  __m128d acc1 = _mm_setzero_pd();
+  __m128d acc2 = _mm_setzero_pd();
+  __m128d acc3 = _mm_setzero_pd();
+  int i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const __m128d vx = _mm_loadu_pd(x + i);
+    acc0 = _mm_add_pd(acc0, _mm_mul_pd(vx, _mm_loadu_pd(q0 + i)));
+    acc1 = _mm_add_pd(acc1, _mm_mul_pd(vx, _mm_loadu_pd(q1 + i)));
+    acc2 = _mm_add_pd(acc2, _mm_mul_pd(vx, _mm_loadu_pd(q2 + i)));
+    acc3 = _mm_add_pd(acc3, _mm_mul_pd(vx, _mm_loadu_pd(q3 + i)));
+  }
+  out[0] = HorizontalSum(acc0);
+  out[1] = HorizontalSum(acc1);
+  out[2] = HorizontalSum(acc2);
+  out[3] = HorizontalSum(acc3);
+  for (; i < n; i++) {
+    out[0] += x[i] * q0[i];
+    out[1] += x[i] * q1[i];
+    out[2] += x[i] * q2[i];
+    out[3] += x[i] * q3[i];
+  }
+}
+
+__attribute__((target("avx2,fma"))) void Dot4Avx2(const double* x,
+                                                  const double* const* queries,
+                                                  int n,
+                                                  double* out) noexcept {
+  const double* q0 = queries[0];
+  const double* q1 = queries[1];
+  const double* q2 = queries[2];
+  const double* q3 = queries[3];
+  __m256d acc0 = _mm256_setzero_pd();
+  __m256d acc1 = _mm256_setzero_pd();
+  __m256d acc2 = _mm256_setzero_pd();
+  __m256d acc3 = _mm256_setzero_pd();
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d vx = _mm256_loadu_pd(x + i);
+    acc0 = _mm256_fmadd_pd(vx, _mm256_loadu_pd(q0 + i), acc0);
+    acc1 = _mm256_fmadd_pd(vx, _mm256_loadu_pd(q1 + i), acc1);
+    acc2 = _mm256_fmadd_pd(vx, _mm256_loadu_pd(q2 + i), acc2);
+    acc3 = _mm256_fmadd_pd(vx, _mm256_loadu_pd(q3 + i), acc3);
+  }
+  out[0] = HorizontalSum(acc0);
+  out[1] = HorizontalSum(acc1);
+  out[2] = HorizontalSum(acc2);
+  out[3] = HorizontalSum(acc3);
+  for (; i < n; i++) {
+    out[0] += x[i] * q0[i];
+    out[1] += x[i] * q1[i];
+    out[2] += x[i] * q2[i];
+    out[3] += x[i] * q3[i];
+  }
+}
+
+__attribute__((target("avx512f"))) void Dot4Avx512(const double* x,
+                                                   const double* const* queries,
+                                                   int n,
+                                                   double* out) noexcept {
+  const double* q0 = queries[0];
+  const double* q1 = queries[1];
+  const double* q2 = queries[2];
+  const double* q3 = queries[3];
+  __m512d acc0 = _mm512_setzero_pd();
+  __m512d acc1 = _mm512_setzero_pd();
+  __m512d acc2 = _mm512_setzero_pd();
+  __m512d acc3 = _mm512_setzero_pd();
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m512d vx = _mm512_loadu_pd(x + i);
+    acc0 = _mm512_fmadd_pd(vx, _mm512_loadu_pd(q0 + i), acc0);
+    acc1 = _mm512_fmadd_pd(vx, _mm512_loadu_pd(q1 + i), acc1);
+    acc2 = _mm512_fmadd_pd(vx, _mm512_loadu_pd(q2 + i), acc2);
+    acc3 = _mm512_fmadd_pd(vx, _mm512_loadu_pd(q3 + i), acc3);
+  }
+  if (i < n) {
+    const __mmask8 m = TailMask(n - i);
+    const __m512d vx = _mm512_maskz_loadu_pd(m, x + i);
+    acc0 = _mm512_fmadd_pd(vx, _mm512_maskz_loadu_pd(m, q0 + i), acc0);
+    acc1 = _mm512_fmadd_pd(vx, _mm512_maskz_loadu_pd(m, q1 + i), acc1);
+    acc2 = _mm512_fmadd_pd(vx, _mm512_maskz_loadu_pd(m, q2 + i), acc2);
+    acc3 = _mm512_fmadd_pd(vx, _mm512_maskz_loadu_pd(m, q3 + i), acc3);
+  }
+  out[0] = _mm512_reduce_add_pd(acc0);
+  out[1] = _mm512_reduce_add_pd(acc1);
+  out[2] = _mm512_reduce_add_pd(acc2);
+  out[3] = _mm512_reduce_add_pd(acc3);
+}
+
+/*
+  Panel against panel (pairwise distances)
+    Each step loads the magnitudes of the b vectors into registers once and multiplies them
+    with the broadcast magnitude of each a vector, so a block of kPanelVectors x kPanelVectors
+    sums stays in registers for the whole product. AVX2 and SSE2 have too few registers for all
+    64 sums and make two and four passes over b, a few rows of sums at a time.
+*/
+
+__attribute__((target("sse2"))) void DotPanelSse2(const double* a,
+                                                  const double* b,
+                                                  int n,
+                                                  double* out,
+                                                  int outStride) noexcept {
+  for (int r = 0; r < kPanelVectors; r += 2) {
+    __m128d acc00 = _mm_setzero_pd();
+    __m128d acc01 = _mm_setzero_pd();
+    __m128d acc02 = _mm_setzero_pd();
+    __m128d acc03 = _mm_setzero_pd();
+    __m128d acc10 = _mm_setzero_pd();
+    __m128d acc11 = _mm_setzero_pd();
+    __m128d acc12 = _mm_setzero_pd();
+    __m128d acc13 = _mm_setzero_pd();
+    for (int i = 0; i < n; i++) {
+      const double* bi = b + i * kPanelVectors;
+      const __m128d b0 = _mm_loadu_pd(bi);
+      const __m128d b1 = _mm_loadu_pd(bi + 2);
+      const __m128d b2 = _mm_loadu_pd(bi + 4);
+      const __m128d b3 = _mm_loadu_pd(bi + 6);
+      const __m128d a0 = _mm_set1_pd(a[i * kPanelVectors + r]);
+      const __m128d a1 = _mm_set1_pd(a[i * kPanelVectors + r + 1]);
+      acc00 = _mm_add_pd(acc00, _mm_mul_pd(a0, b0));
+      acc01 = _mm_add_pd(acc01, _mm_mul_pd(a0, b1));
+      acc02 = _mm_add_pd(acc02, _mm_mul_pd(a0, b2));
+      acc03 = _mm_add_pd(acc03, _mm_mul_pd(a0, b3));
+      acc10 = _mm_add_pd(acc10, _mm_mul_pd(a1, b0));
+      acc11 = _mm_add_pd(acc11, _mm_mul_pd(a1, b1));
+      acc12 = _mm_add_pd(acc12, _mm_mul_pd(a1, b2));
+      acc13 = _mm_add_pd(acc13, _mm_mul_pd(a1, b3));
+    }
+    double* row0 = out + r * outStride;
+    double* row1 = row0 + outStride;
+    _mm_storeu_pd(row0, _mm_add_pd(_mm_loadu_pd(row0), acc00));
+    _mm_storeu_pd(row0 + 2, _mm_add_pd(_mm_loadu_pd(row0 + 2), acc01));
+    _mm_storeu_pd(row0 + 4, _mm_add_pd(_mm_loadu_pd(row0 + 4), acc02));
+    _mm_storeu_pd(row0 + 6, _mm_add_pd(_mm_loadu_pd(row0 + 6), acc03));
+    _mm_storeu_pd(row1, _mm_add_pd(_mm_loadu_pd(row1), acc10));
+    _mm_storeu_pd(row1 + 2, _mm_add_pd(_mm_loadu_pd(row1 + 2), acc11));
+    _mm_storeu_pd(row1 + 4, _mm_add_pd(_mm_loadu_pd(row1 + 4), acc12));
+    _mm_storeu_pd(row1 + 6, _mm_add_pd(_mm_loadu_pd(row1 + 6), acc13));
+  }
+}
+
+__attribute__((target("avx2,fma"))) void DotPanelAvx2(const double* a,
+                                                      const double* b,
+                                                      int n,
+                                                      double* out,
+                                                      int outStride) noexcept {
+  for (int r = 0; r < kPanelVectors; r += 4) {
+    __m256d acc00 = _mm256_setzero_pd();
+    __m256d acc01 = _mm256_setzero_pd();
+    __m256d acc10 = _mm256_setzero_pd();
+    __m256d acc11 = _mm256_setzero_pd();
+    __m256d acc20 = _mm256_setzero_pd();
+    __m256d acc21 = _mm256_setzero_pd();
+    __m256d acc30 = _mm256_setzero_pd();
+    __m256d acc31 = _mm256_setzero_pd();
+    for (int i = 0; i < n; i++) {
+      const double* ai = a + i * kPanelVectors + r;
+      const __m256d b0 = _mm256_loadu_pd(b + i * kPanelVectors);
+      const __m256d b1 = _mm256_loadu_pd(b + i * kPanelVectors + 4);
+      const __m256d a0 = _mm256_broadcast_sd(ai);
+      acc00 = _mm256_fmadd_pd(a0, b0, acc00);
+      acc01 = _mm256_fmadd_pd(a0, b1, acc01);
+      const __m256d a1 = _mm256_broadcast_sd(ai + 1);
+      acc10 = _mm256_fmadd_pd(a1, b0, acc10);
+      acc11 = _mm256_fmadd_pd(a1, b1, acc11);
+      const __m256d a2 = _mm256_broadcast_sd(ai + 2);
+      acc20 = _mm256_fmadd_pd(a2, b0, acc20);
+      acc21 = _mm256_fmadd_pd(a2, b1, acc21);
+      const __m256d a3 = _mm256_broadcast_sd(ai + 3);
+      acc30 = _mm256_fmadd_pd(a3, b0, acc30);
+      acc31 = _mm256_fmadd_pd(a3, b1, acc31);
+    }
+    double* row0 = out + r * outStride;
+    double* row1 = row0 + outStride;
+    double* row2 = row1 + outStride;
+    double* row3 = row2 + outStride;
+    _mm256_storeu_pd(row0, _mm256_add_pd(_mm256_loadu_pd(row0), acc00));
+    _mm256_storeu_pd(row0 + 4, _mm256_add_pd(_mm256_loadu_pd(row0 + 4), acc01));
+    _mm256_storeu_pd(row1, _mm256_add_pd(_mm256_loadu_pd(row1), acc10));
+    _mm256_storeu_pd(row1 + 4, _mm256_add_pd(_mm256_loadu_pd(row1 + 4), acc11));
+    _mm256_storeu_pd(row2, _mm256_add_pd(_mm256_loadu_pd(row2), acc20));
+    _mm256_storeu_pd(row2 + 4, _mm256_add_pd(_mm256_loadu_pd(row2 + 4), acc21));
+    _mm256_storeu_pd(row3, _mm256_add_pd(_mm256_loadu_pd(row3), acc30));
+    _mm256_storeu_pd(row3 + 4, _mm256_add_pd(_mm256_loadu_pd(row3 + 4), acc31));
+  }
+}
+
+__attribute__((target("avx512f"))) void DotPanelAvx512(const double* a,
+                                                       const double* b,
+                                                       int n,
+                                                       double* out,
+                                                       int outStride) noexcept {
+  __m512d acc0 = _mm512_setzero_pd();
+  __m512d acc1 = _mm512_setzero_pd();
+  __m512d acc2 = _mm512_setzero_pd();
+  __m512d acc3 = _mm512_setzero_pd();
+  __m512d acc4 = _mm512_setzero_pd();
+  __m512d acc5 = _mm512_setzero_pd();
+  __m512d acc6 = _mm512_setzero_pd();
+  __m512d acc7 = _mm512_setzero_pd();
+  for (int i = 0; i < n; i++) {
+    const double* ai = a + i * kPanelVectors;
+    const __m512d bi = _mm512_loadu_pd(b + i * kPanelVectors);
+    acc0 = _mm512_fmadd_pd(_mm512_set1_pd(ai[0]), bi, acc0);
+    acc1 = _mm512_fmadd_pd(_mm512_set1_pd(ai[1]), bi, acc1);
+    acc2 = _mm512_fmadd_pd(_mm512_set1_pd(ai[2]), bi, acc2);
+    acc3 = _mm512_fmadd_pd(_mm512_set1_pd(ai[3]), bi, acc3);
+    acc4 = _mm512_fmadd_pd(_mm512_set1_pd(ai[4]), bi, acc4);
+    acc5 = _mm512_fmadd_pd(_mm512_set1_pd(ai[5]), bi, acc5);
+    acc6 = _mm512_fmadd_pd(_mm512_set1_pd(ai[6]), bi, acc6);
+    acc7 = _mm512_fmadd_pd(_mm512_set1_pd(ai[7]), bi, acc7);
+  }
+  const __m512d sums[kPanelVectors] = {acc0, acc1, acc2, acc3, acc4, acc5, acc6, acc7};
+  for (int r = 0; r < kPanelVectors; r++) {
+    double* row = out + r * outStride;
+    _mm512_storeu_pd(row, _mm512_add_pd(_mm512_loadu_pd(row), sums[r]));
+  }
+}
+
+/*
+  Welford update (streaming mean and variance)
+    Every element is independent, so each lane performs exactly the operations of the scalar
+    loop and every version gives bit-identical results. GCC would otherwise contract the
+    separate multiply and add into a fused multiply-add in the AVX2 and AVX-512 versions.
+    _mm_min_pd(x, min) picks min unless x < min, like std::min(min, x), and likewise for max.
+*/
+
+__attribute__((target("sse2"))) void WelfordUpdateSse2(const double* x,
+                                                       double inverseCount,
+                                                       int n,
+                                                       double* mean,
+                                                       double* m2,
+                                                       double* min,
+                                                       double* max) noexcept {
+  const __m128d vinverse = _mm_set1_pd(inverseCount);
+  int i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const __m128d vx = _mm_loadu_pd(x + i);
+    const __m128d delta = _mm_sub_pd(vx, _mm_loadu_pd(mean + i));
+    const __m128d vmean = _mm_add_pd(_mm_loadu_pd(mean + i), _mm_mul_pd(delta, vinverse));
+    _mm_storeu_pd(mean + i, vmean);
+    _mm_storeu_pd(m2 + i,
+                  _mm_add_pd(_mm_loadu_pd(m2 + i), _mm_mul_pd(delta, _mm_sub_pd(vx, vmean))));
+    _mm_storeu_pd(min + i, _mm_min_pd(vx, _mm_loadu_pd(min + i)));
+    _mm_storeu_pd(max + i, _mm_max_pd(vx, _mm_loadu_pd(max + i)));
+  }
+  WelfordUpdateScalar(x + i, inverseCount, n - i, mean + i, m2 + i, min + i, max + i);
+}
+
+__attribute__((target("avx2,fma"), optimize("fp-contract=off"))) void WelfordUpdateAvx2(
+    const double* x,
+    double inverseCount,
+    int n,
+    double* mean,
+    double* m2,
+    double* min,
+    double* max) noexcept {
+  const __m256d vinverse = _mm256_set1_pd(inverseCount);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d vx = _mm256_loadu_pd(x + i);
+    const __m256d delta = _mm256_sub_pd(vx, _mm256_loadu_pd(mean + i));
+    const __m256d vmean =
+        _mm256_add_pd(_mm256_loadu_pd(mean + i), _mm256_mul_pd(delta, vinverse));
+    _mm256_storeu_pd(mean + i, vmean);
+    _mm256_storeu_pd(m2 + i, _mm256_add_pd(_mm256_loadu_pd(m2 + i),
+                                           _mm256_mul_pd(delta, _mm256_sub_pd(vx, vmean))));
+    _mm256_storeu_pd(min + i, _mm256_min_pd(vx, _mm256_loadu_pd(min + i)));
+    _mm256_storeu_pd(max + i, _mm256_max_pd(vx, _mm256_loadu_pd(max + i)));
+  }
+  WelfordUpdateScalar(x + i, inverseCount, n - i, mean + i, m2 + i, min + i, max + i);
+}
+
+__attribute__((target("avx512f"), optimize("fp-contract=off"))) void WelfordUpdateAvx512(
+    const double* x,
+    double inverseCount,
+    int n,
+    double* mean,
+    double* m2,
+    double* min,
+    double* max) noexcept {
+  const __m512d vinverse = _mm512_set1_pd(inverseCount);
+  for (int i = 0; i < n; i += 8) {
+    const __mmask8 m = i + 8 <= n ? static_cast<__mmask8>(0xFF) : TailMask(n - i);
+    const __m512d vx = _mm512_maskz_loadu_pd(m, x + i);
+    const __m512d delta = _mm512_sub_pd(vx, _mm512_maskz_loadu_pd(m, mean + i));
+    const __m512d vmean =
+        _mm512_add_pd(_mm512_maskz_loadu_pd(m, mean + i), _mm512_mul_pd(delta, vinverse));
+    _mm512_mask_storeu_pd(mean + i, m, vmean);
+    _mm512_mask_storeu_pd(m2 + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, m2 + i),
+                                                   _mm512_mul_pd(delta, _mm512_sub_pd(vx, vmean))));
+    _mm512_mask_storeu_pd(min + i, m, _mm512_min_pd(vx, _mm512_maskz_loadu_pd(m, min + i)));
+    _mm512_mask_storeu_pd(max + i, m, _mm512_max_pd(vx, _mm512_maskz_loadu_pd(m, max + i)));
+  }
+}
+
+/*
+  Accuracy policies (compensated dot product, overflow-safe norm)
+    DotCompensated is Dot2 of Ogita, Rump and Oishi: each product is split exactly into p + e
+    with a fused multiply-add, each addition into s + t with TwoSum, and the errors e and t are
+    added up separately. Each lane keeps its own (s, c), merged with TwoSum at the end, so the
+    result is as accurate as a dot product computed in twice the precision. SSE2 has no
+    fused multiply-add and uses the scalar version. Contraction is turned off, as a contracted
+    s + a * b would no longer match the p that the error e belongs to.
+    MaxAbs and ScaledDot are the two passes of the scaled norm (see Accuracy::kScaled).
+*/
+
+__attribute__((target("sse2"))) double MaxAbsSse2(const double* a, int n) noexcept {
+  const __m128d sign = _mm_set1_pd(-0.0);
+  __m128d m = _mm_setzero_pd();
+  int i = 0;
+  for (; i + 2 <= n; i += 2)
+    m = _mm_max_pd(m, _mm_andnot_pd(sign, _mm_loadu_pd(a + i)));
+  double result = std::max(_mm_cvtsd_f64(m), _mm_cvtsd_f64(_mm_unpackhi_pd(m, m)));
+  for (; i < n; i++)
+    result = std::max(result, std::abs(a[i]));
+  return result;
+}
+
+__attribute__((target("sse2"))) double ScaledDotSse2(const double* a, double sa, const double* b,
+                                                     double sb, int n) noexcept {
+  const __m128d vsa = _mm_set1_pd(sa);
+  const __m128d vsb = _mm_set1_pd(sb);
+  __m128d acc0 = _mm_setzero_pd();
+  __m128d acc1 = _mm_setzero_pd();
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_mul_pd(_mm_loadu_pd(a + i), vsa),
+                                       _mm_mul_pd(_mm_loadu_pd(b + i), vsb)));
+    acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_mul_pd(_mm_loadu_pd(a + i + 2), vsa),
+                                       _mm_mul_pd(_mm_loadu_pd(b + i + 2), vsb)));
+  }
+  double sum = HorizontalSum(_mm_add_pd(acc0, acc1));
+  for (; i < n; i++)
+    sum += (a[i] * sa) * (b[i] * sb);
+  return sum;
+}
+
+__attribute__((target("avx2,fma"))) void TwoSumAvx2(__m256d a, __m256d b, __m256d& s,
+                                                   __m256d& t) noexcept {
+  s = _mm256_add_pd(a, b);
+  const __m256d z = _mm256_sub_pd(s, a);
+  t = _mm256_add_pd(_mm256_sub_pd(a, _mm256_sub_pd(s, z)), _mm256_sub_pd(b, z));
+}
+
+// Merges the lanes of (s, c) into the caller's running sum
+__attribute__((target("avx2,fma"))) void MergeCompensatedAvx2(__m256d s, __m256d c,
+                                                             double* sum,
+                                                             double* compensation) noexcept {
+  double lanes[4];
+  _mm256_storeu_pd(lanes, s);
+  for (double lane : lanes)
+    MergeCompensated(lane, 0.0, sum, compensation);
+  *compensation += HorizontalSum(c);
+}
+
+__attribute__((target("avx2,fma"), optimize("fp-contract=off"))) void DotCompensatedAvx2(
+    const double* a,
+    const double* b,
+    int n,
+    double* sum,
+    double* compensation) noexcept {
+  __m256d s0 = _mm256_setzero_pd();
+  __m256d s1 = _mm256_setzero_pd();
+  __m256d c0 = _mm256_setzero_pd();
+  __m256d c1 = _mm256_setzero_pd();
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256d a0 = _mm256_loadu_pd(a + i);
+    const __m256d b0 = _mm256_loadu_pd(b + i);
+    const __m256d a1 = _mm256_loadu_pd(a + i + 4);
+    const __m256d b1 = _mm256_loadu_pd(b + i + 4);
+    const __m256d p0 = _mm256_mul_pd(a0, b0);
+    const __m256d p1 = _mm256_mul_pd(a1, b1);
+    const __m256d e0 = _mm256_fmsub_pd(a0, b0, p0);
+    const __m256d e1 = _mm256_fmsub_pd(a1, b1, p1);
+    __m256d t0;
+    __m256d t1;
+    TwoSumAvx2(s0, p0, s0, t0);
+    TwoSumAvx2(s1, p1, s1, t1);
+    c0 = _mm256_add_pd(c0, _mm256_add_pd(t0, e0));
+    c1 = _mm256_add_pd(c1, _mm256_add_pd(t1, e1));
+  }
+  MergeCompensatedAvx2(s0, c0, sum, compensation);
+  MergeCompensatedAvx2(s1, c1, sum, compensation);
+  DotCompensatedScalar(a + i, b + i, n - i, sum, compensation);
+}
+
+__attribute__((target("avx2,fma"))) double MaxAbsAvx2(const double* a, int n) noexcept {
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  __m256d m = _mm256_setzero_pd();
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    m = _mm256_max_pd(m, _mm256_andnot_pd(sign, _mm256_loadu_pd(a + i)));
+  __m128d half = _mm_max_pd(_mm256_castpd256_pd128(m), _mm256_extractf128_pd(m, 1));
+  double result = std::max(_mm_cvtsd_f64(half), _mm_cvtsd_f64(_mm_unpackhi_pd(half, half)));
+  for (; i < n; i++)
+    result = std::max(result, std::abs(a[i]));
+  return result;
+}
+
+__attribute__((target("avx2,fma"))) double ScaledDotAvx2(const double* a, double sa,
+                                                         const double* b, double sb,
+                                                         int n) noexcept {
+  const __m256d vsa = _mm256_set1_pd(sa);
+  const __m256d vsb = _mm256_set1_pd(sb);
+  __m256d acc0 = _mm256_setzero_pd();
+  __m256d acc1 = _mm256_setzero_pd();
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_fmadd_pd(_mm256_mul_pd(_mm256_loadu_pd(a + i), vsa),
+                           _mm256_mul_pd(_mm256_loadu_pd(b + i), vsb), acc0);
+    acc1 = _mm256_fmadd_pd(_mm256_mul_pd(_mm256_loadu_pd(a + i + 4), vsa),
+                           _mm256_mul_pd(_mm256_loadu_pd(b + i + 4), vsb), acc1);
+  }
+  double sum = HorizontalSum(_mm256_add_pd(acc0, acc1));
+  for (; i < n; i++)
+    sum = std::fma(a[i] * sa, b[i] * sb, sum);
+  return sum;
+}
+
+__attribute__((target("avx512f"))) void TwoSumAvx512(__m512d a, __m512d b, __m512d& s,
+                                                     __m512d& t) noexcept {
+  s = _mm512_add_pd(a, b);
+  const __m512d z = _mm512_sub_pd(s, a);
+  t = _mm512_add_pd(_mm512_sub_pd(a, _mm512_sub_pd(s, z)), _mm512_sub_pd(b, z));
+}
+
+__attribute__((target("avx512f"), optimize("fp-contract=off"))) void DotCompensatedAvx512(
+    const double* a,
+    const double* b,
+    int n,
+    double* sum,
+    double* compensation) noexcept {
+  __m512d s0 = _mm512_setzero_pd();
+  __m512d s1 = _mm512_setzero_pd();
+  __m512d c0 = _mm512_setzero_pd();
+  __m512d c1 = _mm512_setzero_pd();
+  // Masked-off elements load as 0.0 and add nothing
+  for (int i = 0; i < n; i += 16) {
+    const __mmask8 m0 = i + 8 <= n ? static_cast<__mmask8>(0xFF) : TailMask(n - i);
+    const __mmask8 m1 = i + 16 <= n ? static_cast<__mmask8>(0xFF)
+                                    : i + 8 < n ? TailMask(n - i - 8) : static_cast<__mmask8>(0);
+    const __m512d a0 = _mm512_maskz_loadu_pd(m0, a + i);
+    const __m512d b0 = _mm512_maskz_loadu_pd(m0, b + i);
+    const __m512d a1 = _mm512_maskz_loadu_pd(m1, a + i + 8);
+    const __m512d b1 = _mm512_maskz_loadu_pd(m1, b + i + 8);
+    const __m512d p0 = _mm512_mul_pd(a0, b0);
+    const __m512d p1 = _mm512_mul_pd(a1, b1);
+    const __m512d e0 = _mm512_fmsub_pd(a0, b0, p0);
+    const __m512d e1 = _mm512_fmsub_pd(a1, b1, p1);
+    __m512d t0;
+    __m512d t1;
+    TwoSumAvx512(s0, p0, s0, t0);
+    TwoSumAvx512(s1, p1, s1, t1);
+    c0 = _mm512_add_pd(c0, _mm512_add_pd(t0, e0));
+    c1 = _mm512_add_pd(c1, _mm512_add_pd(t1, e1));
+  }
+  double lanes[16];
+  _mm512_storeu_pd(lanes, s0);
+  _mm512_storeu_pd(lanes + 8, s1);
+  for (double lane : lanes)
+    MergeCompensated(lane, 0.0, sum, compensation);
+  *compensation += _mm512_reduce_add_pd(_mm512_add_pd(c0, c1));
+}
+
+__attribute__((target("avx512f"))) double MaxAbsAvx512(const double* a, int n) noexcept {
+  __m512d m = _mm512_setzero_pd();
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    m = _mm512_max_pd(m, _mm512_abs_pd(_mm512_loadu_pd(a + i)));
+  if (i < n)
+    m = _mm512_max_pd(m, _mm512_abs_pd(_mm512_maskz_loadu_pd(TailMask(n - i), a + i)));
+  return _mm512_reduce_max_pd(m);
+}
+
+__attribute__((target("avx512f"))) double ScaledDotAvx512(const double* a, double sa,
+                                                          const double* b, double sb,
+                                                          int n) noexcept {
+  const __m512d vsa = _mm512_set1_pd(sa);
+  const __m512d vsb = _mm512_set1_pd(sb);
+  __m512d acc0 = _mm512_setzero_pd();
+  __m512d acc1 = _mm512_setzero_pd();
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm512_fmadd_pd(_mm512_mul_pd(_mm512_loadu_pd(a + i), vsa),
+                           _mm512_mul_pd(_mm512_loadu_pd(b + i), vsb), acc0);
+    acc1 = _mm512_fmadd_pd(_mm512_mul_pd(_mm512_loadu_pd(a + i + 8), vsa),
+                           _mm512_mul_pd(_mm512_loadu_pd(b + i + 8), vsb), acc1);
+  }
+  for (; i < n; i += 8) {
+    const __mmask8 m = i + 8 <= n ? static_cast<__mmask8>(0xFF) : TailMask(n - i);
+    acc0 = _mm512_fmadd_pd(_mm512_mul_pd(_mm512_maskz_loadu_pd(m, a + i), vsa),
+                           _mm512_mul_pd(_mm512_maskz_loadu_pd(m, b + i), vsb), acc0);
+  }
+  return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+}
+
+#endif  // EV_KERNELS_X86
+
+const Kernels kScalarKernels{
+    Isa::kScalar,
+    DotScalar, SumOfSquaresScalar, AddScalar, SubtractScalar, ScaleScalar, DivideScalar,
+    AxpyScalar, AxpbyScalar,
+    DotFloatScalar, SumOfSquaresFloatScalar, DotFloatInDoubleScalar,
+    SumOfSquaresFloatInDoubleScalar, AddFloatScalar, SubtractFloatScalar, ScaleFloatScalar,
+    DivideFloatScalar, AxpyFloatScalar, AxpbyFloatScalar,
+    DotInt8Scalar, SparseDotScalar, SparseAxpyScalar, Dot4Scalar,
+    DotPanelScalar, WelfordUpdateScalar, DotCompensatedScalar, MaxAbsScalar, ScaledDotScalar};
+
+#ifdef EV_KERNELS_X86
+const Kernels kSse2Kernels{
+    Isa::kSse2,
+    DotSse2, SumOfSquaresSse2, AddSse2, SubtractSse2, ScaleSse2, DivideSse2, AxpySse2, AxpbySse2,
+    DotFloatSse2, SumOfSquaresFloatSse2, DotFloatInDoubleSse2, SumOfSquaresFloatInDoubleSse2,
+    AddFloatSse2, SubtractFloatSse2, ScaleFloatSse2, DivideFloatSse2, AxpyFloatSse2,
+    AxpbyFloatSse2,
+    DotInt8Sse2, SparseDotScalar, SparseAxpyScalar, Dot4Sse2, DotPanelSse2,
+    WelfordUpdateSse2, DotCompensatedScalar, MaxAbsSse2, ScaledDotSse2};
+const Kernels kAvx2Kernels{
+    Isa::kAvx2,
+    DotAvx2, SumOfSquaresAvx2, AddAvx2, SubtractAvx2, ScaleAvx2, DivideAvx2, AxpyAvx2, AxpbyAvx2,
+    DotFloatAvx2, SumOfSquaresFloatAvx2, DotFloatInDoubleAvx2, SumOfSquaresFloatInDoubleAvx2,
+    AddFloatAvx2, SubtractFloatAvx2, ScaleFloatAvx2, DivideFloatAvx2, AxpyFloatAvx2,
+    AxpbyFloatAvx2,
+    DotInt8Avx2, SparseDotAvx2, SparseAxpyScalar, Dot4Avx2, DotPanelAvx2,
+    WelfordUpdateAvx2, DotCompensatedAvx2, MaxAbsAvx2, ScaledDotAvx2};
+const Kernels kAvx512Kernels{
+    Isa::kAvx512,
+    DotAvx512, SumOfSquaresAvx512, AddAvx512, SubtractAvx512, ScaleAvx512, DivideAvx512,
+    AxpyAvx512, AxpbyAvx512,
+    DotFloatAvx512, SumOfSquaresFloatAvx512, DotFloatInDoubleAvx512,
+    SumOfSquaresFloatInDoubleAvx512, AddFloatAvx512, SubtractFloatAvx512, ScaleFloatAvx512,
+    DivideFloatAvx512, AxpyFloatAvx512, AxpbyFloatAvx512,
+    DotInt8Avx2, SparseDotAvx512, SparseAxpyAvx512, Dot4Avx512, DotPanelAvx512,
+    WelfordUpdateAvx512, DotCompensatedAvx512, MaxAbsAvx512, ScaledDotAvx512};
+// AVX-512 with the byte and vector neural network instructions: only the int8 kernel differs
+const Kernels kAvx512VnniKernels{
+    Isa::kAvx512Vnni,
+    DotAvx512, SumOfSquaresAvx512, AddAvx512, SubtractAvx512, ScaleAvx512, DivideAvx512,
+    AxpyAvx512, AxpbyAvx512,
+    DotFloatAvx512, SumOfSquaresFloatAvx512, DotFloatInDoubleAvx512,
+    SumOfSquaresFloatInDoubleAvx512, AddFloatAvx512, SubtractFloatAvx512, ScaleFloatAvx512,
+    DivideFloatAvx512, AxpyFloatAvx512, AxpbyFloatAvx512,
+    DotInt8Avx512Vnni, SparseDotAvx512, SparseAxpyAvx512, Dot4Avx512, DotPanelAvx512,
+    WelfordUpdateAvx512, DotCompensatedAvx512, MaxAbsAvx512, ScaledDotAvx512};
+#endif
+
+}  // namespace
+
+Isa DetectIsa() noexcept {
+#ifdef EV_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512vnni"))
+    return Isa::kAvx512Vnni;
+  if (__builtin_cpu_supports("avx512f"))
+    return Isa::kAvx512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return Isa::kAvx2;
+  if (__builtin_cpu_supports("sse2"))
+    return Isa::kSse2;
+#endif
+  return Isa::kScalar;
+}
+
+const Kernels& KernelsFor(Isa isa) noexcept {
+  switch (isa) {
+#ifdef EV_KERNELS_X86
+    case Isa::kAvx512Vnni:
+      return kAvx512VnniKernels;
+    case Isa::kAvx512:
+      return kAvx512Kernels;
+    case Isa::kAvx2:
+      return kAvx2Kernels;
+    case Isa::kSse2:
+      return kSse2Kernels;
+#endif
+    default:
+      return kScalarKernels;
+  }
+}
+
+const Kernels& ActiveKernels() noexcept {
+  static const Kernels& active = KernelsFor(DetectIsa());
+  return active;
+}
+
+const char* IsaName(Isa isa) noexcept {
+  switch (isa) {
+    case Isa::kAvx512Vnni:
+      return "avx512vnni";
+    case Isa::kAvx512:
+      return "avx512";
+    case Isa::kAvx2:
+      return "avx2";
+    case Isa::kSse2:
+      return "sse2";
+    default:
+      return "scalar";
+  }
+}
+
+}  // namespace ev_kernels
@@ -0,0 +1,275 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_KERNELS_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_KERNELS_H_
+
+#include <cstdint>
+
+/*
+  Hand-vectorised kernels behind the EuclideanVector operations.
+
+  Every kernel has a scalar, an SSE2, an AVX2 (+FMA) and an AVX-512 version, for double and for
+  float magnitudes. The widest version the CPU supports is picked once, from CPUID, the first
+  time a kernel is used.
+
+  Accuracy
+    Add, Subtract, Scale and Divide perform exactly the same IEEE operation on every element as
+    the scalar loop, so every version gives bit-identical results.
+    Dot and SumOfSquares keep several partial sums and (AVX2/AVX-512) use fused multiply-add, so
+    the order of rounding differs from the scalar loop. The difference from the scalar result is
+    bounded by 2 * n * DBL_EPSILON * sum(|a[i] * b[i]|) (tests use exactly this bound).
+    Axpy and Axpby use fused multiply-add where the CPU has it, which skips the rounding of one
+    product, so each element may differ from the scalar version by at most
+    DBL_EPSILON * (|a * x[i]| + |b * dst[i]|).
+    The float kernels have the same bounds with FLT_EPSILON. DotInDouble and
+    SumOfSquaresInDouble read floats but multiply and accumulate in double; the product of two
+    floats is exact in double, so they stay within 2 * n * DBL_EPSILON * sum(|a[i] * b[i]|).
+    DotInt8 is exact.
+    SparseDot and SparseAxpy have the bounds of Dot and Axpy, over the nnz stored magnitudes.
+    Each result of Dot4 and DotPanel has the bound of Dot.
+    WelfordUpdate performs exactly the operations of the scalar loop, so every version gives
+    bit-identical results.
+    DotCompensated adds up the products as if in twice the precision: the error of sum +
+    compensation is at most DBL_EPSILON * |a . b| + 2 * (n * DBL_EPSILON)^2 * sum(|a[i] * b[i]|).
+    MaxAbs is exact. ScaledDot has the bound of Dot, over the scaled magnitudes.
+
+  The int8 kernel (SSE2, AVX2 pmaddubsw, AVX-512 VNNI vpdpbusd) requires codes in [-127, 127].
+  Plain AVX-512 uses the AVX2 int8 kernel; kAvx512Vnni is picked when the CPU also has
+  AVX-512BW and VNNI, and differs from kAvx512 only in that kernel.
+*/
+
+namespace ev_kernels {
+
+enum class Isa { kScalar, kSse2, kAvx2, kAvx512, kAvx512Vnni };
+
+struct Kernels {
+  Isa isa;
+  double (*dot)(const double* a, const double* b, int n) noexcept;
+  double (*sumOfSquares)(const double* a, int n) noexcept;
+  // dst may be a (or b), but must not otherwise overlap the operands
+  void (*add)(double* dst, const double* a, const double* b, int n) noexcept;
+  void (*subtract)(double* dst, const double* a, const double* b, int n) noexcept;
+  void (*scale)(double* dst, const double* a, double d, int n) noexcept;
+  void (*divide)(double* dst, const double* a, double d, int n) noexcept;
+  void (*axpy)(double* dst, double a, const double* x, int n) noexcept;
+  void (*axpby)(double* dst, double a, const double* x, double b, int n) noexcept;
+  float (*dotFloat)(const float* a, const float* b, int n) noexcept;
+  float (*sumOfSquaresFloat)(const float* a, int n) noexcept;
+  double (*dotFloatInDouble)(const float* a, const float* b, int n) noexcept;
+  double (*sumOfSquaresFloatInDouble)(const float* a, int n) noexcept;
+  void (*addFloat)(float* dst, const float* a, const float* b, int n) noexcept;
+  void (*subtractFloat)(float* dst, const float* a, const float* b, int n) noexcept;
+  void (*scaleFloat)(float* dst, const float* a, float d, int n) noexcept;
+  void (*divideFloat)(float* dst, const float* a, float d, int n) noexcept;
+  void (*axpyFloat)(float* dst, float a, const float* x, int n) noexcept;
+  void (*axpbyFloat)(float* dst, float a, const float* x, float b, int n) noexcept;
+  // n must be at most kMaxInt8DotLength, so that the sum fits in 32 bits
+  std::int32_t (*dotInt8)(const std::int8_t* a, const std::int8_t* b, int n) noexcept;
+  double (*sparseDot)(const int* indices, const double* values, int nnz,
+                      const double* dense) noexcept;
+  void (*sparseAxpy)(double* dense, double a, const int* indices, const double* values,
+                     int nnz) noexcept;
+  void (*dot4)(const double* x, const double* const* queries, int n, double* out) noexcept;
+  void (*dotPanel)(const double* a, const double* b, int n, double* out, int outStride) noexcept;
+  void (*welfordUpdate)(const double* x, double inverseCount, int n, double* mean, double* m2,
+                        double* min, double* max) noexcept;
+  void (*dotCompensated)(const double* a, const double* b, int n, double* sum,
+                         double* compensation) noexcept;
+  double (*maxAbs)(const double* a, int n) noexcept;
+  double (*scaledDot)(const double* a, double sa, const double* b, double sb, int n) noexcept;
+};
+
+// Vectors in each of the two panels of DotPanel
+constexpr int kPanelVectors = 8;
+
+// 127 * 127 * kMaxInt8DotLength < 2^31
+constexpr int kMaxInt8DotLength = 1 << 17;
+
+// Widest instruction set supported by this CPU (and by the compiler that built the library)
+Isa DetectIsa() noexcept;
+// Kernels for a given instruction set. The caller must make sure the CPU supports it.
+const Kernels& KernelsFor(Isa) noexcept;
+// Kernels used by EuclideanVector, selected on first use
+const Kernels& ActiveKernels() noexcept;
+const char* IsaName(Isa) noexcept;
+
+inline double Dot(const double* a, const double* b, int n) noexcept {
+  return ActiveKernels().dot(a, b, n);
+}
+
+inline double SumOfSquares(const double* a, int n) noexcept {
+  return ActiveKernels().sumOfSquares(a, n);
+}
+
+// dst[i] += src[i]
+inline void Add(double* dst, const double* src, int n) noexcept {
+  ActiveKernels().add(dst, dst, src, n);
+}
+
+// dst[i] = a[i] + b[i]. dst may be a or b, but must not otherwise overlap them (nor below).
+inline void Add(double* dst, const double* a, const double* b, int n) noexcept {
+  ActiveKernels().add(dst, a, b, n);
+}
+
+// dst[i] -= src[i]
+inline void Subtract(double* dst, const double* src, int n) noexcept {
+  ActiveKernels().subtract(dst, dst, src, n);
+}
+
+// dst[i] = a[i] - b[i]
+inline void Subtract(double* dst, const double* a, const double* b, int n) noexcept {
+  ActiveKernels().subtract(dst, a, b, n);
+}
+
+// dst[i] *= d
+inline void Scale(double* dst, double d, int n) noexcept {
+  ActiveKernels().scale(dst, dst, d, n);
+}
+
+// dst[i] = a[i] * d
+inline void Scale(double* dst, const double* a, double d, int n) noexcept {
+  ActiveKernels().scale(dst, a, d, n);
+}
+
+// dst[i] /= d
+inline void Divide(double* dst, double d, int n) noexcept {
+  ActiveKernels().divide(dst, dst, d, n);
+}
+
+// dst[i] = a[i] / d
+inline void Divide(double* dst, const double* a, double d, int n) noexcept {
+  ActiveKernels().divide(dst, a, d, n);
+}
+
+// dst[i] += a * x[i]
+inline void Axpy(double* dst, double a, const double* x, int n) noexcept {
+  ActiveKernels().axpy(dst, a, x, n);
+}
+
+// dst[i] = a * x[i] + b * dst[i]
+inline void Axpby(double* dst, double a, const double* x, double b, int n) noexcept {
+  ActiveKernels().axpby(dst, a, x, b, n);
+}
+
+// float versions of the kernels above
+
+inline float Dot(const float* a, const float* b, int n) noexcept {
+  return ActiveKernels().dotFloat(a, b, n);
+}
+
+inline float SumOfSquares(const float* a, int n) noexcept {
+  return ActiveKernels().sumOfSquaresFloat(a, n);
+}
+
+// Dot product of float magnitudes, accumulated in double
+inline double DotInDouble(const float* a, const float* b, int n) noexcept {
+  return ActiveKernels().dotFloatInDouble(a, b, n);
+}
+
+// Sum of squares of float magnitudes, accumulated in double
+inline double SumOfSquaresInDouble(const float* a, int n) noexcept {
+  return ActiveKernels().sumOfSquaresFloatInDouble(a, n);
+}
+
+inline void Add(float* dst, const float* src, int n) noexcept {
+  ActiveKernels().addFloat(dst, dst, src, n);
+}
+
+inline void Add(float* dst, const float* a, const float* b, int n) noexcept {
+  ActiveKernels().addFloat(dst, a, b, n);
+}
+
+inline void Subtract(float* dst, const float* src, int n) noexcept {
+  ActiveKernels().subtractFloat(dst, dst, src, n);
+}
+
+inline void Subtract(float* dst, const float* a, const float* b, int n) noexcept {
+  ActiveKernels().subtractFloat(dst, a, b, n);
+}
+
+inline void Scale(float* dst, float d, int n) noexcept {
+  ActiveKernels().scaleFloat(dst, dst, d, n);
+}
+
+inline void Scale(float* dst, const float* a, float d, int n) noexcept {
+  ActiveKernels().scaleFloat(dst, a, d, n);
+}
+
+inline void Divide(float* dst, float d, int n) noexcept {
+  ActiveKernels().divideFloat(dst, dst, d, n);
+}
+
+inline void Divide(float* dst, const float* a, float d, int n) noexcept {
+  ActiveKernels().divideFloat(dst, a, d, n);
+}
+
+inline void Axpy(float* dst, float a, const float* x, int n) noexcept {
+  ActiveKernels().axpyFloat(dst, a, x, n);
+}
+
+inline void Axpby(float* dst, float a, const float* x, float b, int n) noexcept {
+  ActiveKernels().axpbyFloat(dst, a, x, b, n);
+}
+
+// sum(values[k] * dense[indices[k]]), for k < nnz
+inline double SparseDot(const int* indices, const double* values, int nnz,
+                        const double* dense) noexcept {
+  return ActiveKernels().sparseDot(indices, values, nnz, dense);
+}
+
+// dense[indices[k]] += a * values[k], for k < nnz. The indices must be distinct.
+inline void SparseAxpy(double* dense, double a, const int* indices, const double* values,
+                       int nnz) noexcept {
+  ActiveKernels().sparseAxpy(dense, a, indices, values, nnz);
+}
+
+// out[j] = x . queries[j] for j < 4, reading x once
+inline void Dot4(const double* x, const double* const* queries, int n, double* out) noexcept {
+  ActiveKernels().dot4(x, queries, n, out);
+}
+
+// Matrix product of two panels of kPanelVectors vectors, each packed step by step
+// (a[i * kPanelVectors + r] is magnitude i of vector r):
+// out[r * outStride + c] += a_r . b_c for r, c < kPanelVectors
+inline void DotPanel(const double* a, const double* b, int n, double* out, int outStride) noexcept {
+  ActiveKernels().dotPanel(a, b, n, out, outStride);
+}
+
+// Adds the vector x to running per-element statistics, with inverseCount = 1 / (number of
+// vectors including x): mean[i] += (x[i] - mean[i]) * inverseCount,
+// m2[i] += (x[i] - old mean[i]) * (x[i] - mean[i]), min[i] = min(min[i], x[i]) and likewise max
+inline void WelfordUpdate(const double* x, double inverseCount, int n, double* mean, double* m2,
+                          double* min, double* max) noexcept {
+  ActiveKernels().welfordUpdate(x, inverseCount, n, mean, m2, min, max);
+}
+
+// Adds a . b into the running compensated sum (*sum, *compensation); the dot product of
+// everything added so far is *sum + *compensation. Start both at 0.0.
+inline void DotCompensated(const double* a, const double* b, int n, double* sum,
+                           double* compensation) noexcept {
+  ActiveKernels().dotCompensated(a, b, n, sum, compensation);
+}
+
+// max |a[i]|, 0.0 for n == 0
+inline double MaxAbs(const double* a, int n) noexcept {
+  return ActiveKernels().maxAbs(a, n);
+}
+
+// sum((a[i] * sa) * (b[i] * sb))
+inline double ScaledDot(const double* a, double sa, const double* b, double sb, int n) noexcept {
+  return ActiveKernels().scaledDot(a, sa, b, sb, n);
+}
+
+// Exact dot product of int8 codes in [-127, 127]
+inline std::int64_t DotInt8(const std::int8_t* a, const std::int8_t* b, int n) noexcept {
+  std::int64_t sum = 0;
+  for (int begin = 0; begin < n; begin += kMaxInt8DotLength) {
+    const int length = n - begin < kMaxInt8DotLength ? n - begin : kMaxInt8DotLength;
+    sum += ActiveKernels().dotInt8(a + begin, b + begin, length);
+  }
+  return sum;
+}
+
+}  // namespace ev_kernels
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_KERNELS_H_
@@ -0,0 +1,521 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Every SIMD version of every kernel that the machine running the tests supports is compared
+  against the scalar version, over sizes that exercise the unrolled loops as well as every
+  possible tail length.
+
+  Element-wise kernels must match the scalar version exactly. Dot and SumOfSquares must stay
+  within the documented bound of 2 * n * DBL_EPSILON * sum(|a[i] * b[i]|).
+
+  The float kernels are held to the same bounds with FLT_EPSILON, except DotInDouble and
+  SumOfSquaresInDouble, which accumulate in double and so must stay within the DBL_EPSILON bound.
+  The int8 dot product is exact, so every version must match the scalar version exactly.
+  Dot4 must give, for each of its four vectors, the Dot bound against the scalar Dot, and so must
+  each of the 64 sums DotPanel adds to its output block.
+  The sparse kernels gather (and scatter) at random distinct indices of a dense vector and are
+  held to the Dot and Axpy bounds.
+  WelfordUpdate must match the scalar version exactly over a stream of vectors.
+  DotCompensated must stay within its (twice the precision) bound of the scalar version, also on
+  products that cancel, MaxAbs must be exact and ScaledDot is held to the Dot bound.
+
+*/
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_kernels.h"
+#include "catch.h"
+
+namespace {
+
+std::vector<double> RandomMagnitudes(int n, unsigned seed) {
+  std::mt19937 gen{seed};
+  std::uniform_real_distribution<double> dist{-100.0, 100.0};
+  std::vector<double> mags(n);
+  for (auto& m : mags)
+    m = dist(gen);
+  return mags;
+}
+
+std::vector<float> RandomFloatMagnitudes(int n, unsigned seed) {
+  std::mt19937 gen{seed};
+  std::uniform_real_distribution<float> dist{-100.0f, 100.0f};
+  std::vector<float> mags(n);
+  for (auto& m : mags)
+    m = dist(gen);
+  return mags;
+}
+
+std::vector<std::int8_t> RandomCodes(int n, unsigned seed) {
+  std::mt19937 gen{seed};
+  std::uniform_int_distribution<int> dist{-127, 127};
+  std::vector<std::int8_t> codes(n);
+  for (auto& c : codes)
+    c = static_cast<std::int8_t>(dist(gen));
+  return codes;
+}
+
+std::vector<ev_kernels::Isa> SupportedIsas() {
+  std::vector<ev_kernels::Isa> isas;
+  for (auto isa : {ev_kernels::Isa::kScalar, ev_kernels::Isa::kSse2, ev_kernels::Isa::kAvx2,
+                   ev_kernels::Isa::kAvx512, ev_kernels::Isa::kAvx512Vnni}) {
+    if (isa <= ev_kernels::DetectIsa())
+      isas.push_back(isa);
+  }
+  return isas;
+}
+
+const std::vector<int> kSizes{0, 1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 256, 1000, 4096};
+
+}  // namespace
+
+SCENARIO("Compute a dot product with every supported instruction set") {
+  const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+  for (auto isa : SupportedIsas()) {
+    GIVEN(std::string("The ") + ev_kernels::IsaName(isa) + " kernels") {
+      const auto& kernels = ev_kernels::KernelsFor(isa);
+      for (auto n : kSizes) {
+        auto a = RandomMagnitudes(n, 1);
+        auto b = RandomMagnitudes(n, 2);
+        auto bound = 0.0;
+        for (int i = 0; i < n; i++)
+          bound += std::abs(a[i] * b[i]);
+        bound *= 2 * n * DBL_EPSILON;
+        WHEN("The dot product and sum of squares of two vectors with " + std::to_string(n) +
+             " dimensions are computed") {
+          THEN("The dot product is within the documented bound of the scalar result") {
+            REQUIRE(std::abs(kernels.dot(a.data(), b.data(), n) -
+                             scalar.dot(a.data(), b.data(), n)) <= bound);
+          }
+          THEN("The sum of squares is within the documented bound of the scalar result") {
+            auto squaresBound = 0.0;
+            for (int i = 0; i < n; i++)
+              squaresBound += a[i] * a[i];
+            squaresBound *= 2 * n * DBL_EPSILON;
+            REQUIRE(std::abs(kernels.sumOfSquares(a.data(), n) -
+                             scalar.sumOfSquares(a.data(), n)) <= squaresBound);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Apply element-wise kernels with every supported instruction set") {
+  const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+  for (auto isa : SupportedIsas()) {
+    GIVEN(std::string("The ") + ev_kernels::IsaName(isa) + " kernels") {
+      const auto& kernels = ev_kernels::KernelsFor(isa);
+      for (auto n : kSizes) {
+        auto a = RandomMagnitudes(n, 3);
+        auto b = RandomMagnitudes(n, 4);
+        WHEN("Add, Subtract, Scale and Divide are applied to " + std::to_string(n) +
+             " dimensions") {
+          auto expected = a;
+          auto actual = a;
+          scalar.add(expected.data(), expected.data(), b.data(), n);
+          kernels.add(actual.data(), actual.data(), b.data(), n);
+          scalar.subtract(expected.data(), expected.data(), a.data(), n);
+          kernels.subtract(actual.data(), actual.data(), a.data(), n);
+          scalar.scale(expected.data(), expected.data(), 3.7, n);
+          kernels.scale(actual.data(), actual.data(), 3.7, n);
+          scalar.divide(expected.data(), expected.data(), 1.3, n);
+          kernels.divide(actual.data(), actual.data(), 1.3, n);
+          THEN("The results are identical to the scalar kernels") { REQUIRE(actual == expected); }
+        }
+        WHEN("They write " + std::to_string(n) + " dimensions into separate arrays") {
+          auto expected = std::vector<std::vector<double>>(4, std::vector<double>(n));
+          auto actual = expected;
+          scalar.add(expected[0].data(), a.data(), b.data(), n);
+          kernels.add(actual[0].data(), a.data(), b.data(), n);
+          scalar.subtract(expected[1].data(), a.data(), b.data(), n);
+          kernels.subtract(actual[1].data(), a.data(), b.data(), n);
+          scalar.scale(expected[2].data(), a.data(), 3.7, n);
+          kernels.scale(actual[2].data(), a.data(), 3.7, n);
+          scalar.divide(expected[3].data(), a.data(), 1.3, n);
+          kernels.divide(actual[3].data(), a.data(), 1.3, n);
+          THEN("The results are identical to the scalar kernels") { REQUIRE(actual == expected); }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Apply fused axpy kernels with every supported instruction set") {
+  const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+  for (auto isa : SupportedIsas()) {
+    GIVEN(std::string("The ") + ev_kernels::IsaName(isa) + " kernels") {
+      const auto& kernels = ev_kernels::KernelsFor(isa);
+      for (auto n : kSizes) {
+        auto x = RandomMagnitudes(n, 7);
+        auto y = RandomMagnitudes(n, 8);
+        WHEN("Axpy and Axpby are applied to " + std::to_string(n) + " dimensions") {
+          auto expected = y;
+          auto actual = y;
+          scalar.axpy(expected.data(), 1.7, x.data(), n);
+          kernels.axpy(actual.data(), 1.7, x.data(), n);
+          THEN("Axpy is within the documented bound of the scalar result") {
+            for (int i = 0; i < n; i++)
+              REQUIRE(std::abs(actual[i] - expected[i]) <=
+                      DBL_EPSILON * (std::abs(1.7 * x[i]) + std::abs(y[i])));
+          }
+          expected = y;
+          actual = y;
+          scalar.axpby(expected.data(), 1.7, x.data(), -0.3, n);
+          kernels.axpby(actual.data(), 1.7, x.data(), -0.3, n);
+          THEN("Axpby is within the documented bound of the scalar result") {
+            for (int i = 0; i < n; i++)
+              REQUIRE(std::abs(actual[i] - expected[i]) <=
+                      DBL_EPSILON * (std::abs(1.7 * x[i]) + std::abs(0.3 * y[i])));
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Compute a float dot product with every supported instruction set") {
+  const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+  for (auto isa : SupportedIsas()) {
+    GIVEN(std::string("The ") + ev_kernels::IsaName(isa) + " kernels") {
+      const auto& kernels = ev_kernels::KernelsFor(isa);
+      for (auto n : kSizes) {
+        auto a = RandomFloatMagnitudes(n, 11);
+        auto b = RandomFloatMagnitudes(n, 12);
+        // Exact, since the product of two floats is exact in double
+        auto sumOfProducts = 0.0;
+        auto sumOfSquares = 0.0;
+        for (int i = 0; i < n; i++) {
+          sumOfProducts += std::abs(static_cast<double>(a[i]) * b[i]);
+          sumOfSquares += static_cast<double>(a[i]) * a[i];
+        }
+        WHEN("The dot product and sum of squares of two float vectors with " +
+             std::to_string(n) + " dimensions are computed") {
+          THEN("The float results are within the documented bound of the scalar result") {
+            REQUIRE(std::abs(kernels.dotFloat(a.data(), b.data(), n) -
+                             scalar.dotFloat(a.data(), b.data(), n)) <=
+                    2 * n * FLT_EPSILON * sumOfProducts);
+            REQUIRE(std::abs(kernels.sumOfSquaresFloat(a.data(), n) -
+                             scalar.sumOfSquaresFloat(a.data(), n)) <=
+                    2 * n * FLT_EPSILON * sumOfSquares);
+          }
+          THEN("The double accumulated results are within the double bound") {
+            REQUIRE(std::abs(kernels.dotFloatInDouble(a.data(), b.data(), n) -
+                             scalar.dotFloatInDouble(a.data(), b.data(), n)) <=
+                    2 * n * DBL_EPSILON * sumOfProducts);
+            REQUIRE(std::abs(kernels.sumOfSquaresFloatInDouble(a.data(), n) -
+                             scalar.sumOfSquaresFloatInDouble(a.data(), n)) <=
+                    2 * n * DBL_EPSILON * sumOfSquares);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Apply float element-wise and axpy kernels with every supported instruction set") {
+  const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+  for (auto isa : SupportedIsas()) {
+    GIVEN(std::string("The ") + ev_kernels::IsaName(isa) + " kernels") {
+      const auto& kernels = ev_kernels::KernelsFor(isa);
+      for (auto n : kSizes) {
+        auto a = RandomFloatMagnitudes(n, 13);
+        auto b = RandomFloatMagnitudes(n, 14);
+        WHEN("Add, Subtract, Scale and Divide are applied to " + std::to_string(n) +
+             " float dimensions") {
+          auto expected = a;
+          auto actual = a;
+          scalar.addFloat(expected.data(), expected.data(), b.data(), n);
+          kernels.addFloat(actual.data(), actual.data(), b.data(), n);
+          scalar.subtractFloat(expected.data(), expected.data(), a.data(), n);
+          kernels.subtractFloat(actual.data(), actual.data(), a.data(), n);
+          scalar.scaleFloat(expected.data(), expected.data(), 3.7f, n);
+          kernels.scaleFloat(actual.data(), actual.data(), 3.7f, n);
+          scalar.divideFloat(expected.data(), expected.data(), 1.3f, n);
+          kernels.divideFloat(actual.data(), actual.data(), 1.3f, n);
+          THEN("The results are identical to the scalar kernels") { REQUIRE(actual == expected); }
+        }
+        WHEN("They write " + std::to_string(n) + " float dimensions into separate arrays") {
+          auto expected = std::vector<std::vector<float>>(4, std::vector<float>(n));
+          auto actual = expected;
+          scalar.addFloat(expected[0].data(), a.data(), b.data(), n);
+          kernels.addFloat(actual[0].data(), a.data(), b.data(), n);
+          scalar.subtractFloat(expected[1].data(), a.data(), b.data(), n);
+          kernels.subtractFloat(actual[1].data(), a.data(), b.data(), n);
+          scalar.scaleFloat(expected[2].data(), a.data(), 3.7f, n);
+          kernels.scaleFloat(actual[2].data(), a.data(), 3.7f, n);
+          scalar.divideFloat(expected[3].data(), a.data(), 1.3f, n);
+          kernels.divideFloat(actual[3].data(), a.data(), 1.3f, n);
+          THEN("The results are identical to the scalar kernels") { REQUIRE(actual == expected); }
+        }
+        WHEN("Axpy and Axpby are applied to " + std::to_string(n) + " float dimensions") {
+          auto expected = b;
+          auto actual = b;
+          scalar.axpyFloat(expected.data(), 1.7f, a.data(), n);
+          kernels.axpyFloat(actual.data(), 1.7f, a.data(), n);
+          THEN("Axpy is within the documented bound of the scalar result") {
+            for (int i = 0; i < n; i++)
+              REQUIRE(std::abs(actual[i] - expected[i]) <=
+                      FLT_EPSILON * (std::abs(1.7f * a[i]) + std::abs(b[i])));
+          }
+          expected = b;
+          actual = b;
+          scalar.axpbyFloat(expected.data(), 1.7f, a.data(), -0.3f, n);
+          kernels.axpbyFloat(actual.data(), 1.7f, a.data(), -0.3f, n);
+          THEN("Axpby is within the documented bound of the scalar result") {
+            for (int i = 0; i < n; i++)
+              REQUIRE(std::abs(actual[i] - expected[i]) <=
+                      FLT_EPSILON * (std::abs(1.7f * a[i]) + std::abs(0.3f * b[i])));
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Compute an int8 dot product with every supported instruction set") {
+  const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+  for (auto isa : SupportedIsas()) {
+    GIVEN(std::string("The ") + ev_kernels::IsaName(isa) + " kernels") {
+      const auto& kernels = ev_kernels::KernelsFor(isa);
+      for (auto n : kSizes) {
+        auto a = RandomCodes(n, 21);
+        auto b = RandomCodes(n, 22);
+        WHEN("The dot product of two code vectors with " + std::to_string(n) +
+             " dimensions is computed") {
+          THEN("It is identical to the scalar result") {
+            REQUIRE(kernels.dotInt8(a.data(), b.data(), n) ==
+                    scalar.dotInt8(a.data(), b.data(), n));
+          }
+        }
+      }
+      WHEN("The codes are all -127 or 127") {
+        auto a = std::vector<std::int8_t>(255, -127);
+        auto b = std::vector<std::int8_t>(255, 127);
+        a[3] = 127;
+        THEN("The products are not saturated") {
+          REQUIRE(kernels.dotInt8(a.data(), b.data(), 255) == -253 * 127 * 127);
+        }
+      }
+    }
+  }
+  GIVEN("That there are more codes than fit in one 32-bit sum") {
+    const int n = ev_kernels::kMaxInt8DotLength + 1000;
+    auto a = std::vector<std::int8_t>(n, 127);
+    WHEN("The dot product is computed with DotInt8") {
+      THEN("The sum is exact") {
+        REQUIRE(ev_kernels::DotInt8(a.data(), a.data(), n) == std::int64_t{n} * 127 * 127);
+      }
+    }
+  }
+}
+
+SCENARIO("Compute four dot products at once with every supported instruction set") {
+  const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+  for (auto isa : SupportedIsas()) {
+    GIVEN(std::string("The ") + ev_kernels::IsaName(isa) + " kernels") {
+      const auto& kernels = ev_kernels::KernelsFor(isa);
+      for (auto n : kSizes) {
+        auto x = RandomMagnitudes(n, 41);
+        std::vector<std::vector<double>> queries;
+        for (unsigned j = 0; j < 4; j++)
+          queries.push_back(RandomMagnitudes(n, 42 + j));
+        const double* pointers[4] = {queries[0].data(), queries[1].data(), queries[2].data(),
+                                     queries[3].data()};
+        WHEN("A vector with " + std::to_string(n) + " dimensions is dotted with four others") {
+          double dots[4];
+          kernels.dot4(x.data(), pointers, n, dots);
+          THEN("Each result is within the documented bound of the scalar dot product") {
+            for (int j = 0; j < 4; j++) {
+              auto bound = 0.0;
+              for (int i = 0; i < n; i++)
+                bound += std::abs(x[i] * queries[j][i]);
+              REQUIRE(std::abs(dots[j] - scalar.dot(x.data(), pointers[j], n)) <=
+                      2 * n * DBL_EPSILON * bound);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Compute a panel of dot products with every supported instruction set") {
+  const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+  constexpr int kPanel = ev_kernels::kPanelVectors;
+  for (auto isa : SupportedIsas()) {
+    GIVEN(std::string("The ") + ev_kernels::IsaName(isa) + " kernels") {
+      const auto& kernels = ev_kernels::KernelsFor(isa);
+      for (auto n : kSizes) {
+        // Packed step by step: a[i * kPanel + r] is magnitude i of vector r
+        const auto a = RandomMagnitudes(n * kPanel, 51);
+        const auto b = RandomMagnitudes(n * kPanel, 52);
+        WHEN("Two panels of vectors with " + std::to_string(n) + " dimensions are multiplied") {
+          // Rows of the output block are further apart than the panel, and start at 1.0
+          constexpr int kStride = kPanel + 3;
+          std::vector<double> out(kPanel * kStride, 1.0);
+          kernels.dotPanel(a.data(), b.data(), n, out.data(), kStride);
+          THEN("Each sum is added within the documented bound of the scalar dot product") {
+            for (int r = 0; r < kPanel; r++) {
+              std::vector<double> ar(n);
+              for (int c = 0; c < kPanel; c++) {
+                std::vector<double> bc(n);
+                auto bound = 0.0;
+                for (int i = 0; i < n; i++) {
+                  ar[i] = a[i * kPanel + r];
+                  bc[i] = b[i * kPanel + c];
+                  bound += std::abs(ar[i] * bc[i]);
+                }
+                const double expected = scalar.dot(ar.data(), bc.data(), n);
+                REQUIRE(std::abs(out[r * kStride + c] - 1.0 - expected) <=
+                        2 * n * DBL_EPSILON * bound + DBL_EPSILON * (1.0 + bound));
+              }
+              for (int c = kPanel; c < kStride; c++)
+                REQUIRE(out[r * kStride + c] == 1.0);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Apply Welford updates with every supported instruction set") {
+  const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+  for (auto isa : SupportedIsas()) {
+    GIVEN(std::string("The ") + ev_kernels::IsaName(isa) + " kernels") {
+      const auto& kernels = ev_kernels::KernelsFor(isa);
+      for (auto n : kSizes) {
+        WHEN("Ten vectors with " + std::to_string(n) + " dimensions are added") {
+          std::vector<double> expected(4 * n);
+          std::vector<double> actual(4 * n);
+          for (int v = 1; v <= 10; v++) {
+            const auto x = RandomMagnitudes(n, 60 + v);
+            // mean, m2, min and max one after the other
+            double* e = expected.data();
+            double* a = actual.data();
+            scalar.welfordUpdate(x.data(), 1.0 / v, n, e, e + n, e + 2 * n, e + 3 * n);
+            kernels.welfordUpdate(x.data(), 1.0 / v, n, a, a + n, a + 2 * n, a + 3 * n);
+          }
+          THEN("The statistics are identical to the scalar kernels") {
+            REQUIRE(actual == expected);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Apply accuracy kernels with every supported instruction set") {
+  const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+  for (auto isa : SupportedIsas()) {
+    GIVEN(std::string("The ") + ev_kernels::IsaName(isa) + " kernels") {
+      const auto& kernels = ev_kernels::KernelsFor(isa);
+      for (auto n : kSizes) {
+        // a . b adds up products that cancel out to (nearly) nothing
+        auto a = RandomMagnitudes(n, 71);
+        const auto b = RandomMagnitudes(n, 72);
+        for (int i = 0; i + 1 < n; i += 2)
+          a[i + 1] = -a[i] * b[i] / b[i + 1];
+        auto bound = 0.0;
+        for (int i = 0; i < n; i++)
+          bound += std::abs(a[i] * b[i]);
+        WHEN("The compensated dot product, max |a[i]| and the scaled dot product of " +
+             std::to_string(n) + " dimensions are computed") {
+          double sum = 0.0;
+          double compensation = 0.0;
+          double expectedSum = 0.0;
+          double expectedCompensation = 0.0;
+          kernels.dotCompensated(a.data(), b.data(), n, &sum, &compensation);
+          scalar.dotCompensated(a.data(), b.data(), n, &expectedSum, &expectedCompensation);
+          const double expected = expectedSum + expectedCompensation;
+          THEN("They are within the documented bounds of the scalar kernels") {
+            REQUIRE(std::abs(sum + compensation - expected) <=
+                    2 * DBL_EPSILON * std::abs(expected) +
+                        4 * (n * DBL_EPSILON) * (n * DBL_EPSILON) * bound);
+            REQUIRE(kernels.maxAbs(a.data(), n) == scalar.maxAbs(a.data(), n));
+            REQUIRE(std::abs(kernels.scaledDot(a.data(), 0.25, b.data(), 2.0, n) -
+                             scalar.scaledDot(a.data(), 0.25, b.data(), 2.0, n)) <=
+                    2 * n * DBL_EPSILON * 0.5 * bound);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Apply sparse kernels with every supported instruction set") {
+  const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+  const int denseLength = 5000;
+  auto dense = RandomMagnitudes(denseLength, 31);
+  for (auto isa : SupportedIsas()) {
+    GIVEN(std::string("The ") + ev_kernels::IsaName(isa) + " kernels") {
+      const auto& kernels = ev_kernels::KernelsFor(isa);
+      for (auto nnz : kSizes) {
+        // nnz distinct sorted indices into the dense vector
+        std::vector<int> indices;
+        std::mt19937 gen{static_cast<unsigned>(nnz)};
+        for (int i = 0; i < denseLength && static_cast<int>(indices.size()) < nnz; i++) {
+          if (static_cast<int>(gen() % denseLength) < nnz)
+            indices.push_back(i);
+        }
+        const int n = static_cast<int>(indices.size());
+        auto values = RandomMagnitudes(n, 32);
+        WHEN("A sparse vector with up to " + std::to_string(nnz) +
+             " stored magnitudes is applied") {
+          THEN("SparseDot is within the documented bound of the scalar result") {
+            auto bound = 0.0;
+            for (int k = 0; k < n; k++)
+              bound += std::abs(values[k] * dense[indices[k]]);
+            REQUIRE(std::abs(kernels.sparseDot(indices.data(), values.data(), n, dense.data()) -
+                             scalar.sparseDot(indices.data(), values.data(), n, dense.data())) <=
+                    2 * n * DBL_EPSILON * bound);
+          }
+          THEN("SparseAxpy is within the documented bound and leaves other magnitudes alone") {
+            auto expected = dense;
+            auto actual = dense;
+            scalar.sparseAxpy(expected.data(), 1.7, indices.data(), values.data(), n);
+            kernels.sparseAxpy(actual.data(), 1.7, indices.data(), values.data(), n);
+            for (int k = 0; k < n; k++) {
+              const int i = indices[k];
+              REQUIRE(std::abs(actual[i] - expected[i]) <=
+                      DBL_EPSILON * (std::abs(1.7 * values[k]) + std::abs(dense[i])));
+              actual[i] = expected[i] = dense[i];
+            }
+            REQUIRE(actual == dense);
+            REQUIRE(expected == dense);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Use the active kernels through EuclideanVector") {
+  GIVEN("That there are two vectors with 1000 dimensions") {
+    auto mags1 = RandomMagnitudes(1000, 5);
+    auto mags2 = RandomMagnitudes(1000, 6);
+    auto ev1 = EuclideanVector(mags1.begin(), mags1.end());
+    auto ev2 = EuclideanVector(mags2.begin(), mags2.end());
+    WHEN("The norm and the dot product are obtained") {
+      auto norm = ev1.GetEuclideanNorm();
+      auto dotProd = ev1 * ev2;
+      THEN("They match the scalar kernels within the documented bound") {
+        const auto& scalar = ev_kernels::KernelsFor(ev_kernels::Isa::kScalar);
+        REQUIRE(std::abs(norm - std::sqrt(scalar.sumOfSquares(mags1.data(), 1000))) <=
+                2000 * DBL_EPSILON * norm);
+        auto bound = 0.0;
+        for (int i = 0; i < 1000; i++)
+          bound += std::abs(mags1[i] * mags2[i]);
+        REQUIRE(std::abs(dotProd - scalar.dot(mags1.data(), mags2.data(), 1000)) <=
+                2000 * DBL_EPSILON * bound);
+      }
+    }
+  }
+}
@@ -0,0 +1,249 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/euclidean_vector_pairwise.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_kernels.h"
+
+namespace {
+
+constexpr int kPanel = ev_kernels::kPanelVectors;
+constexpr int kTile = kPairwiseTileVectors;
+static_assert(kTile % kPanel == 0, "Tiles must be made of whole panels");
+
+// Packing buffers and the tile being computed, kept by each thread between tiles
+struct Scratch {
+  std::vector<double> packedRows;
+  std::vector<double> packedColumns;
+  std::vector<double> tile;
+};
+
+Scratch& ThreadScratch() {
+  thread_local Scratch scratch;
+  if (scratch.tile.empty()) {
+    scratch.packedRows.resize(static_cast<std::size_t>(kTile) * kPairwiseDepth);
+    scratch.packedColumns.resize(static_cast<std::size_t>(kTile) * kPairwiseDepth);
+    scratch.tile.resize(static_cast<std::size_t>(kTile) * kTile);
+  }
+  return scratch;
+}
+
+// The batch itself if its rows can be read as they are, otherwise a row-major copy of it
+// (normalised for kCosine) kept in copy
+const EuclideanVectorBatch& Prepare(const EuclideanVectorBatch& batch,
+                                    Metric metric,
+                                    std::optional<EuclideanVectorBatch>& copy) {
+  if (batch.GetLayout() == EuclideanVectorBatch::Layout::kRowMajor && metric != Metric::kCosine)
+    return batch;
+  if (batch.GetLayout() == EuclideanVectorBatch::Layout::kRowMajor)
+    copy.emplace(batch);
+  else
+    copy.emplace(batch.ToLayout(EuclideanVectorBatch::Layout::kRowMajor));
+  if (metric == Metric::kCosine)
+    copy->Normalize();
+  return *copy;
+}
+
+std::vector<double> SquaredNorms(const EuclideanVectorBatch& rows) {
+  std::vector<double> norms(rows.GetNumVectors());
+  for (int r = 0; r < rows.GetNumVectors(); r++) {
+    const double* row = rows.data() + static_cast<std::size_t>(r) * rows.GetStride();
+    norms[r] = ev_kernels::SumOfSquares(row, rows.GetNumDimensions());
+  }
+  return norms;
+}
+
+// Packs magnitudes [depthBegin, depthBegin + depth) of rows [begin, begin + count) step by step
+// into panels of kPanel rows, the last one padded with zero rows
+void Pack(const EuclideanVectorBatch& rows,
+          int begin,
+          int count,
+          int depthBegin,
+          int depth,
+          double* packed) {
+  const int panels = (count + kPanel - 1) / kPanel;
+  for (int p = 0; p < panels; p++) {
+    double* panel = packed + static_cast<std::size_t>(p) * depth * kPanel;
+    for (int r = 0; r < kPanel; r++) {
+      const int row = p * kPanel + r;
+      if (row >= count) {
+        for (int i = 0; i < depth; i++)
+          panel[i * kPanel + r] = 0.0;
+        continue;
+      }
+      const double* magnitudes =
+          rows.data() + static_cast<std::size_t>(begin + row) * rows.GetStride() + depthBegin;
+      for (int i = 0; i < depth; i++)
+        panel[i * kPanel + r] = magnitudes[i];
+    }
+  }
+}
+
+// Dot products of rows [rowBegin, rowBegin + numRows) of a with rows
+// [columnBegin, columnBegin + numColumns) of b, into scratch.tile (rows kTile apart)
+void DotTile(const EuclideanVectorBatch& a,
+             const EuclideanVectorBatch& b,
+             int rowBegin,
+             int numRows,
+             int columnBegin,
+             int numColumns,
+             Scratch& scratch) {
+  double* tile = scratch.tile.data();
+  std::fill(scratch.tile.begin(), scratch.tile.end(), 0.0);
+  const int rowPanels = (numRows + kPanel - 1) / kPanel;
+  const int columnPanels = (numColumns + kPanel - 1) / kPanel;
+  const int dimensions = a.GetNumDimensions();
+  for (int depthBegin = 0; depthBegin < dimensions; depthBegin += kPairwiseDepth) {
+    const int depth = std::min(kPairwiseDepth, dimensions - depthBegin);
+    Pack(a, rowBegin, numRows, depthBegin, depth, scratch.packedRows.data());
+    Pack(b, columnBegin, numColumns, depthBegin, depth, scratch.packedColumns.data());
+    // One panel of b stays in L1 while the panels of a stream past it from L2
+    for (int q = 0; q < columnPanels; q++) {
+      const double* columns =
+          scratch.packedColumns.data() + static_cast<std::size_t>(q) * depth * kPanel;
+      for (int p = 0; p < rowPanels; p++) {
+        const double* rows =
+            scratch.packedRows.data() + static_cast<std::size_t>(p) * depth * kPanel;
+        ev_kernels::DotPanel(rows, columns, depth, tile + p * kPanel * kTile + q * kPanel, kTile);
+      }
+    }
+  }
+}
+
+int NumTiles(int numVectors) {
+  return (numVectors + kTile - 1) / kTile;
+}
+
+void CheckStride(std::size_t outStride, int numColumns) {
+  if (outStride < static_cast<std::size_t>(numColumns)) {
+    std::ostringstream ss;
+    ss << "Output stride " << outStride << " is smaller than the number of columns "
+       << numColumns;
+    ev_detail::Throw(ss.str());
+  }
+}
+
+void RunTasks(int numTasks, ThreadPool* pool, const std::function<void(int)>& task) {
+  if (pool != nullptr) {
+    pool->ParallelFor(numTasks, task);
+  } else {
+    for (int t = 0; t < numTasks; t++)
+      task(t);
+  }
+}
+
+}  // namespace
+
+std::vector<double> PairwiseDistances(const EuclideanVectorBatch& a,
+                                      const EuclideanVectorBatch& b,
+                                      Metric metric,
+                                      ThreadPool* pool) {
+  std::vector<double> out(static_cast<std::size_t>(a.GetNumVectors()) * b.GetNumVectors());
+  PairwiseDistances(a, b, metric, out.data(), b.GetNumVectors(), pool);
+  return out;
+}
+
+void PairwiseDistances(const EuclideanVectorBatch& a,
+                       const EuclideanVectorBatch& b,
+                       Metric metric,
+                       double* out,
+                       std::size_t outStride,
+                       ThreadPool* pool) {
+  CheckStride(outStride, b.GetNumVectors());
+  PairwiseDistances(
+      a, b, metric,
+      [out, outStride](const PairwiseTile& tile) {
+        for (int r = 0; r < tile.numRows; r++) {
+          const double* values = tile.values + static_cast<std::size_t>(r) * tile.stride;
+          std::copy(values, values + tile.numColumns,
+                    out + (tile.rowBegin + r) * outStride + tile.columnBegin);
+        }
+      },
+      pool);
+}
+
+void PairwiseDistances(const EuclideanVectorBatch& a,
+                       const EuclideanVectorBatch& b,
+                       Metric metric,
+                       const std::function<void(const PairwiseTile&)>& sink,
+                       ThreadPool* pool) {
+  ev_detail::CheckDimensions(a.GetNumDimensions(), b.GetNumDimensions());
+
+  std::optional<EuclideanVectorBatch> aCopy;
+  std::optional<EuclideanVectorBatch> bCopy;
+  const auto& aRows = Prepare(a, metric, aCopy);
+  const auto& bRows = Prepare(b, metric, bCopy);
+  std::vector<double> aSquaredNorms;
+  std::vector<double> bSquaredNorms;
+  if (metric == Metric::kSquaredL2) {
+    aSquaredNorms = SquaredNorms(aRows);
+    bSquaredNorms = SquaredNorms(bRows);
+  }
+
+  const int columnTiles = NumTiles(b.GetNumVectors());
+  RunTasks(NumTiles(a.GetNumVectors()) * columnTiles, pool, [&](int task) {
+    const int rowBegin = task / columnTiles * kTile;
+    const int columnBegin = task % columnTiles * kTile;
+    const int numRows = std::min(kTile, a.GetNumVectors() - rowBegin);
+    const int numColumns = std::min(kTile, b.GetNumVectors() - columnBegin);
+    auto& scratch = ThreadScratch();
+    DotTile(aRows, bRows, rowBegin, numRows, columnBegin, numColumns, scratch);
+
+    if (metric == Metric::kSquaredL2) {
+      for (int r = 0; r < numRows; r++) {
+        double* values = scratch.tile.data() + r * kTile;
+        const double rowNorm = aSquaredNorms[rowBegin + r];
+        // Rounding can take the squared distance of (nearly) identical vectors just below 0
+        for (int c = 0; c < numColumns; c++)
+          values[c] = std::max(rowNorm + bSquaredNorms[columnBegin + c] - 2 * values[c], 0.0);
+      }
+    }
+    sink(PairwiseTile{rowBegin, columnBegin, numRows, numColumns, scratch.tile.data(), kTile});
+  });
+}
+
+std::vector<double> GramMatrix(const EuclideanVectorBatch& a, ThreadPool* pool) {
+  std::vector<double> out(static_cast<std::size_t>(a.GetNumVectors()) * a.GetNumVectors());
+  GramMatrix(a, out.data(), a.GetNumVectors(), pool);
+  return out;
+}
+
+void GramMatrix(const EuclideanVectorBatch& a,
+                double* out,
+                std::size_t outStride,
+                ThreadPool* pool) {
+  CheckStride(outStride, a.GetNumVectors());
+  std::optional<EuclideanVectorBatch> copy;
+  const auto& rows = Prepare(a, Metric::kInnerProduct, copy);
+
+  // Only the tiles on and above the diagonal are computed
+  std::vector<std::pair<int, int>> tiles;
+  for (int rowTile = 0; rowTile < NumTiles(a.GetNumVectors()); rowTile++) {
+    for (int columnTile = rowTile; columnTile < NumTiles(a.GetNumVectors()); columnTile++)
+      tiles.emplace_back(rowTile, columnTile);
+  }
+  RunTasks(static_cast<int>(tiles.size()), pool, [&](int task) {
+    const int rowBegin = tiles[task].first * kTile;
+    const int columnBegin = tiles[task].second * kTile;
+    const int numRows = std::min(kTile, a.GetNumVectors() - rowBegin);
+    const int numColumns = std::min(kTile, a.GetNumVectors() - columnBegin);
+    auto& scratch = ThreadScratch();
+    DotTile(rows, rows, rowBegin, numRows, columnBegin, numColumns, scratch);
+
+    for (int r = 0; r < numRows; r++) {
+      const int i = rowBegin + r;
+      // On the diagonal tile, only the upper triangle is used
+      for (int c = rowBegin == columnBegin ? r : 0; c < numColumns; c++) {
+        const int j = columnBegin + c;
+        out[i * outStride + j] = scratch.tile[r * kTile + c];
+        out[j * outStride + i] = scratch.tile[r * kTile + c];
+      }
+    }
+  });
+}
@@ -0,0 +1,81 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_PAIRWISE_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_PAIRWISE_H_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/euclidean_vector_search.h"
+#include "assignments/ev/thread_pool.h"
+
+/*
+  All-pairs distances between the vectors of two batches, and the Gram matrix of one batch.
+
+  Entry (i, j) is the Metric (see euclidean_vector_search.h) between vector i of a and vector j
+  of b:
+    kSquaredL2    : |a_i|^2 + |b_j|^2 - 2 a_i.b_j, clamped at 0, with the same loss of relative
+                    accuracy for nearby points as ExactSearch
+    kInnerProduct : a_i.b_j
+    kCosine       : a_i.b_j / (|a_i| |b_j|). Zero vectors do not have a cosine similarity.
+  GramMatrix(a) is PairwiseDistances(a, a, kInnerProduct), computed for one triangle and
+  mirrored, so it is exactly symmetric.
+
+  The dot products are a matrix product, computed the way GEMM libraries do it. The output is
+  cut into tiles of kPairwiseTileVectors x kPairwiseTileVectors entries, and each tile walks the
+  dimensions in steps of kPairwiseDepth: the step of its rows and columns is packed into
+  contiguous panels small enough to stay in cache, and ev_kernels::DotPanel multiplies them one
+  8 x 8 register block at a time. With a ThreadPool the tiles are shared between the threads.
+  Every entry is summed in the same order whatever the number of threads, so results are
+  bit-identical from run to run.
+
+  Results either go into a caller-provided row-major matrix (rows outStride doubles apart), into
+  a new std::vector, or are streamed to a callback one tile at a time, so a matrix too large for
+  memory can be reduced (thresholded, top-k per row, written out) as it is computed. With a
+  ThreadPool the callback is called from several threads at once; each tile is passed exactly
+  once, and its values are only valid during the call. A callback that uses the same pool again
+  runs that work serially on its own thread (see ThreadPool).
+*/
+
+constexpr int kPairwiseTileVectors = 128;
+constexpr int kPairwiseDepth = 256;
+
+// Tile of a pairwise matrix: entry (rowBegin + r, columnBegin + c) is values[r * stride + c]
+struct PairwiseTile {
+  int rowBegin;
+  int columnBegin;
+  int numRows;
+  int numColumns;
+  const double* values;
+  int stride;
+};
+
+// a.GetNumVectors() x b.GetNumVectors() entries, row-major
+std::vector<double> PairwiseDistances(const EuclideanVectorBatch& a,
+                                      const EuclideanVectorBatch& b,
+                                      Metric = Metric::kSquaredL2,
+                                      ThreadPool* = nullptr);
+// Writes entry (i, j) to out[i * outStride + j]
+void PairwiseDistances(const EuclideanVectorBatch& a,
+                       const EuclideanVectorBatch& b,
+                       Metric,
+                       double* out,
+                       std::size_t outStride,
+                       ThreadPool* = nullptr);
+void PairwiseDistances(const EuclideanVectorBatch& a,
+                       const EuclideanVectorBatch& b,
+                       Metric,
+                       const std::function<void(const PairwiseTile&)>& sink,
+                       ThreadPool* = nullptr);
+
+// a.GetNumVectors() x a.GetNumVectors() inner products, row-major
+std::vector<double> GramMatrix(const EuclideanVectorBatch& a, ThreadPool* = nullptr);
+void GramMatrix(const EuclideanVectorBatch& a,
+                double* out,
+                std::size_t outStride,
+                ThreadPool* = nullptr);
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_PAIRWISE_H_
@@ -0,0 +1,109 @@
+// Created By : Rahil Agrawal
+//
+// All-pairs squared distances between 2^11 and 2^11 vectors, against the loop they replace:
+// EuclideanVector(a - b).GetEuclideanNorm() for every pair, which allocates once per pair.
+//
+// Reports pairs/s (items_per_second) for the naive loop, PairwiseDistances on one thread and on
+// a ThreadPool with every hardware thread, and GramMatrix, for 16 to 1024 dimensions. The
+// counter "GFLOPS" counts the 2 * n flops of each dot product.
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/euclidean_vector_pairwise.h"
+#include "assignments/ev/euclidean_vector_testing.h"
+#include "assignments/ev/thread_pool.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+constexpr int kVectors = 1 << 11;
+
+ThreadPool& Pool() {
+  static ThreadPool pool{static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
+  return pool;
+}
+
+void SetCounters(benchmark::State& state, std::int64_t pairs) {
+  state.SetItemsProcessed(state.iterations() * pairs);
+  state.counters["GFLOPS"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * pairs * 2 * state.range(0)) / 1e9,
+      benchmark::Counter::kIsRate);
+}
+
+void BM_NaiveLoop(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto a = ev_testing::RandomVectors(kVectors, n, 1);
+  const auto b = ev_testing::RandomVectors(kVectors, n, 2);
+  std::vector<double> out(static_cast<std::size_t>(kVectors) * kVectors);
+  for (auto _ : state) {
+    for (int i = 0; i < kVectors; i++) {
+      for (int j = 0; j < kVectors; j++) {
+        const double distance = EuclideanVector(a[i] - b[j]).GetEuclideanNorm();
+        out[static_cast<std::size_t>(i) * kVectors + j] = distance * distance;
+      }
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  SetCounters(state, static_cast<std::int64_t>(kVectors) * kVectors);
+}
+
+void BM_PairwiseDistances(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto a = EuclideanVectorBatch(ev_testing::RandomVectors(kVectors, n, 1));
+  const auto b = EuclideanVectorBatch(ev_testing::RandomVectors(kVectors, n, 2));
+  std::vector<double> out(static_cast<std::size_t>(kVectors) * kVectors);
+  for (auto _ : state) {
+    PairwiseDistances(a, b, Metric::kSquaredL2, out.data(), kVectors);
+    benchmark::DoNotOptimize(out.data());
+  }
+  SetCounters(state, static_cast<std::int64_t>(kVectors) * kVectors);
+}
+
+void BM_PairwiseDistancesThreads(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto a = EuclideanVectorBatch(ev_testing::RandomVectors(kVectors, n, 1));
+  const auto b = EuclideanVectorBatch(ev_testing::RandomVectors(kVectors, n, 2));
+  std::vector<double> out(static_cast<std::size_t>(kVectors) * kVectors);
+  for (auto _ : state) {
+    PairwiseDistances(a, b, Metric::kSquaredL2, out.data(), kVectors, &Pool());
+    benchmark::DoNotOptimize(out.data());
+  }
+  SetCounters(state, static_cast<std::int64_t>(kVectors) * kVectors);
+}
+
+// Computes half the dot products of PairwiseDistances
+void BM_GramMatrixThreads(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto a = EuclideanVectorBatch(ev_testing::RandomVectors(kVectors, n, 1));
+  std::vector<double> out(static_cast<std::size_t>(kVectors) * kVectors);
+  for (auto _ : state) {
+    GramMatrix(a, out.data(), kVectors, &Pool());
+    benchmark::DoNotOptimize(out.data());
+  }
+  SetCounters(state, static_cast<std::int64_t>(kVectors) * kVectors);
+}
+
+BENCHMARK(BM_NaiveLoop)->RangeMultiplier(4)->Range(16, 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PairwiseDistances)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PairwiseDistancesThreads)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_GramMatrixThreads)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,188 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Every entry of PairwiseDistances is checked against the same distance computed pair by pair
+  with the plain EuclideanVector operations, within the bound of the dot products it is made
+  of. The batches hold a number of vectors that is not a multiple of the tile or panel size,
+  and vectors with more dimensions than kPairwiseDepth, so that partial tiles, padded panels
+  and several depth steps are all exercised.
+
+  The results with a ThreadPool, from a structure of arrays batch, and streamed tile by tile
+  must be the very same numbers. GramMatrix must be exactly symmetric and equal to the inner
+  products of PairwiseDistances.
+  Failure scenarios follow the EuclideanVector error messages.
+
+*/
+
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/euclidean_vector_pairwise.h"
+#include "assignments/ev/euclidean_vector_testing.h"
+#include "assignments/ev/thread_pool.h"
+#include "catch.h"
+
+namespace {
+
+// The entry computed with the EuclideanVector operations
+double Reference(const EuclideanVector& a, const EuclideanVector& b, Metric metric) {
+  if (metric == Metric::kSquaredL2) {
+    auto distance = EuclideanVector(a - b).GetEuclideanNorm();
+    return distance * distance;
+  }
+  if (metric == Metric::kInnerProduct)
+    return a * b;
+  return a * b / (a.GetEuclideanNorm() * b.GetEuclideanNorm());
+}
+
+// 4 * n * DBL_EPSILON * |a| |b| bounds the error of a dot product; the squared distance adds
+// up three such terms
+double Bound(const EuclideanVector& a, const EuclideanVector& b, Metric metric) {
+  const double n = a.GetNumDimensions();
+  const double na = a.GetEuclideanNorm();
+  const double nb = b.GetEuclideanNorm();
+  if (metric == Metric::kSquaredL2)
+    return 8 * n * DBL_EPSILON * (na * na + nb * nb);
+  if (metric == Metric::kInnerProduct)
+    return 4 * n * DBL_EPSILON * na * nb;
+  return 8 * n * DBL_EPSILON;
+}
+
+}  // namespace
+
+SCENARIO("Compute the distances between every pair of vectors of two batches") {
+  for (int n : {3, 300}) {
+    GIVEN("That there are batches of 300 and 137 vectors with " + std::to_string(n) +
+          " dimensions") {
+      const auto vectorsA = ev_testing::RandomVectors(300, n, 1);
+      const auto vectorsB = ev_testing::RandomVectors(137, n, 2);
+      const auto a = EuclideanVectorBatch(vectorsA);
+      const auto b = EuclideanVectorBatch(vectorsB);
+      for (auto metric : {Metric::kSquaredL2, Metric::kInnerProduct, Metric::kCosine}) {
+        WHEN("The pairwise distances with metric " +
+             std::to_string(static_cast<int>(metric)) + " are computed") {
+          const auto distances = PairwiseDistances(a, b, metric);
+          THEN("Every entry is within the bound of the distance of its pair") {
+            REQUIRE(distances.size() == 300 * 137);
+            for (int i = 0; i < 300; i++) {
+              for (int j = 0; j < 137; j++) {
+                REQUIRE(std::abs(distances[i * 137 + j] -
+                                 Reference(vectorsA[i], vectorsB[j], metric)) <=
+                        Bound(vectorsA[i], vectorsB[j], metric));
+              }
+            }
+          }
+          AND_WHEN("They are computed with a ThreadPool of 4 threads") {
+            auto pool = ThreadPool(4);
+            THEN("The entries are identical") {
+              REQUIRE(PairwiseDistances(a, b, metric, &pool) == distances);
+            }
+          }
+          AND_WHEN("They are computed from a structure of arrays batch") {
+            auto soa = a.ToLayout(EuclideanVectorBatch::Layout::kStructureOfArrays);
+            THEN("The entries are identical") {
+              REQUIRE(PairwiseDistances(soa, b, metric) == distances);
+            }
+          }
+          AND_WHEN("They are written into a matrix with rows 140 doubles apart") {
+            std::vector<double> out(300 * 140, -1.0);
+            PairwiseDistances(a, b, metric, out.data(), 140);
+            THEN("The entries are identical and the padding is untouched") {
+              for (int i = 0; i < 300; i++) {
+                for (int j = 0; j < 137; j++)
+                  REQUIRE(out[i * 140 + j] == distances[i * 137 + j]);
+                for (int j = 137; j < 140; j++)
+                  REQUIRE(out[i * 140 + j] == -1.0);
+              }
+            }
+          }
+          AND_WHEN("They are streamed tile by tile") {
+            std::vector<double> out(300 * 137, -1.0);
+            std::vector<int> visits(300 * 137, 0);
+            PairwiseDistances(a, b, metric, [&](const PairwiseTile& tile) {
+              for (int r = 0; r < tile.numRows; r++) {
+                for (int c = 0; c < tile.numColumns; c++) {
+                  const int entry = (tile.rowBegin + r) * 137 + tile.columnBegin + c;
+                  out[entry] = tile.values[r * tile.stride + c];
+                  visits[entry]++;
+                }
+              }
+            });
+            THEN("Every entry is passed exactly once with the same value") {
+              REQUIRE(out == distances);
+              REQUIRE(visits == std::vector<int>(300 * 137, 1));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Compute the Gram matrix of a batch") {
+  GIVEN("That there is a batch of 300 vectors with 260 dimensions") {
+    const auto a = EuclideanVectorBatch(ev_testing::RandomVectors(300, 260, 3));
+    WHEN("Its Gram matrix is computed") {
+      const auto gram = GramMatrix(a);
+      const auto products = PairwiseDistances(a, a, Metric::kInnerProduct);
+      THEN("It is exactly symmetric and made of the inner products of PairwiseDistances") {
+        for (int i = 0; i < 300; i++) {
+          for (int j = i; j < 300; j++) {
+            REQUIRE(gram[i * 300 + j] == products[i * 300 + j]);
+            REQUIRE(gram[j * 300 + i] == gram[i * 300 + j]);
+          }
+        }
+      }
+      AND_WHEN("It is computed with a ThreadPool of 4 threads") {
+        auto pool = ThreadPool(4);
+        THEN("The entries are identical") { REQUIRE(GramMatrix(a, &pool) == gram); }
+      }
+    }
+  }
+  GIVEN("That there is a batch with no vectors") {
+    const auto a = EuclideanVectorBatch(0, 4);
+    WHEN("Its Gram matrix and distances are computed") {
+      THEN("They have no entries") {
+        REQUIRE(GramMatrix(a).empty());
+        REQUIRE(
+            PairwiseDistances(a, EuclideanVectorBatch(ev_testing::RandomVectors(3, 4, 4))).empty());
+      }
+    }
+  }
+}
+
+SCENARIO("Compute pairwise distances with invalid arguments") {
+  GIVEN("That there are batches of vectors with 3 and 4 dimensions") {
+    const auto a = EuclideanVectorBatch(ev_testing::RandomVectors(5, 3, 5));
+    const auto b = EuclideanVectorBatch(ev_testing::RandomVectors(5, 4, 6));
+    WHEN("Their pairwise distances are computed") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(PairwiseDistances(a, b),
+                            "Dimensions of LHS(3) and RHS(4) do not match");
+      }
+    }
+    WHEN("The distances of a with itself are written with rows 4 doubles apart") {
+      std::vector<double> out(5 * 4);
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(PairwiseDistances(a, a, Metric::kSquaredL2, out.data(), 4),
+                            "Output stride 4 is smaller than the number of columns 5");
+      }
+    }
+  }
+  GIVEN("That there is a batch with a zero vector") {
+    const auto a = EuclideanVectorBatch(2, 4);
+    WHEN("Its cosine similarities are computed") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(
+            PairwiseDistances(a, a, Metric::kCosine),
+            "EuclideanVector with euclidean normal of 0 does not have a unit vector");
+      }
+    }
+  }
+}
@@ -0,0 +1,59 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/euclidean_vector_parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_kernels.h"
+
+namespace {
+
+// Sums partials[begin, end) as a balanced binary tree whose shape depends only on the count
+double PairwiseSum(const std::vector<double>& partials, int begin, int end) {
+  if (end - begin == 1)
+    return partials[begin];
+  const int middle = begin + (end - begin) / 2;
+  return PairwiseSum(partials, begin, middle) + PairwiseSum(partials, middle, end);
+}
+
+template <typename ChunkReduction>
+double ChunkedSum(int length, ThreadPool& pool, ChunkReduction reduce) {
+  const int numChunks = (length + kParallelChunkDimensions - 1) / kParallelChunkDimensions;
+  std::vector<double> partials(numChunks);
+  pool.ParallelFor(numChunks, [&](int chunk) {
+    const int begin = chunk * kParallelChunkDimensions;
+    partials[chunk] = reduce(begin, std::min(kParallelChunkDimensions, length - begin));
+  });
+  return PairwiseSum(partials, 0, numChunks);
+}
+
+}  // namespace
+
+double ParallelEuclideanNorm(const EuclideanVector& v, ThreadPool& pool, int serialThreshold) {
+  const int length = v.GetNumDimensions();
+  if (length < std::max(serialThreshold, 1))
+    return v.GetEuclideanNorm();
+
+  const double* mags = v.data();
+  return std::sqrt(ChunkedSum(length, pool, [mags](int begin, int count) {
+    return ev_kernels::SumOfSquares(mags + begin, count);
+  }));
+}
+
+double ParallelDot(const EuclideanVector& u,
+                   const EuclideanVector& v,
+                   ThreadPool& pool,
+                   int serialThreshold) {
+  ev_detail::CheckDimensions(u.GetNumDimensions(), v.GetNumDimensions());
+  const int length = u.GetNumDimensions();
+  if (length < std::max(serialThreshold, 1))
+    return u * v;
+
+  const double* a = u.data();
+  const double* b = v.data();
+  return ChunkedSum(length, pool, [a, b](int begin, int count) {
+    return ev_kernels::Dot(a + begin, b + begin, count);
+  });
+}
@@ -0,0 +1,32 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_PARALLEL_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_PARALLEL_H_
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/thread_pool.h"
+
+/*
+  Multithreaded GetEuclideanNorm and dot product, for vectors with millions of dimensions.
+
+  The vector is cut into chunks of kParallelChunkDimensions (the cut does not depend on the
+  number of threads). Each chunk is reduced by the SIMD kernels, and the partial sums are then
+  combined with a fixed pairwise tree. The result is therefore bit-identical from run to run,
+  whatever the number of threads, on a given machine.
+
+  Vectors with fewer than serialThreshold dimensions skip the pool and give exactly the same
+  result as GetEuclideanNorm() / operator*.
+*/
+
+constexpr int kParallelChunkDimensions = 1 << 15;
+constexpr int kParallelThreshold = 1 << 18;
+
+double ParallelEuclideanNorm(const EuclideanVector&,
+                             ThreadPool&,
+                             int serialThreshold = kParallelThreshold);
+double ParallelDot(const EuclideanVector&,
+                   const EuclideanVector&,
+                   ThreadPool&,
+                   int serialThreshold = kParallelThreshold);
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_PARALLEL_H_
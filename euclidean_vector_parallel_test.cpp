@@ -0,0 +1,142 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The parallel reductions promise three things, each tested here:
+    - below the threshold they are exactly GetEuclideanNorm() and operator*
+    - above it they are bit-identical between runs and between thread counts
+    - they stay close to the serial result and report errors like EuclideanVector
+
+  The ThreadPool they run on is tested through ParallelFor directly.
+
+*/
+
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_parallel.h"
+#include "assignments/ev/euclidean_vector_testing.h"
+#include "assignments/ev/thread_pool.h"
+#include "catch.h"
+
+namespace {
+
+EuclideanVector RandomVector(int n, unsigned seed) {
+  return ev_testing::RandomVectors(1, n, seed)[0];
+}
+
+}  // namespace
+
+SCENARIO("Run tasks on a ThreadPool") {
+  GIVEN("That there is a pool with 4 threads") {
+    ThreadPool pool{4};
+    REQUIRE(pool.GetNumThreads() == 4);
+    WHEN("1000 tasks are run") {
+      std::vector<int> runs(1000, 0);
+      pool.ParallelFor(1000, [&](int i) { runs[i]++; });
+      THEN("Every task ran exactly once") {
+        for (auto r : runs)
+          REQUIRE(r == 1);
+      }
+    }
+    WHEN("Every task runs a nested ParallelFor on the same pool") {
+      std::vector<int> runs(100 * 10, 0);
+      pool.ParallelFor(100, [&](int i) {
+        pool.ParallelFor(10, [&](int j) { runs[i * 10 + j]++; });
+      });
+      THEN("Every nested task ran exactly once, without a deadlock") {
+        for (auto r : runs)
+          REQUIRE(r == 1);
+      }
+    }
+    WHEN("A task throws") {
+      std::atomic<int> finished{0};
+      try {
+        pool.ParallelFor(100, [&](int i) {
+          if (i == 50)
+            throw std::runtime_error("task 50 failed");
+          finished++;
+        });
+      } catch (const std::runtime_error& e) {
+        THEN("The exception reaches the caller after the other tasks have finished") {
+          REQUIRE(std::string(e.what()) == "task 50 failed");
+          REQUIRE(finished == 99);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Compute the norm and dot product of large vectors on several threads") {
+  GIVEN("That there are two vectors with 1000003 dimensions") {
+    auto u = RandomVector(1000003, 1);
+    auto v = RandomVector(1000003, 2);
+    WHEN("The norm and dot product are computed with 1, 2, 3 and 8 threads") {
+      std::vector<double> norms;
+      std::vector<double> dots;
+      for (int threads : {1, 2, 3, 8}) {
+        ThreadPool pool{threads};
+        for (int run = 0; run < 3; run++) {
+          norms.push_back(ParallelEuclideanNorm(u, pool));
+          dots.push_back(ParallelDot(u, v, pool));
+        }
+      }
+      THEN("Every run gives bit-identical results") {
+        for (auto norm : norms)
+          REQUIRE(norm == norms.front());
+        for (auto dot : dots)
+          REQUIRE(dot == dots.front());
+      }
+      THEN("The results are close to the serial results") {
+        REQUIRE(norms.front() == Approx(u.GetEuclideanNorm()).epsilon(1e-12));
+        REQUIRE(dots.front() == Approx(u * v).epsilon(1e-9));
+      }
+    }
+  }
+  GIVEN("That there is a vector below the serial threshold") {
+    auto u = RandomVector(1000, 3);
+    auto v = RandomVector(1000, 4);
+    ThreadPool pool{4};
+    WHEN("The parallel norm and dot product are computed") {
+      THEN("They are exactly the serial results") {
+        REQUIRE(ParallelEuclideanNorm(u, pool) == u.GetEuclideanNorm());
+        REQUIRE(ParallelDot(u, v, pool) == u * v);
+      }
+    }
+  }
+  GIVEN("That there are vectors with different dimensions") {
+    auto u = EuclideanVector(5, 1.0);
+    auto v = EuclideanVector(4, 1.0);
+    ThreadPool pool{2};
+    WHEN("Their parallel dot product is computed") {
+      try {
+        auto dotProd = ParallelDot(u, v, pool, 0);
+        std::cerr << dotProd << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Dimensions of LHS(5) and RHS(4) do not match") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Dimensions of LHS(5) and RHS(4) do not match") == 0);
+        }
+      }
+    }
+  }
+  GIVEN("That there is a vector with 0 dimensions") {
+    auto u = EuclideanVector(0);
+    ThreadPool pool{2};
+    WHEN("Its parallel norm is computed") {
+      try {
+        auto norm = ParallelEuclideanNorm(u, pool, 0);
+        std::cerr << norm << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : EuclideanVector with no dimensions does not have a norm") {
+          std::string err = e.what();
+          REQUIRE(err.compare("EuclideanVector with no dimensions does not have a norm") == 0);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,181 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/euclidean_vector_search.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_kernels.h"
+
+namespace {
+
+// Bytes of database rows processed against every query of a group before moving on
+constexpr std::size_t kSearchBlockBytes = 1 << 17;
+constexpr int kQueryGroup = 4;
+
+// Smaller keys are nearer: |x|^2 - 2 q.x for kSquaredL2, -q.x otherwise
+struct Candidate {
+  double key;
+  int index;
+};
+
+bool Nearer(const Candidate& a, const Candidate& b) noexcept {
+  return a.key < b.key || (a.key == b.key && a.index < b.index);
+}
+
+// Keeps the k nearest candidates pushed so far, the farthest of them at the front
+void Push(std::vector<Candidate>& heap, int k, Candidate candidate) {
+  if (static_cast<int>(heap.size()) < k) {
+    heap.push_back(candidate);
+    std::push_heap(heap.begin(), heap.end(), Nearer);
+  } else if (k > 0 && Nearer(candidate, heap.front())) {
+    std::pop_heap(heap.begin(), heap.end(), Nearer);
+    heap.back() = candidate;
+    std::push_heap(heap.begin(), heap.end(), Nearer);
+  }
+}
+
+EuclideanVectorBatch RowMajor(const EuclideanVectorBatch& b) {
+  if (b.GetLayout() == EuclideanVectorBatch::Layout::kRowMajor)
+    return b;
+  return b.ToLayout(EuclideanVectorBatch::Layout::kRowMajor);
+}
+
+}  // namespace
+
+// Constructors
+
+ExactSearch::ExactSearch(const std::vector<EuclideanVector>& vectors, Metric metric)
+  : ExactSearch(EuclideanVectorBatch(vectors), metric) {}
+
+ExactSearch::ExactSearch(const EuclideanVectorBatch& vectors, Metric metric)
+  : database_{RowMajor(vectors)}, metric_{metric} {
+  if (metric_ == Metric::kCosine)
+    database_.Normalize();
+  if (metric_ == Metric::kSquaredL2) {
+    squaredNorms_.resize(GetNumVectors());
+    for (int r = 0; r < GetNumVectors(); r++) {
+      const double* row = database_.data() + static_cast<std::size_t>(r) * database_.GetStride();
+      squaredNorms_[r] = ev_kernels::SumOfSquares(row, GetNumDimensions());
+    }
+  }
+}
+
+// Methods
+
+std::vector<Neighbour> ExactSearch::Search(const EuclideanVector& query,
+                                           int k,
+                                           ThreadPool* pool) const {
+  return std::move(SearchQueries(&query, 1, k, pool).front());
+}
+
+std::vector<std::vector<Neighbour>> ExactSearch::Search(
+    const std::vector<EuclideanVector>& queries,
+    int k,
+    ThreadPool* pool) const {
+  return SearchQueries(queries.data(), static_cast<int>(queries.size()), k, pool);
+}
+
+// Helpers
+
+std::vector<std::vector<Neighbour>> ExactSearch::SearchQueries(const EuclideanVector* queries,
+                                                               int numQueries,
+                                                               int k,
+                                                               ThreadPool* pool) const {
+  if (k < 0) {
+    std::ostringstream ss;
+    ss << "Number of neighbours " << k << " is not valid";
+    ev_detail::Throw(ss.str());
+  }
+  for (int q = 0; q < numQueries; q++)
+    ev_detail::CheckDimensions(queries[q].GetNumDimensions(), GetNumDimensions());
+
+  const int dimensions = GetNumDimensions();
+  // Cosine compares unit vectors; the other metrics use the queries as they are
+  std::vector<EuclideanVector> unitQueries;
+  if (metric_ == Metric::kCosine) {
+    unitQueries.reserve(numQueries);
+    for (int q = 0; q < numQueries; q++)
+      unitQueries.push_back(queries[q].CreateUnitVector());
+  }
+  const EuclideanVector* searched = metric_ == Metric::kCosine ? unitQueries.data() : queries;
+
+  const int numChunks = (GetNumVectors() + kSearchChunkVectors - 1) / kSearchChunkVectors;
+  const std::size_t rowBytes = sizeof(double) * std::max(database_.GetStride(), 1);
+  const int blockRows = std::max(1, static_cast<int>(kSearchBlockBytes / rowBytes));
+  // heaps[q]: the k nearest rows to query q found so far
+  std::vector<std::vector<Candidate>> heaps(numQueries);
+  for (auto& heap : heaps)
+    heap.reserve(std::min(k, GetNumVectors()));
+
+  // Pushes the rows of the chunk into chunkHeaps[q] for every query q
+  auto searchChunk = [&](int chunk, std::vector<Candidate>* chunkHeaps) {
+    const int chunkBegin = chunk * kSearchChunkVectors;
+    const int chunkEnd = std::min(chunkBegin + kSearchChunkVectors, GetNumVectors());
+    for (int q = 0; q < numQueries; q++)
+      chunkHeaps[q].reserve(std::min(k, chunkEnd - chunkBegin));
+
+    for (int blockBegin = chunkBegin; blockBegin < chunkEnd; blockBegin += blockRows) {
+      const int blockEnd = std::min(blockBegin + blockRows, chunkEnd);
+      for (int group = 0; group < numQueries; group += kQueryGroup) {
+        const int groupSize = std::min(kQueryGroup, numQueries - group);
+        // A short last group repeats its last query; the repeated results are ignored
+        const double* groupQueries[kQueryGroup];
+        for (int j = 0; j < kQueryGroup; j++)
+          groupQueries[j] = searched[group + std::min(j, groupSize - 1)].data();
+
+        for (int r = blockBegin; r < blockEnd; r++) {
+          double dots[kQueryGroup];
+          ev_kernels::Dot4(database_.data() + static_cast<std::size_t>(r) * database_.GetStride(),
+                           groupQueries, dimensions, dots);
+          for (int j = 0; j < groupSize; j++) {
+            const double key =
+                metric_ == Metric::kSquaredL2 ? squaredNorms_[r] - 2 * dots[j] : -dots[j];
+            Push(chunkHeaps[group + j], k, Candidate{key, r});
+          }
+        }
+      }
+    }
+  };
+  if (pool != nullptr) {
+    // Each chunk in flight keeps its own heaps and merges them as soon as it finishes, so there
+    // are at most k candidates per query per thread rather than per chunk
+    std::mutex merge;
+    pool->ParallelFor(numChunks, [&](int chunk) {
+      std::vector<std::vector<Candidate>> chunkHeaps(numQueries);
+      searchChunk(chunk, chunkHeaps.data());
+      std::lock_guard<std::mutex> lock{merge};
+      for (int q = 0; q < numQueries; q++) {
+        for (const auto& candidate : chunkHeaps[q])
+          Push(heaps[q], k, candidate);
+      }
+    });
+  } else {
+    for (int chunk = 0; chunk < numChunks; chunk++)
+      searchChunk(chunk, heaps.data());
+  }
+
+  // Nearer is a total order, so the k nearest are the same whatever order chunks were merged in
+  std::vector<std::vector<Neighbour>> results(numQueries);
+  for (int q = 0; q < numQueries; q++) {
+    auto& heap = heaps[q];
+    std::sort_heap(heap.begin(), heap.end(), Nearer);
+
+    const double queryShift = metric_ == Metric::kSquaredL2
+                                  ? ev_kernels::SumOfSquares(queries[q].data(), dimensions)
+                                  : 0.0;
+    results[q].reserve(heap.size());
+    for (const auto& candidate : heap) {
+      // Rounding can take the squared distance of (nearly) identical vectors just below 0
+      const double score = metric_ == Metric::kSquaredL2
+                               ? std::max(candidate.key + queryShift, 0.0)
+                               : -candidate.key;
+      results[q].push_back(Neighbour{candidate.index, score});
+    }
+  }
+  return results;
+}
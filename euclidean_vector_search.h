@@ -0,0 +1,78 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_SEARCH_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_SEARCH_H_
+
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/thread_pool.h"
+
+/*
+  Exact (brute force) k-nearest-neighbour search over a fixed collection of vectors.
+
+  Metrics
+    kSquaredL2    : |q - x|^2, nearest first. Computed as |x|^2 - 2 q.x + |q|^2 with |x|^2
+                    precomputed, so no difference vector and no square root is ever formed.
+                    Like every expansion of this kind it loses relative accuracy for points
+                    much closer to each other than to the origin.
+    kInnerProduct : q.x, largest first.
+    kCosine       : q.x / (|q| |x|), largest first. The collection and the queries are
+                    normalised once, so a zero vector cannot be searched or searched for.
+
+  The collection is stored as a row-major EuclideanVectorBatch. Queries are processed four at a
+  time against blocks of rows small enough to stay in cache (ev_kernels::Dot4), so a block is
+  read from memory once per four queries rather than once per query, and each query keeps a
+  bounded heap of its best k candidates.
+
+  With a ThreadPool the collection is split into chunks of kSearchChunkVectors rows, and each
+  chunk merges its heaps into those of the queries as soon as it finishes, so memory grows with
+  the number of threads and not with the size of the collection. Ties are broken by the smaller
+  index, so the k nearest are unique and results are identical whatever the number of threads
+  and the order in which chunks finish.
+*/
+
+enum class Metric { kSquaredL2, kInnerProduct, kCosine };
+
+struct Neighbour {
+  // Row of the collection
+  int index;
+  // Squared distance for kSquaredL2, dot product or cosine similarity otherwise
+  double score;
+};
+
+constexpr int kSearchChunkVectors = 1 << 12;
+
+class ExactSearch {
+ public:
+  // Constructors
+  // The vectors must all have the same number of dimensions
+  explicit ExactSearch(const std::vector<EuclideanVector>&, Metric = Metric::kSquaredL2);
+  explicit ExactSearch(const EuclideanVectorBatch&, Metric = Metric::kSquaredL2);
+
+  // Methods
+  // The min(k, GetNumVectors()) nearest vectors to the query, nearest first
+  std::vector<Neighbour> Search(const EuclideanVector& query, int k, ThreadPool* = nullptr) const;
+  // The nearest vectors to each of the queries, searched together
+  std::vector<std::vector<Neighbour>> Search(const std::vector<EuclideanVector>& queries,
+                                             int k,
+                                             ThreadPool* = nullptr) const;
+  int GetNumVectors() const noexcept { return database_.GetNumVectors(); }
+  int GetNumDimensions() const noexcept { return database_.GetNumDimensions(); }
+  Metric GetMetric() const noexcept { return metric_; }
+
+ private:
+  // Searches queries[0], ..., queries[numQueries - 1], wherever they are stored
+  std::vector<std::vector<Neighbour>> SearchQueries(const EuclideanVector* queries,
+                                                    int numQueries,
+                                                    int k,
+                                                    ThreadPool*) const;
+
+  EuclideanVectorBatch database_;
+  // |x|^2 of every row, for kSquaredL2
+  std::vector<double> squaredNorms_;
+  Metric metric_;
+};
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_SEARCH_H_
@@ -0,0 +1,75 @@
+// Created By : Rahil Agrawal
+//
+// Exact top-10 search over 2^16 vectors, against the loop it replaces: computing
+// EuclideanVector(q - v).GetEuclideanNorm() for every vector and sorting.
+//
+// Reports queries/s (items_per_second) for one query at a time, a batch of 16 queries, and the
+// batch on a ThreadPool with every hardware thread, for 16 to 512 dimensions.
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_search.h"
+#include "assignments/ev/euclidean_vector_testing.h"
+#include "assignments/ev/thread_pool.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+constexpr int kDatabaseVectors = 1 << 16;
+constexpr int kBatchQueries = 16;
+constexpr int kNeighbours = 10;
+
+void BM_NaiveLoop(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  auto vectors = ev_testing::RandomVectors(kDatabaseVectors, n, 1);
+  auto query = ev_testing::RandomVectors(1, n, 2).front();
+  std::vector<std::pair<double, int>> distances(kDatabaseVectors);
+  for (auto _ : state) {
+    for (int i = 0; i < kDatabaseVectors; i++)
+      distances[i] = {EuclideanVector(query - vectors[i]).GetEuclideanNorm(), i};
+    std::partial_sort(distances.begin(), distances.begin() + kNeighbours, distances.end());
+    benchmark::DoNotOptimize(distances.front());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ExactSearch(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  auto search = ExactSearch(ev_testing::RandomVectors(kDatabaseVectors, n, 1));
+  auto query = ev_testing::RandomVectors(1, n, 2).front();
+  for (auto _ : state)
+    benchmark::DoNotOptimize(search.Search(query, kNeighbours));
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ExactSearchBatch(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  auto search = ExactSearch(ev_testing::RandomVectors(kDatabaseVectors, n, 1));
+  auto queries = ev_testing::RandomVectors(kBatchQueries, n, 2);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(search.Search(queries, kNeighbours));
+  state.SetItemsProcessed(state.iterations() * kBatchQueries);
+}
+
+void BM_ExactSearchBatchThreads(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  auto search = ExactSearch(ev_testing::RandomVectors(kDatabaseVectors, n, 1));
+  auto queries = ev_testing::RandomVectors(kBatchQueries, n, 2);
+  auto pool = ThreadPool(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(search.Search(queries, kNeighbours, &pool));
+  state.SetItemsProcessed(state.iterations() * kBatchQueries);
+}
+
+BENCHMARK(BM_NaiveLoop)->RangeMultiplier(4)->Range(16, 512);
+BENCHMARK(BM_ExactSearch)->RangeMultiplier(4)->Range(16, 512);
+BENCHMARK(BM_ExactSearchBatch)->RangeMultiplier(4)->Range(16, 512);
+BENCHMARK(BM_ExactSearchBatchThreads)->RangeMultiplier(4)->Range(16, 512)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,198 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  ExactSearch must return exactly what sorting the whole collection by the metric would, so
+  every metric is checked against a reference that computes (q - x).GetEuclideanNorm(), q * x
+  and the cosine with the plain EuclideanVector operations for every vector and sorts them.
+
+  The collections are larger than kSearchChunkVectors, and the number of queries is not a
+  multiple of four, so that the chunking, the row blocking and the partial query groups are all
+  exercised. Searching with a ThreadPool must give the very same results (indices and scores)
+  as searching without one.
+  Failure scenarios follow the EuclideanVector error messages.
+
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/euclidean_vector_search.h"
+#include "assignments/ev/euclidean_vector_testing.h"
+#include "assignments/ev/thread_pool.h"
+#include "catch.h"
+
+namespace {
+
+// Score of every vector with the EuclideanVector operations, sorted nearest first
+std::vector<Neighbour> Reference(const std::vector<EuclideanVector>& vectors,
+                                 const EuclideanVector& query,
+                                 Metric metric,
+                                 int k) {
+  std::vector<Neighbour> all;
+  for (int i = 0; i < static_cast<int>(vectors.size()); i++) {
+    double score = 0.0;
+    if (metric == Metric::kSquaredL2) {
+      auto distance = EuclideanVector(query - vectors[i]).GetEuclideanNorm();
+      score = distance * distance;
+    } else if (metric == Metric::kInnerProduct) {
+      score = query * vectors[i];
+    } else {
+      score = query * vectors[i] / (query.GetEuclideanNorm() * vectors[i].GetEuclideanNorm());
+    }
+    all.push_back(Neighbour{i, score});
+  }
+  std::sort(all.begin(), all.end(), [metric](const Neighbour& a, const Neighbour& b) {
+    return metric == Metric::kSquaredL2 ? a.score < b.score : a.score > b.score;
+  });
+  all.resize(std::min<std::size_t>(k, all.size()));
+  return all;
+}
+
+}  // namespace
+
+SCENARIO("Find the nearest neighbours of a batch of queries") {
+  const auto vectors = ev_testing::RandomVectors(kSearchChunkVectors * 2 + 123, 13, 1);
+  const auto queries = ev_testing::RandomVectors(7, 13, 2);
+  for (auto metric : {Metric::kSquaredL2, Metric::kInnerProduct, Metric::kCosine}) {
+    GIVEN("That there is an exact search over " + std::to_string(vectors.size()) +
+          " vectors with metric " + std::to_string(static_cast<int>(metric))) {
+      auto search = ExactSearch(vectors, metric);
+      REQUIRE(search.GetNumVectors() == static_cast<int>(vectors.size()));
+      REQUIRE(search.GetNumDimensions() == 13);
+      REQUIRE(search.GetMetric() == metric);
+      WHEN("The 10 nearest neighbours of 7 queries are searched together") {
+        auto results = search.Search(queries, 10);
+        THEN("They are the 10 best vectors of the reference, in order") {
+          REQUIRE(results.size() == 7);
+          for (int q = 0; q < 7; q++) {
+            auto expected = Reference(vectors, queries[q], metric, 10);
+            REQUIRE(results[q].size() == 10);
+            for (int i = 0; i < 10; i++) {
+              REQUIRE(results[q][i].index == expected[i].index);
+              REQUIRE(results[q][i].score == Approx(expected[i].score).margin(1e-12));
+            }
+          }
+        }
+        AND_WHEN("They are searched one at a time") {
+          THEN("The results are the same") {
+            for (int q = 0; q < 7; q++) {
+              auto single = search.Search(queries[q], 10);
+              for (int i = 0; i < 10; i++) {
+                REQUIRE(single[i].index == results[q][i].index);
+                REQUIRE(single[i].score == results[q][i].score);
+              }
+            }
+          }
+        }
+        AND_WHEN("They are searched with a ThreadPool of 4 threads") {
+          auto pool = ThreadPool(4);
+          auto parallel = search.Search(queries, 10, &pool);
+          THEN("The results are identical") {
+            for (int q = 0; q < 7; q++) {
+              for (int i = 0; i < 10; i++) {
+                REQUIRE(parallel[q][i].index == results[q][i].index);
+                REQUIRE(parallel[q][i].score == results[q][i].score);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Search collections with few vectors or equal scores") {
+  GIVEN("That there is a search over 3 vectors") {
+    auto vectors = ev_testing::RandomVectors(3, 4, 3);
+    auto search = ExactSearch(vectors);
+    WHEN("More neighbours than vectors are searched") {
+      auto results = search.Search(vectors[1], 5);
+      THEN("Every vector is returned, the query itself first at distance 0") {
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0].index == 1);
+        REQUIRE(results[0].score == Approx(0.0).margin(1e-12));
+      }
+    }
+    WHEN("0 neighbours are searched") {
+      THEN("Nothing is returned") { REQUIRE(search.Search(vectors[0], 0).empty()); }
+    }
+  }
+  GIVEN("That there is a search over identical vectors") {
+    auto search = ExactSearch(std::vector<EuclideanVector>(6, EuclideanVector(3, 1.0)));
+    WHEN("The 4 nearest neighbours are searched") {
+      auto results = search.Search(EuclideanVector(3, 0.0), 4);
+      THEN("Equal scores are ordered by index") {
+        for (int i = 0; i < 4; i++) {
+          REQUIRE(results[i].index == i);
+          REQUIRE(results[i].score == 3.0);
+        }
+      }
+    }
+  }
+  GIVEN("That there is a search over identical vectors in several chunks") {
+    const int count = 3 * kSearchChunkVectors + 5;
+    auto search = ExactSearch(std::vector<EuclideanVector>(count, EuclideanVector(2, 1.0)));
+    WHEN("The 5 nearest neighbours are searched with a ThreadPool of 4 threads") {
+      auto pool = ThreadPool(4);
+      auto results = search.Search(EuclideanVector(2, 0.0), 5, &pool);
+      THEN("The chunks merged in any order still give the smallest indices, in order") {
+        REQUIRE(results.size() == 5);
+        for (int i = 0; i < 5; i++)
+          REQUIRE(results[i].index == i);
+      }
+    }
+  }
+  GIVEN("That there is a batch stored as structure of arrays") {
+    auto vectors = ev_testing::RandomVectors(50, 5, 4);
+    auto batch = EuclideanVectorBatch(vectors, EuclideanVectorBatch::Layout::kStructureOfArrays);
+    WHEN("It is searched") {
+      auto results = ExactSearch(batch, Metric::kInnerProduct).Search(vectors[7], 3);
+      THEN("The results match the reference") {
+        auto expected = Reference(vectors, vectors[7], Metric::kInnerProduct, 3);
+        for (int i = 0; i < 3; i++)
+          REQUIRE(results[i].index == expected[i].index);
+      }
+    }
+  }
+}
+
+SCENARIO("Search with invalid arguments") {
+  GIVEN("That there is a search over vectors with 4 dimensions") {
+    auto vectors = ev_testing::RandomVectors(10, 4, 5);
+    auto search = ExactSearch(vectors);
+    WHEN("A query with 5 dimensions is searched") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(search.Search(EuclideanVector(5), 1),
+                            "Dimensions of LHS(5) and RHS(4) do not match");
+      }
+    }
+    WHEN("A negative number of neighbours is searched") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(search.Search(vectors[0], -1),
+                            "Number of neighbours -1 is not valid");
+      }
+    }
+  }
+  GIVEN("That there is a cosine search") {
+    auto search = ExactSearch(ev_testing::RandomVectors(10, 4, 6), Metric::kCosine);
+    WHEN("A zero vector is searched for") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(
+            search.Search(EuclideanVector(4), 1),
+            "EuclideanVector with euclidean normal of 0 does not have a unit vector");
+      }
+    }
+  }
+  GIVEN("That there are vectors with different dimensions") {
+    std::vector<EuclideanVector> vectors{EuclideanVector(3), EuclideanVector(4)};
+    WHEN("A search over them is created") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(ExactSearch(vectors), "Dimensions of LHS(3) and RHS(4) do not match");
+      }
+    }
+  }
+}
@@ -0,0 +1,137 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/euclidean_vector_stats.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_kernels.h"
+
+namespace {
+
+EuclideanVector ToEuclideanVector(const std::vector<double>& magnitudes) {
+  return EuclideanVector(magnitudes.begin(), magnitudes.end());
+}
+
+}  // namespace
+
+// Constructors
+
+VectorStatsAccumulator::VectorStatsAccumulator(int numDimensions)
+  : count_{0}, mean_(numDimensions, 0.0), m2_(numDimensions, 0.0),
+    min_(numDimensions, std::numeric_limits<double>::infinity()),
+    max_(numDimensions, -std::numeric_limits<double>::infinity()) {}
+
+// Methods
+
+void VectorStatsAccumulator::Add(const EuclideanVector& v) {
+  ev_detail::CheckDimensions(GetNumDimensions(), v.GetNumDimensions());
+
+  count_++;
+  ev_kernels::WelfordUpdate(v.data(), 1.0 / static_cast<double>(count_), GetNumDimensions(),
+                            mean_.data(), m2_.data(), min_.data(), max_.data());
+}
+
+void VectorStatsAccumulator::Add(const EuclideanVectorBatch& vectors, ThreadPool* pool) {
+  ev_detail::CheckDimensions(GetNumDimensions(), vectors.GetNumDimensions());
+
+  const int numChunks = (vectors.GetNumVectors() + kStatsChunkVectors - 1) / kStatsChunkVectors;
+  std::vector<VectorStatsAccumulator> chunks(numChunks,
+                                             VectorStatsAccumulator(GetNumDimensions()));
+  auto addChunk = [&](int chunk) {
+    const int begin = chunk * kStatsChunkVectors;
+    chunks[chunk].AddRows(vectors, begin,
+                          std::min(begin + kStatsChunkVectors, vectors.GetNumVectors()));
+  };
+  if (pool != nullptr) {
+    pool->ParallelFor(numChunks, addChunk);
+  } else {
+    for (int chunk = 0; chunk < numChunks; chunk++)
+      addChunk(chunk);
+  }
+  for (const auto& chunk : chunks)
+    Merge(chunk);
+}
+
+void VectorStatsAccumulator::Merge(const VectorStatsAccumulator& other) {
+  ev_detail::CheckDimensions(GetNumDimensions(), other.GetNumDimensions());
+  if (other.count_ == 0)
+    return;
+
+  const double count = static_cast<double>(count_);
+  const double otherCount = static_cast<double>(other.count_);
+  const double total = count + otherCount;
+  for (int d = 0; d < GetNumDimensions(); d++) {
+    const double delta = other.mean_[d] - mean_[d];
+    mean_[d] += delta * (otherCount / total);
+    m2_[d] += other.m2_[d] + delta * delta * (count * otherCount / total);
+    min_[d] = std::min(min_[d], other.min_[d]);
+    max_[d] = std::max(max_[d], other.max_[d]);
+  }
+  count_ += other.count_;
+}
+
+EuclideanVector VectorStatsAccumulator::GetMean() const {
+  CheckNotEmpty("a mean");
+
+  return ToEuclideanVector(mean_);
+}
+
+EuclideanVector VectorStatsAccumulator::GetVariance() const {
+  CheckNotEmpty("a variance");
+
+  auto variance = ToEuclideanVector(m2_);
+  variance /= static_cast<double>(count_);
+  return variance;
+}
+
+EuclideanVector VectorStatsAccumulator::GetSampleVariance() const {
+  if (count_ < 2)
+    ev_detail::Throw("VectorStatsAccumulator with fewer than 2 vectors does not have a sample "
+                     "variance");
+
+  auto variance = ToEuclideanVector(m2_);
+  variance /= static_cast<double>(count_ - 1);
+  return variance;
+}
+
+EuclideanVector VectorStatsAccumulator::GetMin() const {
+  CheckNotEmpty("a min");
+
+  return ToEuclideanVector(min_);
+}
+
+EuclideanVector VectorStatsAccumulator::GetMax() const {
+  CheckNotEmpty("a max");
+
+  return ToEuclideanVector(max_);
+}
+
+void VectorStatsAccumulator::AddRows(const EuclideanVectorBatch& vectors, int begin, int end) {
+  const bool rowMajor = vectors.GetLayout() == EuclideanVectorBatch::Layout::kRowMajor;
+  // A structure of arrays vector is gathered into row first, and so gives the same numbers
+  std::vector<double> row(rowMajor ? 0 : GetNumDimensions());
+  for (int r = begin; r < end; r++) {
+    const double* magnitudes =
+        vectors.data() + static_cast<std::size_t>(r) * vectors.GetStride();
+    if (!rowMajor) {
+      for (int d = 0; d < GetNumDimensions(); d++)
+        row[d] = vectors(r, d);
+      magnitudes = row.data();
+    }
+    count_++;
+    ev_kernels::WelfordUpdate(magnitudes, 1.0 / static_cast<double>(count_), GetNumDimensions(),
+                              mean_.data(), m2_.data(), min_.data(), max_.data());
+  }
+}
+
+void VectorStatsAccumulator::CheckNotEmpty(const char* statistic) const {
+  if (count_ == 0) {
+    std::ostringstream ss;
+    ss << "VectorStatsAccumulator with no vectors does not have " << statistic;
+    ev_detail::Throw(ss.str());
+  }
+}
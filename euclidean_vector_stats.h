@@ -0,0 +1,66 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_STATS_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_STATS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/thread_pool.h"
+
+/*
+  Per-dimension count, mean, variance, min and max of a stream of EuclideanVectors.
+
+  Each vector updates the mean and the sum of squared deviations from it (M2) with Welford's
+  update, instead of summing the vectors with operator+= and dividing at the end, so the mean
+  does not lose the small magnitudes of a large running sum and the variance does not come from
+  the difference of two large sums of squares.
+
+  Two accumulators over different vectors are combined by Merge in O(d), with the pairwise
+  update of Chan et al. Ingest from several threads should therefore give each thread its own
+  accumulator and Merge them at the end: the threads share nothing while they ingest.
+  Add(batch, pool) does exactly that with chunks of kStatsChunkVectors vectors, merged in
+  order, so its result is identical with or without a ThreadPool.
+
+  Each update runs on the SIMD kernels (ev_kernels::WelfordUpdate), which give the same numbers
+  on every CPU. A structure of arrays batch is gathered one vector at a time and gives the very
+  same numbers as the row-major batch.
+*/
+
+constexpr int kStatsChunkVectors = 1024;
+
+class VectorStatsAccumulator {
+ public:
+  // Constructors
+  explicit VectorStatsAccumulator(int numDimensions);
+
+  // Methods
+  void Add(const EuclideanVector&);
+  // Every vector of the batch, in order
+  void Add(const EuclideanVectorBatch&, ThreadPool* = nullptr);
+  // Adds the vectors seen by the other accumulator
+  void Merge(const VectorStatsAccumulator&);
+  std::int64_t GetCount() const noexcept { return count_; }
+  int GetNumDimensions() const noexcept { return static_cast<int>(mean_.size()); }
+  EuclideanVector GetMean() const;
+  // Population variance, M2 / count
+  EuclideanVector GetVariance() const;
+  // Sample variance, M2 / (count - 1)
+  EuclideanVector GetSampleVariance() const;
+  EuclideanVector GetMin() const;
+  EuclideanVector GetMax() const;
+
+ private:
+  void AddRows(const EuclideanVectorBatch&, int begin, int end);
+  void CheckNotEmpty(const char* statistic) const;
+
+  std::int64_t count_;
+  std::vector<double> mean_;
+  std::vector<double> m2_;
+  std::vector<double> min_;
+  std::vector<double> max_;
+};
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_STATS_H_
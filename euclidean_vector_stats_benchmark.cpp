@@ -0,0 +1,95 @@
+// Created By : Rahil Agrawal
+//
+// Per-dimension mean and variance of 2^16 vectors, against the loop they replace: a running
+// sum and sum of squares with operator+= and operator/= at the end.
+//
+// Reports vectors/s (items_per_second) for the naive loop, VectorStatsAccumulator::Add one
+// vector at a time, and Add of a batch on one thread and on a ThreadPool with every hardware
+// thread, for 16 to 1024 dimensions.
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/euclidean_vector_stats.h"
+#include "assignments/ev/euclidean_vector_testing.h"
+#include "assignments/ev/thread_pool.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+constexpr int kVectors = 1 << 16;
+
+ThreadPool& Pool() {
+  static ThreadPool pool{static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
+  return pool;
+}
+
+void BM_NaiveSums(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto vectors = ev_testing::RandomVectors(kVectors, n, 1);
+  for (auto _ : state) {
+    auto sum = EuclideanVector(n);
+    auto sumOfSquares = EuclideanVector(n);
+    for (const auto& v : vectors) {
+      sum += v;
+      for (int i = 0; i < n; i++)
+        sumOfSquares[i] += v[i] * v[i];
+    }
+    sum /= kVectors;
+    sumOfSquares /= kVectors;
+    for (int i = 0; i < n; i++)
+      sumOfSquares[i] -= sum[i] * sum[i];
+    benchmark::DoNotOptimize(sumOfSquares.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kVectors);
+}
+
+void BM_AddVectors(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto vectors = ev_testing::RandomVectors(kVectors, n, 1);
+  for (auto _ : state) {
+    auto stats = VectorStatsAccumulator(n);
+    for (const auto& v : vectors)
+      stats.Add(v);
+    benchmark::DoNotOptimize(stats.GetVariance());
+  }
+  state.SetItemsProcessed(state.iterations() * kVectors);
+}
+
+void BM_AddBatch(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto batch = EuclideanVectorBatch(ev_testing::RandomVectors(kVectors, n, 1));
+  for (auto _ : state) {
+    auto stats = VectorStatsAccumulator(n);
+    stats.Add(batch);
+    benchmark::DoNotOptimize(stats.GetVariance());
+  }
+  state.SetItemsProcessed(state.iterations() * kVectors);
+}
+
+void BM_AddBatchThreads(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto batch = EuclideanVectorBatch(ev_testing::RandomVectors(kVectors, n, 1));
+  for (auto _ : state) {
+    auto stats = VectorStatsAccumulator(n);
+    stats.Add(batch, &Pool());
+    benchmark::DoNotOptimize(stats.GetVariance());
+  }
+  state.SetItemsProcessed(state.iterations() * kVectors);
+}
+
+BENCHMARK(BM_NaiveSums)->RangeMultiplier(4)->Range(16, 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AddVectors)->RangeMultiplier(4)->Range(16, 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AddBatch)->RangeMultiplier(4)->Range(16, 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AddBatchThreads)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
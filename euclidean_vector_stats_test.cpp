@@ -0,0 +1,174 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The statistics of VectorStatsAccumulator are checked against the same statistics computed
+  with two passes in long double, over vectors whose magnitudes sit on a large offset, where
+  summing with operator+= and subtracting the squared mean loses the variance entirely.
+
+  Adding a batch (in either layout, with or without a ThreadPool), adding its vectors one by one
+  and merging the accumulators of its halves must all agree. Merging with an empty accumulator
+  must change nothing.
+  Failure scenarios follow the EuclideanVector error messages.
+
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/euclidean_vector_stats.h"
+#include "assignments/ev/euclidean_vector_testing.h"
+#include "assignments/ev/thread_pool.h"
+#include "catch.h"
+
+namespace {
+
+// Magnitudes of 1e9 + [-1, 1]
+std::vector<EuclideanVector> OffsetVectors(int count, int n, unsigned seed) {
+  auto vectors = ev_testing::RandomVectors(count, n, seed);
+  for (auto& v : vectors)
+    v += EuclideanVector(n, 1e9);
+  return vectors;
+}
+
+// Requires a to be within tolerance (relative to b) of b in every dimension
+void RequireClose(const EuclideanVector& a, const EuclideanVector& b, double tolerance) {
+  REQUIRE(a.GetNumDimensions() == b.GetNumDimensions());
+  for (int i = 0; i < a.GetNumDimensions(); i++)
+    REQUIRE(std::abs(a[i] - b[i]) <= tolerance * std::abs(b[i]));
+}
+
+}  // namespace
+
+SCENARIO("Compute the statistics of a stream of vectors") {
+  GIVEN("That there are 3000 vectors with 13 dimensions around 1e9") {
+    const auto vectors = OffsetVectors(3000, 13, 1);
+    auto mean = EuclideanVector(13);
+    auto variance = EuclideanVector(13);
+    auto min = EuclideanVector(13, 2e9);
+    auto max = EuclideanVector(13);
+    for (int i = 0; i < 13; i++) {
+      long double sum = 0;
+      for (const auto& v : vectors) {
+        sum += v[i];
+        min[i] = std::min(min[i], v[i]);
+        max[i] = std::max(max[i], v[i]);
+      }
+      const long double m = sum / vectors.size();
+      long double squares = 0;
+      for (const auto& v : vectors)
+        squares += (v[i] - m) * (v[i] - m);
+      mean[i] = static_cast<double>(m);
+      variance[i] = static_cast<double>(squares / vectors.size());
+    }
+    WHEN("They are added one by one") {
+      auto stats = VectorStatsAccumulator(13);
+      for (const auto& v : vectors)
+        stats.Add(v);
+      THEN("The statistics match the two-pass ones") {
+        REQUIRE(stats.GetCount() == 3000);
+        RequireClose(stats.GetMean(), mean, 1e-14);
+        RequireClose(stats.GetVariance(), variance, 1e-6);
+        RequireClose(stats.GetSampleVariance(), EuclideanVector(variance * 3000.0 / 2999.0),
+                     1e-6);
+        REQUIRE(stats.GetMin() == min);
+        REQUIRE(stats.GetMax() == max);
+      }
+      AND_WHEN("They are added as a batch, in either layout, with and without a ThreadPool") {
+        const auto batch = EuclideanVectorBatch(vectors);
+        auto serial = VectorStatsAccumulator(13);
+        serial.Add(batch);
+        auto soa = VectorStatsAccumulator(13);
+        soa.Add(batch.ToLayout(EuclideanVectorBatch::Layout::kStructureOfArrays));
+        auto pool = ThreadPool(4);
+        auto threaded = VectorStatsAccumulator(13);
+        threaded.Add(batch, &pool);
+        THEN("The statistics are identical to each other and close to the one by one ones") {
+          for (const auto* other : {&soa, &threaded}) {
+            REQUIRE(other->GetCount() == 3000);
+            REQUIRE(other->GetMean() == serial.GetMean());
+            REQUIRE(other->GetVariance() == serial.GetVariance());
+            REQUIRE(other->GetMin() == serial.GetMin());
+            REQUIRE(other->GetMax() == serial.GetMax());
+          }
+          RequireClose(serial.GetMean(), stats.GetMean(), 1e-14);
+          RequireClose(serial.GetVariance(), stats.GetVariance(), 1e-6);
+        }
+      }
+      AND_WHEN("The halves are added from two threads and merged") {
+        auto first = VectorStatsAccumulator(13);
+        auto second = VectorStatsAccumulator(13);
+        std::thread thread{[&] {
+          for (int v = 0; v < 1500; v++)
+            first.Add(vectors[v]);
+        }};
+        for (int v = 1500; v < 3000; v++)
+          second.Add(vectors[v]);
+        thread.join();
+        first.Merge(second);
+        THEN("The statistics match the two-pass ones") {
+          REQUIRE(first.GetCount() == 3000);
+          RequireClose(first.GetMean(), mean, 1e-14);
+          RequireClose(first.GetVariance(), variance, 1e-6);
+          REQUIRE(first.GetMin() == min);
+          REQUIRE(first.GetMax() == max);
+        }
+      }
+      AND_WHEN("An empty accumulator is merged into it, and it into an empty accumulator") {
+        auto empty = VectorStatsAccumulator(13);
+        auto copy = stats;
+        copy.Merge(VectorStatsAccumulator(13));
+        empty.Merge(stats);
+        THEN("Nothing changes") {
+          for (const auto* other : {&copy, &empty}) {
+            REQUIRE(other->GetCount() == 3000);
+            REQUIRE(other->GetMean() == stats.GetMean());
+            REQUIRE(other->GetVariance() == stats.GetVariance());
+            REQUIRE(other->GetMin() == stats.GetMin());
+            REQUIRE(other->GetMax() == stats.GetMax());
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Compute the statistics of a stream of vectors with invalid arguments") {
+  GIVEN("That there is an accumulator of vectors with 3 dimensions") {
+    auto stats = VectorStatsAccumulator(3);
+    WHEN("Its statistics are read before any vector is added") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(stats.GetMean(),
+                            "VectorStatsAccumulator with no vectors does not have a mean");
+        REQUIRE_THROWS_WITH(stats.GetVariance(),
+                            "VectorStatsAccumulator with no vectors does not have a variance");
+        REQUIRE_THROWS_WITH(stats.GetMin(),
+                            "VectorStatsAccumulator with no vectors does not have a min");
+        REQUIRE_THROWS_WITH(stats.GetMax(),
+                            "VectorStatsAccumulator with no vectors does not have a max");
+      }
+    }
+    WHEN("Its sample variance is read after one vector is added") {
+      stats.Add(EuclideanVector(3));
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(
+            stats.GetSampleVariance(),
+            "VectorStatsAccumulator with fewer than 2 vectors does not have a sample variance");
+      }
+    }
+    WHEN("Vectors, batches or accumulators with 4 dimensions are added") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(stats.Add(EuclideanVector(4)),
+                            "Dimensions of LHS(3) and RHS(4) do not match");
+        REQUIRE_THROWS_WITH(stats.Add(EuclideanVectorBatch(2, 4)),
+                            "Dimensions of LHS(3) and RHS(4) do not match");
+        REQUIRE_THROWS_WITH(stats.Merge(VectorStatsAccumulator(4)),
+                            "Dimensions of LHS(3) and RHS(4) do not match");
+      }
+    }
+  }
+}
@@ -29,8 +29,15 @@
                             been commented out.
 */
 
+#include <cfloat>
+#include <charconv>
 #include <cmath>
+#include <functional>
 #include <list>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -87,6 +94,16 @@ SCENARIO("Create a EuclideanVector given dimensions and intialising value") {
       }
     }
   }
+  GIVEN("The length of the vector is -3") {
+    WHEN("EuclideanVectors are created with that length") {
+      THEN("An exception is thrown : Number of dimensions -3 is not valid") {
+        REQUIRE_THROWS_WITH(EuclideanVector(-3), "Number of dimensions -3 is not valid");
+        REQUIRE_THROWS_WITH(EuclideanVector(-3, 5.0), "Number of dimensions -3 is not valid");
+        REQUIRE_THROWS_WITH(BasicEuclideanVector<float>(-3),
+                            "Number of dimensions -3 is not valid");
+      }
+    }
+  }
 }
 
 // Constructor with iterators
@@ -157,6 +174,151 @@ SCENARIO("Create a EuclideanVector using the move constructor") {
   }
 }
 
+// Inline and heap storage
+SCENARIO("Copy and move vectors on both sides of the inline storage limit") {
+  const auto small = EuclideanVector::kInlineDimensions;
+  const auto large = EuclideanVector::kInlineDimensions + 3;
+  GIVEN("That there is a small vector stored inline and a large vector stored on the heap") {
+    auto smallEv = EuclideanVector(small, 1.5);
+    auto largeEv = EuclideanVector(large, 2.5);
+    WHEN("Both are moved into new vectors") {
+      auto newSmall{std::move(smallEv)};
+      auto newLarge{std::move(largeEv)};
+      THEN("The new vectors have the original magnitudes") {
+        REQUIRE(newSmall == EuclideanVector(small, 1.5));
+        REQUIRE(newLarge == EuclideanVector(large, 2.5));
+      }
+      THEN("The old vectors have 0 dimensions") {
+        REQUIRE(smallEv.GetNumDimensions() == 0);
+        REQUIRE(largeEv.GetNumDimensions() == 0);
+      }
+    }
+    WHEN("The large vector is copy assigned to the small one and back") {
+      smallEv = largeEv;
+      THEN("The small vector now holds the large vector's magnitudes") {
+        REQUIRE(smallEv == EuclideanVector(large, 2.5));
+      }
+      smallEv = EuclideanVector(small, 1.5);
+      largeEv = smallEv;
+      THEN("The large vector now holds the small vector's magnitudes") {
+        REQUIRE(largeEv == EuclideanVector(small, 1.5));
+      }
+    }
+    WHEN("Each vector is move assigned to the other") {
+      auto tmp = std::move(smallEv);
+      smallEv = std::move(largeEv);
+      largeEv = std::move(tmp);
+      THEN("The magnitudes have been swapped") {
+        REQUIRE(smallEv == EuclideanVector(large, 2.5));
+        REQUIRE(largeEv == EuclideanVector(small, 1.5));
+      }
+      THEN("The moved from vector has 0 dimensions") { REQUIRE(tmp.GetNumDimensions() == 0); }
+    }
+    WHEN("A moved from vector is used again") {
+      auto newSmall{std::move(smallEv)};
+      smallEv = EuclideanVector(large, 3.0);
+      THEN("It holds its new magnitudes") { REQUIRE(smallEv == EuclideanVector(large, 3.0)); }
+    }
+  }
+}
+
+// Memory resources (Allocator-aware construction)
+namespace {
+
+// Counts the allocations made through it and the bytes still outstanding
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  int allocations = 0;
+  std::size_t outstanding = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    allocations++;
+    outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace
+
+SCENARIO("Create EuclideanVectors on a memory resource") {
+  const auto large = EuclideanVector::kInlineDimensions + 4;
+  GIVEN("That there is a counting memory resource") {
+    CountingResource arena;
+    WHEN("A large vector is created on it") {
+      {
+        auto ev = EuclideanVector(large, 1.0, &arena);
+        THEN("The magnitudes are allocated from the resource") {
+          REQUIRE(ev.get_allocator().resource() == &arena);
+          REQUIRE(arena.allocations == 1);
+          REQUIRE(arena.outstanding == large * sizeof(double));
+        }
+      }
+      THEN("Destroying the vector returns its storage to the resource") {
+        REQUIRE(arena.outstanding == 0);
+      }
+    }
+    AND_GIVEN("That there is a large vector on the resource") {
+      auto ev = EuclideanVector(large, 2.0, &arena);
+      WHEN("It is copy constructed") {
+        auto copy{ev};
+        THEN("The copy uses the default resource") {
+          REQUIRE(copy.get_allocator().resource() == std::pmr::get_default_resource());
+          REQUIRE(copy == ev);
+        }
+      }
+      WHEN("It is move constructed") {
+        auto moved{std::move(ev)};
+        THEN("The new vector keeps the storage and the resource") {
+          REQUIRE(moved.get_allocator().resource() == &arena);
+          REQUIRE(arena.allocations == 1);
+          REQUIRE(ev.GetNumDimensions() == 0);
+        }
+      }
+      WHEN("It is move assigned to a vector on the default resource") {
+        auto target = EuclideanVector(large);
+        target = std::move(ev);
+        THEN("The magnitudes are copied into the target's resource") {
+          REQUIRE(target.get_allocator().resource() == std::pmr::get_default_resource());
+          REQUIRE(target == EuclideanVector(large, 2.0));
+          AND_THEN("The source has 0 dimensions and has released its storage") {
+            REQUIRE(ev.GetNumDimensions() == 0);
+            REQUIRE(arena.outstanding == 0);
+          }
+        }
+      }
+      WHEN("It is used in an arithmetic expression") {
+        auto other = EuclideanVector(large, 1.0);
+        EuclideanVector sum = ev + other;
+        EuclideanVector unit = other.CreateUnitVector();
+        THEN("The result uses the resource of the leftmost operand") {
+          REQUIRE(sum.get_allocator().resource() == &arena);
+          REQUIRE(unit.get_allocator().resource() == std::pmr::get_default_resource());
+          REQUIRE(sum == EuclideanVector(large, 3.0));
+        }
+      }
+    }
+    AND_GIVEN("That there is a std::pmr::vector of EuclideanVectors on the resource") {
+      std::pmr::vector<EuclideanVector> vectors{&arena};
+      WHEN("Large vectors are added to it") {
+        vectors.emplace_back(large, 1.0);
+        vectors.push_back(EuclideanVector(large, 2.0));
+        THEN("The elements use the container's resource") {
+          REQUIRE(vectors[0].get_allocator().resource() == &arena);
+          REQUIRE(vectors[1].get_allocator().resource() == &arena);
+        }
+      }
+    }
+  }
+}
+
 /*
   ------------------------------------------------------------------------------------------------------------------------
                                                     Friends
@@ -425,6 +587,170 @@ SCENARIO("Divide vector by scalar using the overloading / operator") {
   }
 }
 
+// Chained arithmetic (Expression templates)
+SCENARIO("Evaluate a chained arithmetic expression") {
+  GIVEN("That there are three vectors with 3 dimensions") {
+    std::vector<double> vec1{1.0, 2.0, 3.0};
+    std::vector<double> vec2{4.0, 5.0, 6.0};
+    std::vector<double> vec3{0.5, 1.0, 1.5};
+    auto ev1 = EuclideanVector(vec1.begin(), vec1.end());
+    auto ev2 = EuclideanVector(vec2.begin(), vec2.end());
+    auto ev3 = EuclideanVector(vec3.begin(), vec3.end());
+    WHEN("A new vector is constructed from ev1 + ev2 - ev3 * 2.0") {
+      EuclideanVector newEv = ev1 + ev2 - ev3 * 2.0;
+      THEN("The new vector has magnitudes 4.0, 5.0, 6.0") {
+        REQUIRE(newEv.GetNumDimensions() == 3);
+        REQUIRE(newEv[0] == 4.0);
+        REQUIRE(newEv[1] == 5.0);
+        REQUIRE(newEv[2] == 6.0);
+      }
+    }
+    WHEN("ev1 is assigned an expression that refers to ev1 itself") {
+      ev1 = (ev1 + ev2) / 2.0;
+      THEN("ev1 has magnitudes 2.5, 3.5, 4.5") {
+        REQUIRE(ev1[0] == 2.5);
+        REQUIRE(ev1[1] == 3.5);
+        REQUIRE(ev1[2] == 4.5);
+      }
+    }
+    WHEN("A temporary vector is used inside the expression") {
+      EuclideanVector newEv = 2.0 * (EuclideanVector(3, 1.0) + ev1);
+      THEN("The new vector has magnitudes 4.0, 6.0, 8.0") {
+        REQUIRE(newEv[0] == 4.0);
+        REQUIRE(newEv[1] == 6.0);
+        REQUIRE(newEv[2] == 8.0);
+      }
+    }
+    WHEN("A dot product is obtained from two expressions") {
+      auto dotProd = (ev1 + ev2) * (ev2 - ev1);
+      THEN("The dot product is 3*5 + 3*7 + 3*9 = 63") { REQUIRE(dotProd == 63.0); }
+    }
+  }
+  GIVEN("That there are two double and two float vectors with 37 dimensions") {
+    auto u = EuclideanVector(37);
+    auto v = EuclideanVector(37);
+    auto f = BasicEuclideanVector<float>(37);
+    auto g = BasicEuclideanVector<float>(37);
+    for (int i = 0; i < 37; i++) {
+      u[i] = 1.0 / (i + 1);
+      v[i] = std::sqrt(i + 2.0);
+      f[i] = 1.0f / (i + 3);
+      g[i] = std::sqrt(i + 4.0f);
+    }
+    WHEN("Single sums, differences, products and quotients are evaluated by the SIMD kernels") {
+      const EuclideanVector sum = u + v;
+      const EuclideanVector product = u * 3.7;
+      const BasicEuclideanVector<float> floatDifference = f - g;
+      const BasicEuclideanVector<float> floatQuotient = f / 0.25;
+      const BasicEuclideanVector<float> floatProduct = f * 0.1;
+      THEN("Every magnitude is exactly that of the element by element evaluation") {
+        for (int i = 0; i < 37; i++) {
+          REQUIRE(sum[i] == u[i] + v[i]);
+          REQUIRE(product[i] == u[i] * 3.7);
+          REQUIRE(floatDifference[i] == f[i] - g[i]);
+          REQUIRE(floatQuotient[i] == f[i] / 0.25f);
+          REQUIRE(floatProduct[i] == static_cast<float>(f[i] * 0.1));
+        }
+      }
+    }
+    WHEN("The result is written over one of the operands") {
+      const auto original = u;
+      u = v - u;
+      v = v / 3.0;
+      THEN("Every magnitude is read before it is overwritten") {
+        for (int i = 0; i < 37; i++) {
+          REQUIRE(u[i] == std::sqrt(i + 2.0) - original[i]);
+          REQUIRE(v[i] == std::sqrt(i + 2.0) / 3.0);
+        }
+      }
+    }
+  }
+  GIVEN("That there is a vector with 3 dimensions and a vector with 2 dimensions") {
+    auto ev1 = EuclideanVector(3, 1.0);
+    auto ev2 = EuclideanVector(2, 1.0);
+    WHEN("An expression combining them is built") {
+      try {
+        auto expr = ev1 * 2.0 + ev2;
+        std::cerr << expr << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Dimensions of LHS(3) and RHS(2) do not match") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Dimensions of LHS(3) and RHS(2) do not match") == 0);
+        }
+      }
+    }
+  }
+}
+
+// Expiring vectors (Expressions evaluated in the storage of an rvalue operand)
+SCENARIO("Evaluate an expression in the storage of an expiring vector") {
+  const auto large = EuclideanVector::kInlineDimensions + 4;
+  GIVEN("That there are two large vectors on a counting memory resource") {
+    CountingResource arena;
+    auto ev1 = EuclideanVector(large, 1.0, &arena);
+    auto ev2 = EuclideanVector(large, 2.0, &arena);
+    const double* storage = ev1.data();
+    WHEN("A new vector is constructed from std::move(ev1) + ev2 * 3.0 - ev2") {
+      EuclideanVector newEv = std::move(ev1) + ev2 * 3.0 - ev2;
+      THEN("The new vector takes over the storage of ev1 without allocating") {
+        REQUIRE(newEv == EuclideanVector(large, 5.0));
+        REQUIRE(newEv.data() == storage);
+        REQUIRE(newEv.get_allocator().resource() == &arena);
+        REQUIRE(arena.allocations == 2);
+        REQUIRE(ev1.GetNumDimensions() == 0);
+      }
+    }
+    WHEN("The expiring vector is the right operand") {
+      EuclideanVector newEv = 2.0 * (ev2 - std::move(ev1));
+      THEN("Its storage is still taken over") {
+        REQUIRE(newEv == EuclideanVector(large, 2.0));
+        REQUIRE(newEv.data() == storage);
+        REQUIRE(arena.allocations == 2);
+      }
+    }
+    WHEN("The expiring vector uses another resource than the leftmost operand") {
+      EuclideanVector newEv = ev2 + EuclideanVector(large, 1.0);
+      THEN("The new vector is allocated from the resource of the leftmost operand") {
+        REQUIRE(newEv == EuclideanVector(large, 3.0));
+        REQUIRE(newEv.get_allocator().resource() == &arena);
+        REQUIRE(arena.allocations == 3);
+      }
+    }
+    WHEN("The expression is named before a vector is constructed from it") {
+      auto expr = std::move(ev1) + ev2;
+      EuclideanVector first = expr;
+      EuclideanVector second = expr;
+      THEN("Both vectors are evaluated from the unchanged expression") {
+        REQUIRE(first == EuclideanVector(large, 3.0));
+        REQUIRE(second == EuclideanVector(large, 3.0));
+      }
+    }
+    WHEN("The unit vector of the expiring ev1 is obtained") {
+      const auto expected = ev1.CreateUnitVector();
+      const auto allocations = arena.allocations;
+      auto unitVector = std::move(ev1).CreateUnitVector();
+      THEN("It is computed in the storage of ev1") {
+        REQUIRE(unitVector == expected);
+        REQUIRE(unitVector.data() == storage);
+        REQUIRE(arena.allocations == allocations);
+      }
+    }
+  }
+  GIVEN("That there are a float and a double vector") {
+    auto ev1 = BasicEuclideanVector<float>(large, 0.1f);
+    const auto ev2 = EuclideanVector(large, 1.0 / 3.0);
+    const auto expected = BasicEuclideanVector<float>(ev1 / 3.0 + ev2);
+    const float* storage = ev1.data();
+    WHEN("A float vector is constructed from std::move(ev1) / 3.0 + ev2") {
+      BasicEuclideanVector<float> newEv = std::move(ev1) / 3.0 + ev2;
+      THEN("It is rounded once like a new float vector and reuses the storage of ev1") {
+        REQUIRE(newEv == expected);
+        REQUIRE(newEv.data() == storage);
+      }
+    }
+  }
+}
+
 // << (Print Vector like [1 2 3])
 SCENARIO("Print a vector using the output stream") {
   GIVEN("That there is a vector with 5 dimensions and magnitudes as 1.5, 2.7, 3.2, 4.6, 5.1") {
@@ -448,6 +774,110 @@ SCENARIO("Print a vector using the output stream") {
   }
 }
 
+// ToString, FormatTo (Format a vector as [1 2 3] without a stream)
+SCENARIO("Format a vector as text") {
+  GIVEN("That there is a vector with magnitudes 0.1, 1/3, -2.5e-300 and 1e21") {
+    std::vector<double> vec1{0.1, 1.0 / 3, -2.5e-300, 1e21};
+    auto ev1 = EuclideanVector(vec1.begin(), vec1.end());
+    WHEN("It is formatted with ToString") {
+      auto text = ToString(ev1);
+      THEN("Every magnitude is written in the shortest form that reads back exactly") {
+        REQUIRE(text == "[0.1 0.3333333333333333 -2.5e-300 1e+21]");
+      }
+      THEN("It matches the output stream") {
+        std::stringstream v;
+        v << ev1;
+        REQUIRE(v.str() == text);
+      }
+    }
+    WHEN("It is formatted with FormatTo into a large enough buffer") {
+      char buffer[2 + 4 * (kMaxFormattedMagnitudeLength + 1)];
+      auto result = FormatTo(buffer, buffer + sizeof(buffer), ev1);
+      THEN("The text is written and the end of the text is returned") {
+        REQUIRE(result.ec == std::errc{});
+        REQUIRE(std::string(buffer, result.ptr) == ToString(ev1));
+      }
+    }
+    WHEN("It is formatted with FormatTo into a buffer that is too small") {
+      char buffer[10];
+      auto result = FormatTo(buffer, buffer + sizeof(buffer), ev1);
+      THEN("std::errc::value_too_large is returned") {
+        REQUIRE(result.ec == std::errc::value_too_large);
+        REQUIRE(result.ptr == buffer + sizeof(buffer));
+      }
+    }
+  }
+  GIVEN("That there is a vector with 0 dimensions") {
+    auto ev1 = EuclideanVector(0);
+    WHEN("It is formatted with ToString") {
+      THEN("It is formatted as []") { REQUIRE(ToString(ev1) == "[]"); }
+    }
+  }
+}
+
+// FromChars, >> (Parse a vector written as [1 2 3])
+SCENARIO("Parse a vector from text") {
+  GIVEN("That there are vectors formatted with ToString") {
+    std::vector<double> vec1{0.1, 1.0 / 3, -2.5e-300, 1e21, 4.0};
+    auto ev1 = EuclideanVector(vec1.begin(), vec1.end());
+    auto text = ToString(ev1);
+    WHEN("The text is parsed with FromChars") {
+      auto ev2 = EuclideanVector(1);
+      auto result = FromChars(text.data(), text.data() + text.size(), ev2);
+      THEN("The vector read back is exactly the vector written") {
+        REQUIRE(result.ec == std::errc{});
+        REQUIRE(result.ptr == text.data() + text.size());
+        REQUIRE(ev2 == ev1);
+      }
+    }
+  }
+  GIVEN("That there is text with extra whitespace and text for an empty vector") {
+    std::string text = "[ 1  2\t-3.5e2 ]";
+    std::string empty = "[]";
+    WHEN("They are parsed with FromChars") {
+      auto ev1 = EuclideanVector(0);
+      auto ev2 = EuclideanVector(3);
+      FromChars(text.data(), text.data() + text.size(), ev1);
+      FromChars(empty.data(), empty.data() + empty.size(), ev2);
+      THEN("The vectors are [1 2 -350] and []") {
+        std::vector<double> expected{1, 2, -350};
+        REQUIRE(ev1 == EuclideanVector(expected.begin(), expected.end()));
+        REQUIRE(ev2.GetNumDimensions() == 0);
+      }
+    }
+  }
+  GIVEN("That there is text that is not a vector") {
+    auto ev1 = EuclideanVector(2, 7.0);
+    for (std::string text : {"1 2]", "[1 2", "[1 x]", "[1.5x 2]", ""}) {
+      WHEN("\"" + text + "\" is parsed with FromChars") {
+        auto result = FromChars(text.data(), text.data() + text.size(), ev1);
+        THEN("std::errc::invalid_argument is returned and the vector is unchanged") {
+          REQUIRE(result.ec == std::errc::invalid_argument);
+          REQUIRE(ev1 == EuclideanVector(2, 7.0));
+        }
+      }
+    }
+  }
+  GIVEN("That there is an input stream with two vectors followed by text that is not a vector") {
+    std::stringstream input{"  [1 2]\n[3.5] [oops]"};
+    WHEN("Vectors are read using the input stream") {
+      auto ev1 = EuclideanVector(0);
+      auto ev2 = EuclideanVector(0);
+      auto ev3 = EuclideanVector(1, 9.0);
+      input >> ev1 >> ev2;
+      bool readTwo = !input.fail();
+      input >> ev3;
+      THEN("The two vectors are read, then the stream fails and the last vector is unchanged") {
+        REQUIRE(readTwo);
+        REQUIRE(ToString(ev1) == "[1 2]");
+        REQUIRE(ev2 == EuclideanVector(1, 3.5));
+        REQUIRE(input.fail());
+        REQUIRE(ev3 == EuclideanVector(1, 9.0));
+      }
+    }
+  }
+}
+
 /*
   ------------------------------------------------------------------------------------------------------------------------
                                                     Methods
@@ -568,6 +998,244 @@ SCENARIO("Calculate the Norm of a EuclideanVector") {
   }
 }
 
+// Accuracy policies (Dot and GetEuclideanNorm with an Accuracy)
+SCENARIO("Compute dot products and norms with every accuracy policy") {
+  const auto policies = {Accuracy::kFast, Accuracy::kPairwise, Accuracy::kCompensated,
+                         Accuracy::kScaled};
+  GIVEN("That there are two vectors with 1000 dimensions") {
+    auto u = EuclideanVector(1000);
+    auto v = EuclideanVector(1000);
+    long double dot = 0;
+    long double sumOfSquares = 0;
+    double bound = 0;
+    for (int i = 0; i < 1000; i++) {
+      u[i] = std::sin(i + 1.0) * 100;
+      v[i] = std::cos(i + 1.0);
+      dot += static_cast<long double>(u[i]) * v[i];
+      sumOfSquares += static_cast<long double>(u[i]) * u[i];
+      bound += std::abs(u[i] * v[i]);
+    }
+    for (auto accuracy : policies) {
+      WHEN("Their dot product and norm are computed with policy " +
+           std::to_string(static_cast<int>(accuracy))) {
+        THEN("They are within the bound of kFast of the long double results") {
+          REQUIRE(std::abs(Dot(u, v, accuracy) - static_cast<double>(dot)) <=
+                  2 * 1000 * DBL_EPSILON * bound);
+          REQUIRE(std::abs(u.GetEuclideanNorm(accuracy) -
+                           static_cast<double>(std::sqrt(sumOfSquares))) <=
+                  1000 * DBL_EPSILON * u.GetEuclideanNorm());
+        }
+      }
+    }
+    WHEN("kFast is used") {
+      THEN("It is u * v and GetEuclideanNorm()") {
+        REQUIRE(Dot(u, v, Accuracy::kFast) == u * v);
+        REQUIRE(u.GetEuclideanNorm(Accuracy::kFast) == u.GetEuclideanNorm());
+      }
+    }
+  }
+  GIVEN("That there are vectors whose products cancel: {1e16, 1, -1e16} and {1, 1, 1}") {
+    std::vector<double> vec1{1e16, 1.0, -1e16};
+    auto ev1 = EuclideanVector(vec1.begin(), vec1.end());
+    auto ev2 = EuclideanVector(3, 1.0);
+    WHEN("Their dot product is computed with kCompensated") {
+      THEN("It is exactly 1") { REQUIRE(Dot(ev1, ev2, Accuracy::kCompensated) == 1.0); }
+    }
+  }
+  GIVEN("That there are vectors whose squares overflow and underflow") {
+    auto large = EuclideanVector(2, 1e200);
+    auto small = EuclideanVector(2, 1e-200);
+    WHEN("Their norms are computed with kScaled") {
+      THEN("They are sqrt(2) * 1e200 and sqrt(2) * 1e-200 where kFast gives inf and 0") {
+        REQUIRE(large.GetEuclideanNorm() == HUGE_VAL);
+        REQUIRE(small.GetEuclideanNorm() == 0.0);
+        REQUIRE(std::abs(large.GetEuclideanNorm(Accuracy::kScaled) - std::sqrt(2.0) * 1e200) <=
+                4 * DBL_EPSILON * 1.5e200);
+        REQUIRE(std::abs(small.GetEuclideanNorm(Accuracy::kScaled) - std::sqrt(2.0) * 1e-200) <=
+                4 * DBL_EPSILON * 1.5e-200);
+        REQUIRE(std::abs(Dot(large, small, Accuracy::kScaled) - 2.0) <= 4 * DBL_EPSILON);
+      }
+    }
+    WHEN("Vectors hold magnitudes up to DBL_MAX") {
+      const auto max = EuclideanVector(1, DBL_MAX);
+      const auto halves = EuclideanVector(2, DBL_MAX / 2);
+      THEN("kScaled computes norms and dot products that fit in a double") {
+        REQUIRE(max.GetEuclideanNorm(Accuracy::kScaled) == DBL_MAX);
+        REQUIRE(Dot(max, EuclideanVector(1, 0.5), Accuracy::kScaled) == DBL_MAX / 2);
+        REQUIRE(std::abs(halves.GetEuclideanNorm(Accuracy::kScaled) - DBL_MAX / std::sqrt(2.0)) <=
+                4 * DBL_EPSILON * DBL_MAX);
+      }
+    }
+    WHEN("A vector holds an infinity or a NaN") {
+      large[1] = HUGE_VAL;
+      small[1] = NAN;
+      THEN("kScaled gives inf and NaN as kFast does") {
+        REQUIRE(large.GetEuclideanNorm(Accuracy::kScaled) == HUGE_VAL);
+        REQUIRE(std::isnan(small.GetEuclideanNorm(Accuracy::kScaled)));
+      }
+    }
+  }
+  GIVEN("That there is a float vector whose squares overflow in float") {
+    auto fv = BasicEuclideanVector<float>(300, 1e20f);
+    for (auto accuracy : {Accuracy::kPairwise, Accuracy::kCompensated, Accuracy::kScaled}) {
+      WHEN("Its norm is computed with policy " + std::to_string(static_cast<int>(accuracy))) {
+        THEN("It is computed in double") {
+          REQUIRE(std::abs(fv.GetEuclideanNorm(accuracy) - std::sqrt(300.0) * 1e20f) <=
+                  1e-12 * std::sqrt(300.0) * 1e20f);
+        }
+      }
+    }
+  }
+  GIVEN("That there is a vector with 0 dimensions") {
+    auto ev1 = EuclideanVector(0);
+    WHEN("Its norm is computed with kScaled") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(ev1.GetEuclideanNorm(Accuracy::kScaled),
+                            "EuclideanVector with no dimensions does not have a norm");
+      }
+    }
+  }
+}
+
+// Norm caching (SetNormCaching)
+SCENARIO("Cache the Norm of a EuclideanVector") {
+  // Norm computed from scratch, by a copy that does not cache
+  auto recomputedNorm = [](const EuclideanVector& v) {
+    auto copy = v;
+    copy.SetNormCaching(false);
+    return copy.GetEuclideanNorm();
+  };
+  GIVEN("That there is a vector with magnitudes 3.0, 4.0, 0.0 that caches its norm") {
+    auto ev1 = EuclideanVector(3);
+    ev1[0] = 3.0;
+    ev1[1] = 4.0;
+    ev1.SetNormCaching(true);
+    REQUIRE(ev1.IsNormCaching());
+    REQUIRE(ev1.GetEuclideanNorm() == 5.0);
+    WHEN("A magnitude is changed through a pointer taken before the norm was computed") {
+      double* magnitudes = ev1.data();
+      REQUIRE(ev1.GetEuclideanNorm() == 5.0);
+      magnitudes[0] = 0.0;
+      THEN("The cached norm is returned without being computed again") {
+        REQUIRE(ev1.GetEuclideanNorm() == 5.0);
+      }
+      AND_WHEN("Caching is turned off") {
+        ev1.SetNormCaching(false);
+        THEN("The norm is computed again") { REQUIRE(ev1.GetEuclideanNorm() == 4.0); }
+      }
+    }
+    const auto other = EuclideanVector(3, 1.0);
+    const std::vector<std::pair<std::string, std::function<void(EuclideanVector&)>>> mutations{
+        {"+=", [&](EuclideanVector& v) { v += other; }},
+        {"-=", [&](EuclideanVector& v) { v -= other; }},
+        {"+= of an expression", [&](EuclideanVector& v) { v += other * 2.0; }},
+        {"-= of an expression", [&](EuclideanVector& v) { v -= other * 2.0; }},
+        {"at()", [](EuclideanVector& v) { v.at(2) = 12.0; }},
+        {"operator[]", [](EuclideanVector& v) { v[2] = 12.0; }},
+        {"data()", [](EuclideanVector& v) { v.data()[2] = 12.0; }},
+        {"copy assignment", [&](EuclideanVector& v) { v = other; }},
+        {"move assignment", [&](EuclideanVector& v) { v = EuclideanVector(other); }},
+        {"expression assignment", [&](EuclideanVector& v) { v = v + other; }},
+        {"Axpy", [&](EuclideanVector& v) { v.Axpy(2.0, other); }},
+        {"Axpby", [&](EuclideanVector& v) { v.Axpby(2.0, other, 3.0); }},
+        {"AccumulateWeighted",
+         [&](EuclideanVector& v) {
+           v.AccumulateWeighted({2.0}, {&other});
+         }},
+    };
+    for (const auto& mutation : mutations) {
+      WHEN("It is changed with " + mutation.first) {
+        mutation.second(ev1);
+        THEN("The norm of the new magnitudes is returned") {
+          REQUIRE(ev1.IsNormCaching());
+          REQUIRE(ev1.GetEuclideanNorm() == recomputedNorm(ev1));
+        }
+      }
+    }
+    WHEN("It is scaled with *= and /=") {
+      ev1 *= -2.0;
+      auto scaledNorm = ev1.GetEuclideanNorm();
+      ev1 /= 4.0;
+      THEN("The cached norm is scaled by the absolute value of the scalar") {
+        REQUIRE(scaledNorm == 10.0);
+        REQUIRE(ev1.GetEuclideanNorm() == 2.5);
+        REQUIRE(recomputedNorm(ev1) == 2.5);
+      }
+    }
+    WHEN("It is copied and moved") {
+      auto copy = ev1;
+      auto moved = std::move(ev1);
+      THEN("The copies cache the same norm") {
+        REQUIRE(copy.IsNormCaching());
+        REQUIRE(moved.IsNormCaching());
+        REQUIRE(copy.GetEuclideanNorm() == 5.0);
+        REQUIRE(moved.GetEuclideanNorm() == 5.0);
+      }
+    }
+    WHEN("It is assigned to a vector that does not cache its norm") {
+      auto ev2 = EuclideanVector(1);
+      ev2 = ev1;
+      THEN("That vector still does not cache its norm") {
+        REQUIRE_FALSE(ev2.IsNormCaching());
+        REQUIRE(ev2.GetEuclideanNorm() == 5.0);
+      }
+    }
+  }
+  GIVEN("That there is a float vector that caches its norm") {
+    auto fv = BasicEuclideanVector<float>(3, 0.1f);
+    fv.SetNormCaching(true);
+    WHEN("Its norm is asked for with both accumulations") {
+      auto native = fv.GetEuclideanNorm();
+      auto inDouble = fv.GetEuclideanNorm(Accumulation::kDouble);
+      THEN("Each accumulation gives its own result") {
+        auto uncached = fv;
+        uncached.SetNormCaching(false);
+        REQUIRE(native == uncached.GetEuclideanNorm());
+        REQUIRE(inDouble == uncached.GetEuclideanNorm(Accumulation::kDouble));
+        REQUIRE(fv.GetEuclideanNorm() == native);
+        REQUIRE(fv.GetEuclideanNorm(Accumulation::kDouble) == inDouble);
+      }
+    }
+  }
+  GIVEN("That there is a float vector with norm 1e30 (accumulated in double) that caches it") {
+    constexpr auto kDouble = Accumulation::kDouble;
+    auto fv = BasicEuclideanVector<float>(1, 1e30f);
+    fv.SetNormCaching(true);
+    REQUIRE(fv.GetEuclideanNorm(kDouble) == 1e30f);
+    auto recomputedFloatNorm = [](const BasicEuclideanVector<float>& v) {
+      auto copy = v;
+      copy.SetNormCaching(false);
+      return copy.GetEuclideanNorm(kDouble);
+    };
+    WHEN("It is multiplied by 1e10, past the largest float") {
+      fv *= 1e10f;
+      THEN("The norm is computed again from the overflowed magnitude") {
+        REQUIRE(std::isinf(fv.GetEuclideanNorm(kDouble)));
+        REQUIRE(fv.GetEuclideanNorm(kDouble) == recomputedFloatNorm(fv));
+        REQUIRE(std::isinf(std::as_const(fv)[0]));
+      }
+    }
+    WHEN("It is divided down into the subnormal floats") {
+      fv /= 1e30f;
+      fv /= 1e30f;
+      fv /= 1e10f;
+      THEN("The norm is computed again from the rounded magnitude") {
+        REQUIRE(fv.GetEuclideanNorm(kDouble) == recomputedFloatNorm(fv));
+      }
+    }
+    WHEN("It is divided by 1e10, staying in range") {
+      fv /= 1e10f;
+      THEN("The cached norm is scaled") {
+        REQUIRE(fv.GetEuclideanNorm(kDouble) == static_cast<double>(1e30f) / 1e10);
+      }
+    }
+  }
+  GIVEN("That there is a vector that does not cache its norm") {
+    auto ev1 = EuclideanVector(2, 3.0);
+    THEN("Caching is off") { REQUIRE_FALSE(ev1.IsNormCaching()); }
+  }
+}
+
 // CreateUnitVector (Get the Unit vector of a vector)
 SCENARIO("Create Unit vector of a euclidean vector") {
   GIVEN("That there is a vector with 4 dimensions and magnitudes as 1.0, 1.0, 1.0, 1.0") {
@@ -632,6 +1300,115 @@ SCENARIO("Create Unit vector of a euclidean vector") {
     }
   } */
 }
+// Axpy (this += a * x)
+SCENARIO("Accumulate a scaled vector in place using Axpy") {
+  GIVEN("That there is a vector with 3 dimensions and magnitudes as 1.0, 2.0, 3.0") {
+    std::vector<double> vec1{1.0, 2.0, 3.0};
+    auto ev1 = EuclideanVector(vec1.begin(), vec1.end());
+    AND_GIVEN("That there is a vector with 3 dimensions and magnitudes as 4.0, 5.0, 6.0") {
+      std::vector<double> vec2{4.0, 5.0, 6.0};
+      auto ev2 = EuclideanVector(vec2.begin(), vec2.end());
+      WHEN("2.0 times the second vector is accumulated into the first") {
+        ev1.Axpy(2.0, ev2);
+        THEN("The first vector has magnitudes 9.0, 12.0, 15.0") {
+          REQUIRE(ev1[0] == 9.0);
+          REQUIRE(ev1[1] == 12.0);
+          REQUIRE(ev1[2] == 15.0);
+        }
+      }
+    }
+    AND_GIVEN("That there is a vector with 2 dimensions") {
+      auto ev2 = EuclideanVector(2, 1.0);
+      WHEN("The second vector is accumulated into the first") {
+        try {
+          ev1.Axpy(2.0, ev2);
+          std::cerr << ev1 << "is invalid. Control should not reach this line";
+        } catch (const EuclideanVectorError& e) {
+          THEN("Exception is thrown : Dimensions of LHS(3) and RHS(2) do not match") {
+            std::string err = e.what();
+            REQUIRE(err.compare("Dimensions of LHS(3) and RHS(2) do not match") == 0);
+          }
+        }
+      }
+    }
+  }
+}
+
+// Axpby (this = a * x + b * this)
+SCENARIO("Combine two scaled vectors in place using Axpby") {
+  GIVEN("That there are vectors with magnitudes 1.0, 2.0, 3.0 and 4.0, 5.0, 6.0") {
+    std::vector<double> vec1{1.0, 2.0, 3.0};
+    std::vector<double> vec2{4.0, 5.0, 6.0};
+    auto ev1 = EuclideanVector(vec1.begin(), vec1.end());
+    auto ev2 = EuclideanVector(vec2.begin(), vec2.end());
+    WHEN("The first vector is replaced by 0.5 times the second plus 3.0 times itself") {
+      ev1.Axpby(0.5, ev2, 3.0);
+      THEN("The first vector has magnitudes 5.0, 8.5, 12.0") {
+        REQUIRE(ev1[0] == 5.0);
+        REQUIRE(ev1[1] == 8.5);
+        REQUIRE(ev1[2] == 12.0);
+      }
+    }
+  }
+}
+
+// AccumulateWeighted (this += sum of w[k] * v[k])
+SCENARIO("Accumulate a weighted sum of vectors in place") {
+  GIVEN("That there is an accumulator with 1000 dimensions, all of which are 1.0") {
+    auto acc = EuclideanVector(1000, 1.0);
+    AND_GIVEN("That there are three vectors with 1000 dimensions and weights 1.0, 2.0, -0.5") {
+      const auto ev1 = EuclideanVector(1000, 1.0);
+      const auto ev2 = EuclideanVector(1000, 2.0);
+      const auto ev3 = EuclideanVector(1000, 4.0);
+      std::vector<const EuclideanVector*> vectors{&ev1, &ev2, &ev3};
+      std::vector<double> weights{1.0, 2.0, -0.5};
+      WHEN("The weighted sum is accumulated") {
+        acc.AccumulateWeighted(weights, vectors);
+        THEN("Every magnitude is 1.0 + 1.0 + 4.0 - 2.0 = 4.0") {
+          REQUIRE(acc == EuclideanVector(1000, 4.0));
+        }
+      }
+      WHEN("The accumulator itself is one of the vectors") {
+        vectors.push_back(&acc);
+        weights.push_back(3.0);
+        acc.AccumulateWeighted(weights, vectors);
+        THEN("It is read as it was before: every magnitude is 4.0 + 3.0 * 1.0 = 7.0") {
+          REQUIRE(acc == EuclideanVector(1000, 7.0));
+        }
+      }
+      WHEN("Only two weights are given") {
+        weights.pop_back();
+        try {
+          acc.AccumulateWeighted(weights, vectors);
+          std::cerr << acc << "is invalid. Control should not reach this line";
+        } catch (const EuclideanVectorError& e) {
+          THEN("Exception is thrown : Number of weights(2) and vectors(3) do not match") {
+            std::string err = e.what();
+            REQUIRE(err.compare("Number of weights(2) and vectors(3) do not match") == 0);
+          }
+        }
+      }
+      WHEN("One of the vectors has a different number of dimensions") {
+        const auto shorter = EuclideanVector(999, 1.0);
+        vectors.push_back(&shorter);
+        weights.push_back(1.0);
+        try {
+          acc.AccumulateWeighted(weights, vectors);
+          std::cerr << acc << "is invalid. Control should not reach this line";
+        } catch (const EuclideanVectorError& e) {
+          THEN("Exception is thrown : Dimensions of LHS(1000) and RHS(999) do not match") {
+            std::string err = e.what();
+            REQUIRE(err.compare("Dimensions of LHS(1000) and RHS(999) do not match") == 0);
+            AND_THEN("The accumulator is left unchanged") {
+              REQUIRE(acc == EuclideanVector(1000, 1.0));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 /*
   ------------------------------------------------------------------------------------------------------------------------
                                                     Operations
@@ -923,3 +1700,141 @@ SCENARIO("Type case a EuclideanVector to a std::list") {
     }
   }
 }
+
+// BasicEuclideanVector<float> (Single precision magnitudes)
+SCENARIO("Use a EuclideanVector with float magnitudes") {
+  GIVEN("That there are two float vectors with 7 dimensions") {
+    auto mags1 = std::vector<float>{1.1f, -2.2f, 3.3f, 4.4f, 5.5f, -6.6f, 7.7f};
+    auto mags2 = std::vector<float>{0.3f, 0.7f, -1.9f, 2.5f, 8.1f, 0.01f, -3.3f};
+    auto ev1 = BasicEuclideanVector<float>(mags1.begin(), mags1.end());
+    auto ev2 = BasicEuclideanVector<float>(mags2.begin(), mags2.end());
+    WHEN("They are combined with the arithmetic operators") {
+      auto sum = BasicEuclideanVector<float>(ev1 + ev2);
+      auto scaled = BasicEuclideanVector<float>(ev1 * 3.7f);
+      auto divided = BasicEuclideanVector<float>(ev1 / 1.3f);
+      THEN("Every magnitude equals the same float operation") {
+        for (int i = 0; i < 7; i++) {
+          REQUIRE(sum[i] == mags1[i] + mags2[i]);
+          REQUIRE(scaled[i] == mags1[i] * 3.7f);
+          REQUIRE(divided[i] == mags1[i] / 1.3f);
+        }
+      }
+    }
+    WHEN("They are updated in place") {
+      ev1 += ev2;
+      ev2 *= 2.0f;
+      THEN("Every magnitude equals the same float operation") {
+        for (int i = 0; i < 7; i++) {
+          REQUIRE(ev1[i] == mags1[i] + mags2[i]);
+          REQUIRE(ev2[i] == mags2[i] * 2.0f);
+        }
+      }
+    }
+    WHEN("They are converted to a std::vector<float>") {
+      THEN("The magnitudes are unchanged") { REQUIRE(std::vector<float>{ev1} == mags1); }
+    }
+  }
+  GIVEN("That there are float vectors whose dot product cancels in single precision") {
+    auto mags = std::vector<float>{1e8f, 1.0f, -1e8f};
+    auto ev1 = BasicEuclideanVector<float>(mags.begin(), mags.end());
+    auto ev2 = BasicEuclideanVector<float>(3, 1.0f);
+    WHEN("The dot product is accumulated in double") {
+      auto dotProd = Dot(ev1, ev2, Accumulation::kDouble);
+      THEN("It is exact") { REQUIRE(dotProd == 1.0); }
+    }
+    WHEN("The dot product is accumulated in float") {
+      auto dotProd = ev1 * ev2;
+      THEN("It is within the float bound") {
+        REQUIRE(std::abs(dotProd - 1.0) <= 2 * 3 * 2e8 * FLT_EPSILON);
+      }
+    }
+  }
+  GIVEN("That there is a float vector with magnitudes 3 and 4") {
+    auto ev1 = BasicEuclideanVector<float>(2, 3.0f);
+    ev1[1] = 4.0f;
+    WHEN("The euclidean norm is obtained with either accumulation") {
+      THEN("It is 5") {
+        REQUIRE(ev1.GetEuclideanNorm() == 5.0);
+        REQUIRE(ev1.GetEuclideanNorm(Accumulation::kDouble) == 5.0);
+      }
+    }
+    WHEN("The unit vector is created") {
+      auto unit = ev1.CreateUnitVector();
+      THEN("It is a float vector of magnitudes 0.6 and 0.8") {
+        REQUIRE(unit[0] == 0.6f);
+        REQUIRE(unit[1] == 0.8f);
+      }
+    }
+  }
+  GIVEN("That there is a float vector with 0 dimensions") {
+    auto ev1 = BasicEuclideanVector<float>(0);
+    WHEN("The euclidean norm is obtained") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(ev1.GetEuclideanNorm(),
+                            "EuclideanVector with no dimensions does not have a norm");
+      }
+    }
+  }
+  GIVEN("That there are float and double vectors of different dimensions") {
+    auto ev1 = BasicEuclideanVector<float>(2, 1.5f);
+    auto ev2 = BasicEuclideanVector<float>(3, 1.5f);
+    WHEN("They are added") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(ev1 += ev2, "Dimensions of LHS(2) and RHS(3) do not match");
+      }
+    }
+  }
+}
+
+SCENARIO("Convert between float and double EuclideanVectors") {
+  GIVEN("That there is a double vector with 3 dimensions") {
+    auto mags = std::vector<double>{0.1, 1e40, -2.5};
+    auto ev1 = EuclideanVector(mags.begin(), mags.end());
+    WHEN("It is explicitly converted to a float vector") {
+      auto ev2 = BasicEuclideanVector<float>(ev1);
+      THEN("Every magnitude is rounded to float") {
+        REQUIRE(ev2.GetNumDimensions() == 3);
+        REQUIRE(ev2[0] == 0.1f);
+        REQUIRE(std::isinf(ev2[1]));
+        REQUIRE(ev2[2] == -2.5f);
+      }
+      AND_WHEN("It is converted back to a double vector") {
+        auto ev3 = EuclideanVector(ev2);
+        THEN("The float magnitudes are kept exactly") {
+          REQUIRE(ev3[0] == static_cast<double>(0.1f));
+          REQUIRE(ev3[2] == -2.5);
+        }
+      }
+    }
+    THEN("The conversions are not implicit") {
+      REQUIRE(!std::is_convertible<EuclideanVector, BasicEuclideanVector<float>>::value);
+      REQUIRE(!std::is_convertible<BasicEuclideanVector<float>, EuclideanVector>::value);
+    }
+  }
+}
+
+SCENARIO("Format and parse a float EuclideanVector") {
+  GIVEN("That there is a float vector with magnitudes that are not exact in decimal") {
+    auto mags = std::vector<float>{0.1f, -1.0f / 3.0f, 16777216.0f};
+    auto ev1 = BasicEuclideanVector<float>(mags.begin(), mags.end());
+    WHEN("It is formatted with ToString") {
+      auto text = ToString(ev1);
+      THEN("The shortest float representation is used") {
+        REQUIRE(text == "[0.1 -0.33333334 16777216]");
+      }
+      AND_WHEN("It is parsed back with FromChars") {
+        auto ev2 = BasicEuclideanVector<float>(0);
+        auto result = FromChars(text.data(), text.data() + text.size(), ev2);
+        THEN("The same float vector is obtained") {
+          REQUIRE(result.ec == std::errc{});
+          REQUIRE(ev2 == ev1);
+        }
+      }
+    }
+    WHEN("It is printed to a stream") {
+      std::ostringstream os;
+      os << ev1;
+      THEN("It matches ToString") { REQUIRE(os.str() == ToString(ev1)); }
+    }
+  }
+}
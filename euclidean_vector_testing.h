@@ -0,0 +1,39 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_TESTING_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_TESTING_H_
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+
+/*
+  Random data shared by the tests and benchmarks (testonly).
+*/
+
+namespace ev_testing {
+
+// count vectors with n magnitudes drawn uniformly from [low, high). The same seed always gives
+// the same vectors.
+inline std::vector<EuclideanVector> RandomVectors(int count,
+                                                  int n,
+                                                  unsigned seed,
+                                                  double low = -1.0,
+                                                  double high = 1.0) {
+  std::mt19937 gen{seed};
+  std::uniform_real_distribution<double> dist{low, high};
+  std::vector<EuclideanVector> vectors;
+  for (int v = 0; v < count; v++) {
+    auto ev = EuclideanVector(n);
+    for (int i = 0; i < n; i++)
+      ev[i] = dist(gen);
+    vectors.push_back(std::move(ev));
+  }
+  return vectors;
+}
+
+}  // namespace ev_testing
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_TESTING_H_
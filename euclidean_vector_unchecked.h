@@ -0,0 +1,87 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_UNCHECKED_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_UNCHECKED_H_
+
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_kernels.h"
+
+/*
+  Fast paths for inner loops whose dimensions were validated once, up front.
+
+  The operators of EuclideanVector check their operands on every call and report a mismatch by
+  throwing. The functions of ev_unchecked do the same work with the same kernels, but are
+  inline and noexcept: the checks are assert()s, so they run in debug builds and compile away
+  with NDEBUG. Calling them with operands of different dimensions is undefined behaviour in a
+  release build.
+
+    ev_unchecked::AddAssign(u, v)       u += v
+    ev_unchecked::SubtractAssign(u, v)  u -= v
+    ev_unchecked::Axpy(u, a, v)         u += a * v
+    ev_unchecked::Add(u, v)             u + v, as an expression
+    ev_unchecked::Subtract(u, v)        u - v, as an expression
+    ev_unchecked::Dot(u, v)             u * v
+
+  Results are bit-identical to the checked operators.
+*/
+
+namespace ev_unchecked {
+
+template <typename T>
+void AddAssign(BasicEuclideanVector<T>& u, const BasicEuclideanVector<T>& v) noexcept {
+  assert(u.GetNumDimensions() == v.GetNumDimensions());
+
+  ev_kernels::Add(u.data(), v.data(), u.GetNumDimensions());
+}
+
+template <typename T>
+void SubtractAssign(BasicEuclideanVector<T>& u, const BasicEuclideanVector<T>& v) noexcept {
+  assert(u.GetNumDimensions() == v.GetNumDimensions());
+
+  ev_kernels::Subtract(u.data(), v.data(), u.GetNumDimensions());
+}
+
+template <typename T>
+void Axpy(BasicEuclideanVector<T>& u, T a, const BasicEuclideanVector<T>& v) noexcept {
+  assert(u.GetNumDimensions() == v.GetNumDimensions());
+
+  ev_kernels::Axpy(u.data(), a, v.data(), u.GetNumDimensions());
+}
+
+template <typename L, typename R, ev_detail::EnableIfExpression<L> = 0,
+          ev_detail::EnableIfExpression<R> = 0>
+ev_detail::BinaryExpressionOf<L, R, ev_detail::Plus> Add(L&& u, R&& v) noexcept(
+    std::is_nothrow_constructible<ev_detail::BinaryExpressionOf<L, R, ev_detail::Plus>,
+                                  ev_detail::UncheckedTag, L&&, R&&>::value) {
+  return {ev_detail::UncheckedTag{}, std::forward<L>(u), std::forward<R>(v)};
+}
+
+template <typename L, typename R, ev_detail::EnableIfExpression<L> = 0,
+          ev_detail::EnableIfExpression<R> = 0>
+ev_detail::BinaryExpressionOf<L, R, ev_detail::Minus> Subtract(L&& u, R&& v) noexcept(
+    std::is_nothrow_constructible<ev_detail::BinaryExpressionOf<L, R, ev_detail::Minus>,
+                                  ev_detail::UncheckedTag, L&&, R&&>::value) {
+  return {ev_detail::UncheckedTag{}, std::forward<L>(u), std::forward<R>(v)};
+}
+
+template <typename T>
+double Dot(const BasicEuclideanVector<T>& u,
+           const BasicEuclideanVector<T>& v,
+           Accumulation accumulation = Accumulation::kNative) noexcept {
+  assert(u.GetNumDimensions() == v.GetNumDimensions());
+
+  if constexpr (std::is_same<T, float>::value) {
+    if (accumulation == Accumulation::kDouble)
+      return ev_kernels::DotInDouble(u.data(), v.data(), u.GetNumDimensions());
+  }
+  static_cast<void>(accumulation);
+  return ev_kernels::Dot(u.data(), v.data(), u.GetNumDimensions());
+}
+
+}  // namespace ev_unchecked
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_UNCHECKED_H_
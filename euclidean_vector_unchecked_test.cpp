@@ -0,0 +1,116 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The ev_unchecked functions must give exactly the results of the checked EuclideanVector
+  operators, so each one is compared with its operator, bit for bit, for double and float
+  vectors on both sides of the inline storage limit and long enough to use every SIMD tail.
+  That they are noexcept is checked at compile time.
+
+  The dimension checks are assert()s, and calling these functions with mismatched vectors is
+  undefined in a release build, so there are no failure scenarios. This file does not use
+  exceptions and is also built with -fno-exceptions.
+
+*/
+
+#include <cmath>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_unchecked.h"
+#include "catch.h"
+
+namespace {
+
+template <typename T>
+BasicEuclideanVector<T> MakeVector(int n, double seed) {
+  auto v = BasicEuclideanVector<T>(n);
+  for (int i = 0; i < n; i++)
+    v[i] = static_cast<T>(seed * (i % 7 + 1) - 0.25 * i);
+  return v;
+}
+
+template <typename T>
+void RequireMatchesOperators(int n) {
+  const auto u = MakeVector<T>(n, 1.5);
+  const auto v = MakeVector<T>(n, -0.75);
+
+  auto checked = u;
+  checked += v;
+  auto unchecked = u;
+  ev_unchecked::AddAssign(unchecked, v);
+  REQUIRE(unchecked == checked);
+
+  checked = u;
+  checked -= v;
+  unchecked = u;
+  ev_unchecked::SubtractAssign(unchecked, v);
+  REQUIRE(unchecked == checked);
+
+  checked = u;
+  checked.Axpy(T{3}, v);
+  unchecked = u;
+  ev_unchecked::Axpy(unchecked, T{3}, v);
+  REQUIRE(unchecked == checked);
+
+  REQUIRE(BasicEuclideanVector<T>(ev_unchecked::Add(u, v)) == BasicEuclideanVector<T>(u + v));
+  REQUIRE(BasicEuclideanVector<T>(ev_unchecked::Subtract(u, v)) ==
+          BasicEuclideanVector<T>(u - v));
+  REQUIRE(BasicEuclideanVector<T>(ev_unchecked::Add(ev_unchecked::Subtract(u, v), u * 2.0)) ==
+          BasicEuclideanVector<T>(u - v + u * 2.0));
+
+  REQUIRE(ev_unchecked::Dot(u, v) == Dot(u, v));
+  REQUIRE(ev_unchecked::Dot(u, v, Accumulation::kDouble) == Dot(u, v, Accumulation::kDouble));
+}
+
+static_assert(noexcept(ev_unchecked::AddAssign(std::declval<EuclideanVector&>(),
+                                               std::declval<const EuclideanVector&>())),
+              "AddAssign must be noexcept");
+static_assert(noexcept(ev_unchecked::SubtractAssign(std::declval<EuclideanVector&>(),
+                                                    std::declval<const EuclideanVector&>())),
+              "SubtractAssign must be noexcept");
+static_assert(noexcept(ev_unchecked::Axpy(std::declval<EuclideanVector&>(), 2.0,
+                                          std::declval<const EuclideanVector&>())),
+              "Axpy must be noexcept");
+static_assert(noexcept(ev_unchecked::Dot(std::declval<const EuclideanVector&>(),
+                                         std::declval<const EuclideanVector&>())),
+              "Dot must be noexcept");
+static_assert(noexcept(ev_unchecked::Add(std::declval<const EuclideanVector&>(),
+                                         std::declval<const EuclideanVector&>())),
+              "Add of two lvalues must be noexcept");
+static_assert(noexcept(ev_unchecked::Subtract(std::declval<EuclideanVector>(),
+                                              std::declval<const EuclideanVector&>())),
+              "Subtract of an rvalue must be noexcept");
+
+}  // namespace
+
+SCENARIO("Unchecked operations match the checked operators") {
+  for (int n : {0, 1, 4, 5, 17, 1000}) {
+    GIVEN("That there are two double and two float vectors with " + std::to_string(n) +
+          " dimensions") {
+      WHEN("Each unchecked operation is applied to them") {
+        THEN("The results are identical to those of the checked operators") {
+          RequireMatchesOperators<double>(n);
+          RequireMatchesOperators<float>(n);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Unchecked updates forget a cached norm") {
+  GIVEN("That there is a vector that caches its norm") {
+    auto u = EuclideanVector(2, 3.0);
+    u.SetNormCaching(true);
+    REQUIRE(u.GetEuclideanNorm() == std::sqrt(18.0));
+    WHEN("It is updated with AddAssign") {
+      ev_unchecked::AddAssign(u, EuclideanVector(2, 1.0));
+      THEN("The norm of the new magnitudes is returned") {
+        REQUIRE(u.GetEuclideanNorm() == std::sqrt(32.0));
+      }
+    }
+  }
+}
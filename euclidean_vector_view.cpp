@@ -0,0 +1,147 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/euclidean_vector_view.h"
+
+#include <cmath>
+#include <list>
+#include <sstream>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_kernels.h"
+
+namespace {
+
+[[noreturn]] void ThrowInvalidIndex(int index) {
+  std::ostringstream ss;
+  ss << "Index " << index << " is not valid for this EuclideanVector object";
+  ev_detail::Throw(ss.str());
+}
+
+double Norm(const double* magnitudes, int length) {
+  if (length == 0)
+    ev_detail::Throw("EuclideanVector with no dimensions does not have a norm");
+
+  return std::sqrt(ev_kernels::SumOfSquares(magnitudes, length));
+}
+
+EuclideanVector UnitVector(EuclideanVectorView v) {
+  if (v.GetNumDimensions() == 0)
+    ev_detail::Throw("EuclideanVector with no dimensions does not have a unit vector");
+  double norm = v.GetEuclideanNorm();
+  if (norm == 0.0)
+    ev_detail::Throw("EuclideanVector with euclidean normal of 0 does not have a unit vector");
+
+  return v / norm;
+}
+
+}  // namespace
+
+// EuclideanVectorView
+
+EuclideanVectorView::operator std::vector<double>() const noexcept {
+  return std::vector<double>(magnitudes_, magnitudes_ + vectorLength_);
+}
+
+EuclideanVectorView::operator std::list<double>() const noexcept {
+  return std::list<double>(magnitudes_, magnitudes_ + vectorLength_);
+}
+
+double EuclideanVectorView::at(int index) const {
+  if (index < 0 || index >= vectorLength_)
+    ThrowInvalidIndex(index);
+
+  return magnitudes_[index];
+}
+
+double EuclideanVectorView::GetEuclideanNorm() const {
+  return Norm(magnitudes_, vectorLength_);
+}
+
+EuclideanVector EuclideanVectorView::CreateUnitVector() const {
+  return UnitVector(*this);
+}
+
+// MutableEuclideanVectorView
+
+const MutableEuclideanVectorView& MutableEuclideanVectorView::
+operator+=(EuclideanVectorView v) const {
+  ev_detail::CheckDimensions(vectorLength_, v.GetNumDimensions());
+  if (ev_detail::ReadsShifted(v, magnitudes_, vectorLength_))
+    return *this += EuclideanVector(v);
+
+  ev_kernels::Add(magnitudes_, v.data(), vectorLength_);
+
+  return *this;
+}
+
+const MutableEuclideanVectorView& MutableEuclideanVectorView::
+operator-=(EuclideanVectorView v) const {
+  ev_detail::CheckDimensions(vectorLength_, v.GetNumDimensions());
+  if (ev_detail::ReadsShifted(v, magnitudes_, vectorLength_))
+    return *this -= EuclideanVector(v);
+
+  ev_kernels::Subtract(magnitudes_, v.data(), vectorLength_);
+
+  return *this;
+}
+
+const MutableEuclideanVectorView& MutableEuclideanVectorView::operator*=(double d) const noexcept {
+  ev_kernels::Scale(magnitudes_, d, vectorLength_);
+
+  return *this;
+}
+
+const MutableEuclideanVectorView& MutableEuclideanVectorView::operator/=(double d) const {
+  if (d == 0)
+    ev_detail::Throw("Invalid vector division by 0");
+
+  ev_kernels::Divide(magnitudes_, d, vectorLength_);
+
+  return *this;
+}
+
+MutableEuclideanVectorView::operator std::vector<double>() const noexcept {
+  return std::vector<double>(magnitudes_, magnitudes_ + vectorLength_);
+}
+
+MutableEuclideanVectorView::operator std::list<double>() const noexcept {
+  return std::list<double>(magnitudes_, magnitudes_ + vectorLength_);
+}
+
+double& MutableEuclideanVectorView::at(int index) const {
+  if (index < 0 || index >= vectorLength_)
+    ThrowInvalidIndex(index);
+
+  return magnitudes_[index];
+}
+
+double MutableEuclideanVectorView::GetEuclideanNorm() const {
+  return Norm(magnitudes_, vectorLength_);
+}
+
+EuclideanVector MutableEuclideanVectorView::CreateUnitVector() const {
+  return UnitVector(*this);
+}
+
+const MutableEuclideanVectorView& MutableEuclideanVectorView::Axpy(double a,
+                                                                   EuclideanVectorView x) const {
+  ev_detail::CheckDimensions(vectorLength_, x.GetNumDimensions());
+  if (ev_detail::ReadsShifted(x, magnitudes_, vectorLength_))
+    return Axpy(a, EuclideanVector(x));
+
+  ev_kernels::Axpy(magnitudes_, a, x.data(), vectorLength_);
+
+  return *this;
+}
+
+const MutableEuclideanVectorView& MutableEuclideanVectorView::Axpby(double a,
+                                                                    EuclideanVectorView x,
+                                                                    double b) const {
+  ev_detail::CheckDimensions(vectorLength_, x.GetNumDimensions());
+  if (ev_detail::ReadsShifted(x, magnitudes_, vectorLength_))
+    return Axpby(a, EuclideanVector(x), b);
+
+  ev_kernels::Axpby(magnitudes_, a, x.data(), b, vectorLength_);
+
+  return *this;
+}
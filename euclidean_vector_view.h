@@ -0,0 +1,127 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_VIEW_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_VIEW_H_
+
+#include <algorithm>
+#include <cassert>
+#include <list>
+#include <memory_resource>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+
+/*
+  Non-owning views of magnitudes that already live somewhere else (a std::vector, a network
+  buffer, a memory mapped file, a matrix column...).
+
+  EuclideanVectorView is read-only and MutableEuclideanVectorView can write through to the
+  buffer. Both are a pointer and a number of dimensions, are cheap to copy, and are
+  EuclideanVector expressions: they can be added, subtracted, scaled, dotted and compared with
+  EuclideanVectors and with each other, and a view inside an expression is never copied.
+  The buffer must outlive every view of it and every expression built from those views.
+
+  Copying a view copies the pointer, not the magnitudes (like std::span). To write magnitudes
+  through a MutableEuclideanVectorView use Assign() or the compound assignment operators.
+*/
+class EuclideanVectorView : public EuclideanVectorExpression<EuclideanVectorView> {
+ public:
+  // Constructors
+  EuclideanVectorView(const double* magnitudes, int length) noexcept
+    : magnitudes_{magnitudes}, vectorLength_{length} {
+    assert(length >= 0 && (magnitudes != nullptr || length == 0));
+  }
+  EuclideanVectorView(const std::vector<double>& v) noexcept  // NOLINT(runtime/explicit)
+    : EuclideanVectorView(v.data(), static_cast<int>(v.size())) {}
+  EuclideanVectorView(const EuclideanVector& v) noexcept  // NOLINT(runtime/explicit)
+    : EuclideanVectorView(v.data(), v.GetNumDimensions()) {}
+
+  // Operations
+  double operator[](const int index) const noexcept {
+    assert(index >= 0 && index < vectorLength_);
+
+    return magnitudes_[index];
+  }
+  explicit operator std::vector<double>() const noexcept;
+  explicit operator std::list<double>() const noexcept;
+
+  // Methods
+  double at(int) const;
+  int GetNumDimensions() const noexcept { return vectorLength_; }
+  std::pmr::polymorphic_allocator<double> get_allocator() const noexcept { return {}; }
+  const double* data() const noexcept { return magnitudes_; }
+  double GetEuclideanNorm() const;
+  EuclideanVector CreateUnitVector() const;
+
+ private:
+  const double* magnitudes_;
+  int vectorLength_;
+};
+
+class MutableEuclideanVectorView : public EuclideanVectorExpression<MutableEuclideanVectorView> {
+ public:
+  // Constructors
+  MutableEuclideanVectorView(double* magnitudes, int length) noexcept
+    : magnitudes_{magnitudes}, vectorLength_{length} {
+    assert(length >= 0 && (magnitudes != nullptr || length == 0));
+  }
+  MutableEuclideanVectorView(std::vector<double>& v) noexcept  // NOLINT(runtime/explicit)
+    : MutableEuclideanVectorView(v.data(), static_cast<int>(v.size())) {}
+  MutableEuclideanVectorView(EuclideanVector& v) noexcept  // NOLINT(runtime/explicit)
+    : MutableEuclideanVectorView(v.data(), v.GetNumDimensions()) {}
+
+  // Operations
+  double& operator[](const int index) const noexcept {
+    assert(index >= 0 && index < vectorLength_);
+
+    return magnitudes_[index];
+  }
+  // The SIMD kernels read ahead of the magnitudes they write, so an operand shifted into the
+  // viewed magnitudes is copied into a temporary EuclideanVector first (see Assign)
+  const MutableEuclideanVectorView& operator+=(EuclideanVectorView) const;
+  const MutableEuclideanVectorView& operator-=(EuclideanVectorView) const;
+  const MutableEuclideanVectorView& operator*=(double) const noexcept;
+  const MutableEuclideanVectorView& operator/=(double) const;
+  operator EuclideanVectorView() const noexcept {  // NOLINT(runtime/explicit)
+    return {magnitudes_, vectorLength_};
+  }
+  explicit operator std::vector<double>() const noexcept;
+  explicit operator std::list<double>() const noexcept;
+
+  // Methods
+  double& at(int) const;
+  int GetNumDimensions() const noexcept { return vectorLength_; }
+  std::pmr::polymorphic_allocator<double> get_allocator() const noexcept { return {}; }
+  double* data() const noexcept { return magnitudes_; }
+  double GetEuclideanNorm() const;
+  EuclideanVector CreateUnitVector() const;
+  // Writes the expression into the viewed magnitudes in a single pass. The expression may
+  // refer to the same magnitudes; if it reads them at another offset (a view shifted into the
+  // same buffer), it is evaluated into a temporary EuclideanVector first.
+  template <typename E>
+  const MutableEuclideanVectorView& Assign(const EuclideanVectorExpression<E>& e) const {
+    ev_detail::CheckDimensions(vectorLength_, e.GetNumDimensions());
+    const E& expression = e.Derived();
+    if (ev_detail::ReadsShifted(expression, magnitudes_, vectorLength_)) {
+      const auto result = EuclideanVector(expression);
+      std::copy(result.data(), result.data() + vectorLength_, magnitudes_);
+      return *this;
+    }
+    if constexpr (ev_detail::HasKernelEvaluation<E, double>::value) {
+      if (expression.EvaluateWithKernel(magnitudes_))
+        return *this;
+    }
+    for (int i = 0; i < vectorLength_; i++)
+      magnitudes_[i] = expression[i];
+    return *this;
+  }
+  // In-place fused updates, as EuclideanVector::Axpy and EuclideanVector::Axpby
+  const MutableEuclideanVectorView& Axpy(double a, EuclideanVectorView x) const;
+  const MutableEuclideanVectorView& Axpby(double a, EuclideanVectorView x, double b) const;
+
+ private:
+  double* magnitudes_;
+  int vectorLength_;
+};
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_VIEW_H_
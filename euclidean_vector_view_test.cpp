@@ -0,0 +1,303 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Views must behave exactly like a EuclideanVector holding the same magnitudes, so every
+  operation is checked against the EuclideanVector result, which euclidean_vector_test.cpp
+  already covers. On top of that the tests check what only views do: they read and write the
+  buffer they were created from, and they are not copied inside expressions.
+  Failure scenarios follow the EuclideanVector error messages.
+
+*/
+
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_view.h"
+#include "catch.h"
+
+SCENARIO("Create views of existing magnitudes") {
+  GIVEN("That there is a buffer of 5 magnitudes") {
+    std::vector<double> buffer{1.0, 2.0, 3.0, 4.0, 5.0};
+    WHEN("A view of the buffer is created") {
+      auto view = EuclideanVectorView(buffer);
+      THEN("The view reads the buffer without copying it") {
+        REQUIRE(view.GetNumDimensions() == 5);
+        REQUIRE(view.data() == buffer.data());
+        REQUIRE(view[2] == 3.0);
+        REQUIRE(view.at(4) == 5.0);
+      }
+      AND_WHEN("The buffer is changed") {
+        buffer[0] = 10.0;
+        THEN("The view sees the change") { REQUIRE(view[0] == 10.0); }
+      }
+    }
+    WHEN("A view of the last 3 magnitudes is created from a pointer and a length") {
+      auto view = EuclideanVectorView(buffer.data() + 2, 3);
+      THEN("It is equal to a EuclideanVector with the same magnitudes") {
+        REQUIRE(view == EuclideanVector(buffer.begin() + 2, buffer.end()));
+        REQUIRE(static_cast<std::vector<double>>(view) == std::vector<double>{3.0, 4.0, 5.0});
+        REQUIRE(static_cast<std::list<double>>(view) == std::list<double>{3.0, 4.0, 5.0});
+      }
+    }
+    WHEN("A mutable view of the buffer is written through") {
+      auto view = MutableEuclideanVectorView(buffer);
+      view[0] = 7.0;
+      view.at(1) = 8.0;
+      THEN("The buffer is changed") {
+        REQUIRE(buffer[0] == 7.0);
+        REQUIRE(buffer[1] == 8.0);
+      }
+    }
+  }
+  GIVEN("That there is a EuclideanVector") {
+    auto ev = EuclideanVector(6, 2.0);
+    WHEN("A read-only and a mutable view of it are created") {
+      EuclideanVectorView view = ev;
+      MutableEuclideanVectorView mutableView = ev;
+      THEN("Both views refer to the vector's magnitudes") {
+        REQUIRE(view.data() == ev.data());
+        REQUIRE(mutableView.data() == ev.data());
+        REQUIRE(view == ev);
+        REQUIRE(mutableView == ev);
+      }
+      AND_WHEN("The mutable view is converted to a read-only view") {
+        EuclideanVectorView readOnly = mutableView;
+        THEN("It refers to the same magnitudes") { REQUIRE(readOnly.data() == ev.data()); }
+      }
+    }
+  }
+}
+
+SCENARIO("Combine views and EuclideanVectors") {
+  GIVEN("That there are two buffers and a EuclideanVector with 5 dimensions") {
+    std::vector<double> buffer1{1.0, -2.0, 3.0, -4.0, 5.0};
+    std::vector<double> buffer2{0.5, 1.5, 2.5, 3.5, 4.5};
+    auto ev1 = EuclideanVector(buffer1.begin(), buffer1.end());
+    auto ev2 = EuclideanVector(buffer2.begin(), buffer2.end());
+    auto view1 = EuclideanVectorView(buffer1);
+    auto view2 = EuclideanVectorView(buffer2);
+    WHEN("Views are added, subtracted, scaled and divided") {
+      EuclideanVector sum = view1 + view2;
+      EuclideanVector mixed = view1 - ev2 * 2.0 + 3.0 * view2 / 4.0;
+      THEN("The results match the same operations on EuclideanVectors") {
+        REQUIRE(sum == ev1 + ev2);
+        REQUIRE(mixed == EuclideanVector(ev1 - ev2 * 2.0 + 3.0 * ev2 / 4.0));
+      }
+    }
+    WHEN("The dot product, norm and unit vector of views are computed") {
+      THEN("They match the EuclideanVector results") {
+        REQUIRE(view1 * view2 == ev1 * ev2);
+        REQUIRE(view1 * ev2 == ev1 * ev2);
+        REQUIRE(view1.GetEuclideanNorm() == ev1.GetEuclideanNorm());
+        REQUIRE(view1.CreateUnitVector() == ev1.CreateUnitVector());
+      }
+    }
+    WHEN("Views and vectors are compared") {
+      THEN("Equality compares the magnitudes, not the buffers") {
+        REQUIRE(view1 == ev1);
+        REQUIRE(ev1 == view1);
+        REQUIRE(view1 != view2);
+        REQUIRE(view1 != EuclideanVectorView(buffer1.data(), 4));
+      }
+    }
+    WHEN("A view is printed") {
+      std::ostringstream viewStream;
+      std::ostringstream vectorStream;
+      viewStream << view1;
+      vectorStream << ev1;
+      THEN("It prints like a EuclideanVector") { REQUIRE(viewStream.str() == vectorStream.str()); }
+    }
+    WHEN("A view is added to and subtracted from a EuclideanVector") {
+      ev2 += view1;
+      THEN("The EuclideanVector is updated") {
+        REQUIRE(ev2 == EuclideanVector(EuclideanVectorView(buffer2) + ev1));
+      }
+      ev2 -= view1;
+      THEN("Subtracting it again restores the EuclideanVector") { REQUIRE(ev2 == view2); }
+    }
+  }
+  GIVEN("That there is a EuclideanVector with 10 dimensions 1, 2, ..., 10") {
+    auto ev = EuclideanVector(10);
+    for (int i = 0; i < 10; i++)
+      ev[i] = i + 1.0;
+    WHEN("A view of its first 6 magnitudes, and an expression of it, are assigned to it") {
+      auto copy = ev;
+      ev = EuclideanVectorView(ev.data(), 6);
+      copy = EuclideanVectorView(copy.data() + 4, 3) * 2.0;
+      THEN("The magnitudes are read before the old storage is released") {
+        REQUIRE(ev.GetNumDimensions() == 6);
+        for (int i = 0; i < 6; i++)
+          REQUIRE(ev[i] == i + 1.0);
+        REQUIRE(copy.GetNumDimensions() == 3);
+        REQUIRE(copy[0] == 10.0);
+        REQUIRE(copy[2] == 14.0);
+      }
+    }
+  }
+}
+
+SCENARIO("Update magnitudes through a MutableEuclideanVectorView") {
+  GIVEN("That there is a mutable view of a buffer and a EuclideanVector with 4 dimensions") {
+    std::vector<double> buffer{1.0, 2.0, 3.0, 4.0};
+    auto view = MutableEuclideanVectorView(buffer);
+    auto ev = EuclideanVector(4, 1.0);
+    WHEN("The compound assignment operators are applied") {
+      view += ev;
+      view *= 3.0;
+      view -= ev;
+      view /= 2.0;
+      THEN("The buffer holds the result") {
+        REQUIRE(buffer == std::vector<double>{2.5, 4.0, 5.5, 7.0});
+      }
+    }
+    WHEN("An expression referring to the view itself is assigned to it") {
+      view.Assign(view * 2.0 - ev);
+      THEN("The buffer holds the result") {
+        REQUIRE(buffer == std::vector<double>{1.0, 3.0, 5.0, 7.0});
+      }
+    }
+    WHEN("Axpy and Axpby are applied") {
+      view.Axpy(2.0, ev).Axpby(1.0, ev, 0.5);
+      THEN("The buffer holds the result") {
+        REQUIRE(buffer == std::vector<double>{2.5, 3.0, 3.5, 4.0});
+      }
+    }
+  }
+  GIVEN("That there are two buffers of 6 magnitudes 1, 2, ..., 6") {
+    std::vector<double> right{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    std::vector<double> left = right;
+    WHEN("Expressions of views shifted by one are assigned to overlapping mutable views") {
+      auto rightTail = MutableEuclideanVectorView(right.data() + 1, 5);
+      auto leftTail = EuclideanVectorView(left.data() + 1, 5);
+      rightTail.Assign(EuclideanVectorView(right.data(), 5) * 1.0);
+      MutableEuclideanVectorView(left.data(), 5).Assign(leftTail + EuclideanVector(5));
+      THEN("Every magnitude is read before it is overwritten") {
+        REQUIRE(right == std::vector<double>{1.0, 1.0, 2.0, 3.0, 4.0, 5.0});
+        REQUIRE(left == std::vector<double>{2.0, 3.0, 4.0, 5.0, 6.0, 6.0});
+      }
+    }
+  }
+  GIVEN("That there is a buffer of 20 magnitudes 1, 2, ..., 20, more than any SIMD register") {
+    std::vector<double> buffer(20);
+    for (int i = 0; i < 20; i++)
+      buffer[i] = i + 1.0;
+    const auto original = buffer;
+    auto tail = MutableEuclideanVectorView(buffer.data() + 1, 19);
+    auto head = MutableEuclideanVectorView(buffer.data(), 19);
+    const auto shiftedTail = EuclideanVectorView(buffer.data() + 1, 19);
+    const auto shiftedHead = EuclideanVectorView(buffer.data(), 19);
+    WHEN("A view shifted by one is added to and subtracted from the overlapping mutable view") {
+      tail += shiftedHead;
+      const auto sum = buffer;
+      buffer = original;
+      head -= shiftedTail;
+      THEN("Every magnitude is read before it is overwritten") {
+        for (int i = 1; i < 20; i++) {
+          REQUIRE(sum[i] == original[i] + original[i - 1]);
+          REQUIRE(buffer[i - 1] == -1.0);
+        }
+      }
+    }
+    WHEN("Axpy and Axpby are applied with a view shifted by one into the overlapping view") {
+      tail.Axpy(2.0, shiftedHead);
+      const auto axpy = buffer;
+      buffer = original;
+      head.Axpby(1.0, shiftedTail, 0.5);
+      THEN("Every magnitude is read before it is overwritten") {
+        for (int i = 1; i < 20; i++) {
+          REQUIRE(axpy[i] == original[i] + 2.0 * original[i - 1]);
+          REQUIRE(buffer[i - 1] == original[i] + 0.5 * original[i - 1]);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Views report the same errors as EuclideanVector") {
+  GIVEN("That there are views with 3 and 2 dimensions") {
+    std::vector<double> buffer{1.0, 2.0, 3.0};
+    auto view = MutableEuclideanVectorView(buffer);
+    auto shorter = EuclideanVectorView(buffer.data(), 2);
+    WHEN("They are added") {
+      try {
+        EuclideanVector sum = view + shorter;
+        std::cerr << sum << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Dimensions of LHS(3) and RHS(2) do not match") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Dimensions of LHS(3) and RHS(2) do not match") == 0);
+        }
+      }
+    }
+    WHEN("One is added to the other in place") {
+      try {
+        view += shorter;
+        std::cerr << view << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Dimensions of LHS(3) and RHS(2) do not match") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Dimensions of LHS(3) and RHS(2) do not match") == 0);
+          REQUIRE(buffer == std::vector<double>{1.0, 2.0, 3.0});
+        }
+      }
+    }
+    WHEN("Magnitude 3 is accessed") {
+      try {
+        auto magnitude = shorter.at(3);
+        std::cerr << magnitude << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Index 3 is not valid for this EuclideanVector object") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Index 3 is not valid for this EuclideanVector object") == 0);
+        }
+      }
+    }
+    WHEN("The view is divided by 0") {
+      try {
+        view /= 0;
+        std::cerr << view << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Invalid vector division by 0") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Invalid vector division by 0") == 0);
+        }
+      }
+    }
+  }
+  GIVEN("That there is a view with 0 dimensions") {
+    auto view = EuclideanVectorView(nullptr, 0);
+    WHEN("Its norm is obtained") {
+      try {
+        auto norm = view.GetEuclideanNorm();
+        std::cerr << norm << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : EuclideanVector with no dimensions does not have a norm") {
+          std::string err = e.what();
+          REQUIRE(err.compare("EuclideanVector with no dimensions does not have a norm") == 0);
+        }
+      }
+    }
+  }
+  GIVEN("That there is a view of magnitudes that are all 0") {
+    std::vector<double> zeros(3, 0.0);
+    auto view = EuclideanVectorView(zeros);
+    WHEN("Its unit vector is created") {
+      try {
+        auto unit = view.CreateUnitVector();
+        std::cerr << unit << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : EuclideanVector with euclidean normal of 0 does not have a "
+             "unit vector") {
+          std::string err = e.what();
+          REQUIRE(err.compare(
+                      "EuclideanVector with euclidean normal of 0 does not have a unit vector") ==
+                  0);
+        }
+      }
+    }
+  }
+}
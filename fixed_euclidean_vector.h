@@ -0,0 +1,198 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_FIXED_EUCLIDEAN_VECTOR_H_
+#define ASSIGNMENTS_EV_FIXED_EUCLIDEAN_VECTOR_H_
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <sstream>
+
+#include "assignments/ev/euclidean_vector.h"
+
+/*
+  FixedEuclideanVector<N, T> is a EuclideanVector whose number of dimensions is part of its type.
+
+  The magnitudes live in a std::array, so small vectors stay in registers and every loop has a
+  compile-time trip count. All arithmetic, the dot product, the norm and the unit vector are
+  constexpr, and combining vectors with different numbers of dimensions does not compile.
+
+  It converts explicitly from a EuclideanVector (checking the number of dimensions) and
+  implicitly to one, so it can be passed to code written against EuclideanVector.
+*/
+
+namespace ev_detail {
+
+// std::sqrt is not constexpr, so constant evaluation uses Newton's method instead
+template <typename T>
+constexpr T NewtonSqrt(T x) noexcept {
+  if (x == 0 || x == std::numeric_limits<T>::infinity())
+    return x;
+  if (!(x > 0))
+    return std::numeric_limits<T>::quiet_NaN();
+  T guess = x > 1 ? x : T{1};
+  T previous = 0;
+  while (true) {
+    T next = (guess + x / guess) / 2;
+    // Converged, or oscillating between the two neighbours of the exact root
+    if (next == guess || next == previous)
+      return next < guess ? next : guess;
+    previous = guess;
+    guess = next;
+  }
+}
+
+template <typename T>
+constexpr T Sqrt(T x) noexcept {
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+  if (!__builtin_is_constant_evaluated())
+    return std::sqrt(x);
+#endif
+#endif
+  return NewtonSqrt(x);
+}
+
+}  // namespace ev_detail
+
+template <std::size_t N, typename T = double>
+class FixedEuclideanVector {
+ public:
+  // Constructors
+  constexpr FixedEuclideanVector() noexcept : magnitudes_{} {}
+  constexpr explicit FixedEuclideanVector(T magnitude) noexcept : magnitudes_{} {
+    for (std::size_t i = 0; i < N; i++)
+      magnitudes_[i] = magnitude;
+  }
+  constexpr FixedEuclideanVector(const std::array<T, N>& magnitudes) noexcept  // NOLINT
+    : magnitudes_{magnitudes} {}
+  explicit FixedEuclideanVector(const EuclideanVector& v) : magnitudes_{} {
+    ev_detail::CheckDimensions(static_cast<int>(N), v.GetNumDimensions());
+    for (std::size_t i = 0; i < N; i++)
+      magnitudes_[i] = static_cast<T>(v[static_cast<int>(i)]);
+  }
+
+  // Friends
+
+  friend constexpr bool operator==(const FixedEuclideanVector& u,
+                                   const FixedEuclideanVector& v) noexcept {
+    for (std::size_t i = 0; i < N; i++) {
+      if (u.magnitudes_[i] != v.magnitudes_[i])
+        return false;
+    }
+    return true;
+  }
+
+  friend constexpr bool operator!=(const FixedEuclideanVector& u,
+                                   const FixedEuclideanVector& v) noexcept {
+    return !(u == v);
+  }
+
+  friend constexpr FixedEuclideanVector operator+(FixedEuclideanVector u,
+                                                  const FixedEuclideanVector& v) noexcept {
+    return u += v;
+  }
+
+  friend constexpr FixedEuclideanVector operator-(FixedEuclideanVector u,
+                                                  const FixedEuclideanVector& v) noexcept {
+    return u -= v;
+  }
+
+  // Dot product
+  friend constexpr T operator*(const FixedEuclideanVector& u,
+                               const FixedEuclideanVector& v) noexcept {
+    T dotProd{};
+    for (std::size_t i = 0; i < N; i++)
+      dotProd += u.magnitudes_[i] * v.magnitudes_[i];
+    return dotProd;
+  }
+
+  friend constexpr FixedEuclideanVector operator*(FixedEuclideanVector u, T d) noexcept {
+    return u *= d;
+  }
+
+  friend constexpr FixedEuclideanVector operator*(T d, FixedEuclideanVector u) noexcept {
+    return u *= d;
+  }
+
+  friend constexpr FixedEuclideanVector operator/(FixedEuclideanVector u, T d) {
+    return u /= d;
+  }
+
+  // Prints [a b c] in the format of FormatTo, exactly as the EuclideanVector it converts to
+  friend std::ostream& operator<<(std::ostream& os, const FixedEuclideanVector& v) noexcept {
+    return ev_detail::WriteText(os, v.magnitudes_.data(), static_cast<int>(N));
+  }
+
+  // Operations
+  constexpr T& operator[](std::size_t index) noexcept { return magnitudes_[index]; }
+  constexpr T operator[](std::size_t index) const noexcept { return magnitudes_[index]; }
+  constexpr FixedEuclideanVector& operator+=(const FixedEuclideanVector& v) noexcept {
+    for (std::size_t i = 0; i < N; i++)
+      magnitudes_[i] += v.magnitudes_[i];
+    return *this;
+  }
+  constexpr FixedEuclideanVector& operator-=(const FixedEuclideanVector& v) noexcept {
+    for (std::size_t i = 0; i < N; i++)
+      magnitudes_[i] -= v.magnitudes_[i];
+    return *this;
+  }
+  constexpr FixedEuclideanVector& operator*=(T d) noexcept {
+    for (std::size_t i = 0; i < N; i++)
+      magnitudes_[i] *= d;
+    return *this;
+  }
+  constexpr FixedEuclideanVector& operator/=(T d) {
+    if (d == 0)
+      ev_detail::Throw("Invalid vector division by 0");
+    for (std::size_t i = 0; i < N; i++)
+      magnitudes_[i] /= d;
+    return *this;
+  }
+  operator EuclideanVector() const {  // NOLINT(runtime/explicit)
+    auto v = EuclideanVector(static_cast<int>(N));
+    for (std::size_t i = 0; i < N; i++)
+      v[static_cast<int>(i)] = static_cast<double>(magnitudes_[i]);
+    return v;
+  }
+
+  // Methods
+  constexpr T& at(std::size_t index) {
+    if (index >= N)
+      ThrowInvalidIndex(index);
+    return magnitudes_[index];
+  }
+  constexpr T at(std::size_t index) const {
+    if (index >= N)
+      ThrowInvalidIndex(index);
+    return magnitudes_[index];
+  }
+  static constexpr int GetNumDimensions() noexcept { return static_cast<int>(N); }
+  constexpr T GetEuclideanNorm() const {
+    if (N == 0)
+      ev_detail::Throw("EuclideanVector with no dimensions does not have a norm");
+    return ev_detail::Sqrt(*this * *this);
+  }
+  constexpr FixedEuclideanVector CreateUnitVector() const {
+    if (N == 0)
+      ev_detail::Throw("EuclideanVector with no dimensions does not have a unit vector");
+    T norm = GetEuclideanNorm();
+    if (norm == 0)
+      ev_detail::Throw("EuclideanVector with euclidean normal of 0 does not have a unit vector");
+    return *this / norm;
+  }
+  constexpr const std::array<T, N>& GetMagnitudes() const noexcept { return magnitudes_; }
+
+ private:
+  [[noreturn]] static void ThrowInvalidIndex(std::size_t index) {
+    std::ostringstream ss;
+    ss << "Index " << index << " is not valid for this EuclideanVector object";
+    ev_detail::Throw(ss.str());
+  }
+
+  std::array<T, N> magnitudes_;
+};
+
+#endif  // ASSIGNMENTS_EV_FIXED_EUCLIDEAN_VECTOR_H_
@@ -0,0 +1,156 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  FixedEuclideanVector mirrors the EuclideanVector interface, so the tests follow the same
+  success / failure pattern as euclidean_vector_test.cpp.
+
+  Because the whole point of the class is that its operations are constexpr, most of the
+  arithmetic is checked with static_assert: if any of it stops being usable in a constant
+  expression, this file stops compiling. Mismatched dimensions are a compile-time error and so
+  cannot be tested at run time.
+
+*/
+
+#include <array>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/fixed_euclidean_vector.h"
+#include "catch.h"
+
+namespace {
+
+using Vec3 = FixedEuclideanVector<3>;
+
+constexpr Vec3 kA{std::array<double, 3>{1.0, 2.0, 3.0}};
+constexpr Vec3 kB{std::array<double, 3>{4.0, 5.0, 6.0}};
+
+static_assert(Vec3::GetNumDimensions() == 3, "dimensions are part of the type");
+static_assert(kA + kB == Vec3{std::array<double, 3>{5.0, 7.0, 9.0}}, "constexpr +");
+static_assert(kB - kA == Vec3{3.0}, "constexpr -");
+static_assert(kA * kB == 32.0, "constexpr dot product");
+static_assert(kA * 2.0 == 2.0 * kA, "constexpr scalar multiplication");
+static_assert((kA * 2.0)[2] == 6.0, "constexpr scalar multiplication");
+static_assert((kB / 2.0)[0] == 2.0, "constexpr division");
+static_assert(FixedEuclideanVector<2>{std::array<double, 2>{3.0, 4.0}}.GetEuclideanNorm() == 5.0,
+              "constexpr norm");
+static_assert(FixedEuclideanVector<4>{1.0}.CreateUnitVector() == FixedEuclideanVector<4>{0.5},
+              "constexpr unit vector");
+static_assert(FixedEuclideanVector<4, float>{2.0f}.GetEuclideanNorm() == 4.0f, "float scalars");
+
+}  // namespace
+
+SCENARIO("Compute with a FixedEuclideanVector at run time") {
+  GIVEN("That there are two 3 dimensional vectors with magnitudes 1, 2, 3 and 4, 5, 6") {
+    auto a = kA;
+    auto b = kB;
+    WHEN("They are added, subtracted, scaled and divided") {
+      auto sum = a + b;
+      auto difference = b - a;
+      auto scaled = 2.0 * a;
+      auto divided = b / 2.0;
+      THEN("Each result is computed element by element") {
+        REQUIRE(sum == Vec3{std::array<double, 3>{5.0, 7.0, 9.0}});
+        REQUIRE(difference == Vec3{3.0});
+        REQUIRE(scaled == Vec3{std::array<double, 3>{2.0, 4.0, 6.0}});
+        REQUIRE(divided == Vec3{std::array<double, 3>{2.0, 2.5, 3.0}});
+      }
+    }
+    WHEN("The norm is obtained at run time") {
+      THEN("It matches std::sqrt") { REQUIRE(a.GetEuclideanNorm() == std::sqrt(14.0)); }
+    }
+    WHEN("The vector is divided by 0") {
+      try {
+        a /= 0.0;
+        std::cerr << a << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Invalid vector division by 0") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Invalid vector division by 0") == 0);
+        }
+      }
+    }
+    WHEN("An invalid index is accessed with at()") {
+      try {
+        auto value = a.at(3);
+        std::cerr << value << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Index 3 is not valid for this EuclideanVector object") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Index 3 is not valid for this EuclideanVector object") == 0);
+        }
+      }
+    }
+    WHEN("It is printed using the output stream") {
+      std::stringstream ss;
+      ss << a;
+      THEN("It is printed as [1 2 3]") { REQUIRE(ss.str() == "[1 2 3]"); }
+    }
+  }
+  GIVEN("That there is a vector whose magnitude needs 17 significant digits") {
+    auto v = FixedEuclideanVector<1>{{0.1 + 0.2}};
+    WHEN("It and the EuclideanVector it converts to are printed") {
+      std::stringstream fixed;
+      std::stringstream dynamic;
+      fixed << v;
+      dynamic << EuclideanVector(v);
+      THEN("Both print the shortest text that reads back to the same value") {
+        REQUIRE(fixed.str() == "[0.30000000000000004]");
+        REQUIRE(fixed.str() == dynamic.str());
+      }
+    }
+  }
+  GIVEN("That there is a vector whose norm is 0") {
+    auto zero = Vec3{};
+    WHEN("The unit vector is obtained") {
+      try {
+        auto unit = zero.CreateUnitVector();
+        std::cerr << unit << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : EuclideanVector with euclidean normal of 0 does not have a "
+             "unit vector") {
+          std::string err = e.what();
+          REQUIRE(err.compare(
+                      "EuclideanVector with euclidean normal of 0 does not have a unit vector") ==
+                  0);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Convert between FixedEuclideanVector and EuclideanVector") {
+  GIVEN("That there is a EuclideanVector with magnitudes 1, 2, 3") {
+    std::vector<double> mags{1.0, 2.0, 3.0};
+    auto ev = EuclideanVector(mags.begin(), mags.end());
+    WHEN("It is converted to a FixedEuclideanVector<3>") {
+      auto fixed = Vec3(ev);
+      THEN("The magnitudes are the same") { REQUIRE(fixed == kA); }
+      AND_WHEN("It is converted back") {
+        EuclideanVector back = fixed;
+        THEN("The round trip gives the original vector") { REQUIRE(back == ev); }
+      }
+    }
+    WHEN("It is passed to code written against EuclideanVector") {
+      auto norm = [](const EuclideanVector& v) { return v.GetEuclideanNorm(); };
+      THEN("The FixedEuclideanVector converts implicitly") {
+        REQUIRE(norm(kA) == ev.GetEuclideanNorm());
+      }
+    }
+    WHEN("It is converted to a FixedEuclideanVector<4>") {
+      try {
+        auto fixed = FixedEuclideanVector<4>(ev);
+        std::cerr << fixed << "is invalid. Control should not reach this line";
+      } catch (const EuclideanVectorError& e) {
+        THEN("Exception is thrown : Dimensions of LHS(4) and RHS(3) do not match") {
+          std::string err = e.what();
+          REQUIRE(err.compare("Dimensions of LHS(4) and RHS(3) do not match") == 0);
+        }
+      }
+    }
+  }
+}
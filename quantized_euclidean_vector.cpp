@@ -0,0 +1,110 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/quantized_euclidean_vector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_kernels.h"
+
+namespace {
+
+constexpr int kMaxCode = 127;
+
+}  // namespace
+
+// Constructors
+
+QuantizedEuclideanVector::QuantizedEuclideanVector(const EuclideanVector& v)
+  : codes_(v.GetNumDimensions()) {
+  const double* first = v.data();
+  const double* last = v.data() + v.GetNumDimensions();
+  if (!std::all_of(first, last, [](double x) { return std::isfinite(x); }))
+    ev_detail::Throw("EuclideanVector with non-finite magnitudes cannot be quantized");
+  if (first == last)
+    return;
+
+  const auto minMax = std::minmax_element(first, last);
+  // Halved before subtracting so that the range of [-DBL_MAX, DBL_MAX] does not overflow
+  offset_ = *minMax.first / 2 + *minMax.second / 2;
+  scale_ = (*minMax.second / 2 - *minMax.first / 2) / kMaxCode;
+  // Every magnitude is the same (or the range underflows): the offset alone represents them
+  if (scale_ == 0.0)
+    return;
+
+  for (int i = 0; i < v.GetNumDimensions(); i++) {
+    const auto code = std::lround((v[i] - offset_) / scale_);
+    codes_[i] = static_cast<std::int8_t>(std::clamp<long>(code, -kMaxCode, kMaxCode));
+    sumOfCodes_ += codes_[i];
+  }
+  sumOfSquaredCodes_ = ev_kernels::DotInt8(codes_.data(), codes_.data(), GetNumDimensions());
+}
+
+// Friends
+
+double operator*(const QuantizedEuclideanVector& u, const QuantizedEuclideanVector& v) {
+  ev_detail::CheckDimensions(u.GetNumDimensions(), v.GetNumDimensions());
+
+  const double dotCodes =
+      static_cast<double>(ev_kernels::DotInt8(u.data(), v.data(), u.GetNumDimensions()));
+  return u.GetNumDimensions() * u.offset_ * v.offset_ +
+         u.offset_ * v.scale_ * static_cast<double>(v.sumOfCodes_) +
+         v.offset_ * u.scale_ * static_cast<double>(u.sumOfCodes_) +
+         u.scale_ * v.scale_ * dotCodes;
+}
+
+double Distance(const QuantizedEuclideanVector& u, const QuantizedEuclideanVector& v) {
+  ev_detail::CheckDimensions(u.GetNumDimensions(), v.GetNumDimensions());
+
+  // sum((du + su qu - sv qv)^2) with du the difference of the offsets. Expanding it this way,
+  // rather than as |u|^2 + |v|^2 - 2 u.v, keeps the (possibly large) offsets from cancelling.
+  const double offsetDifference = u.offset_ - v.offset_;
+  const double dotCodes =
+      static_cast<double>(ev_kernels::DotInt8(u.data(), v.data(), u.GetNumDimensions()));
+  const double squared =
+      u.GetNumDimensions() * offsetDifference * offsetDifference +
+      2 * offsetDifference *
+          (u.scale_ * static_cast<double>(u.sumOfCodes_) -
+           v.scale_ * static_cast<double>(v.sumOfCodes_)) +
+      u.scale_ * u.scale_ * static_cast<double>(u.sumOfSquaredCodes_) +
+      v.scale_ * v.scale_ * static_cast<double>(v.sumOfSquaredCodes_) -
+      2 * u.scale_ * v.scale_ * dotCodes;
+  return std::sqrt(std::max(squared, 0.0));
+}
+
+// Methods
+
+double QuantizedEuclideanVector::at(int index) const {
+  if (index < 0 || index >= GetNumDimensions()) {
+    std::ostringstream ss;
+    ss << "Index " << index << " is not valid for this QuantizedEuclideanVector object";
+    ev_detail::Throw(ss.str());
+  }
+
+  return (*this)[index];
+}
+
+double QuantizedEuclideanVector::GetEuclideanNorm() const {
+  if (GetNumDimensions() == 0)
+    ev_detail::Throw("EuclideanVector with no dimensions does not have a norm");
+
+  return std::sqrt(SumOfSquares());
+}
+
+EuclideanVector QuantizedEuclideanVector::Dequantize() const {
+  auto v = EuclideanVector(GetNumDimensions());
+  for (int i = 0; i < GetNumDimensions(); i++)
+    v[i] = (*this)[i];
+  return v;
+}
+
+double QuantizedEuclideanVector::SumOfSquares() const noexcept {
+  // sum((o + s q)^2), which rounding can take just below 0
+  const double sum = GetNumDimensions() * offset_ * offset_ +
+                     2 * offset_ * scale_ * static_cast<double>(sumOfCodes_) +
+                     scale_ * scale_ * static_cast<double>(sumOfSquaredCodes_);
+  return std::max(sum, 0.0);
+}
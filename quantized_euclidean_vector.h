@@ -0,0 +1,74 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_QUANTIZED_EUCLIDEAN_VECTOR_H_
+#define ASSIGNMENTS_EV_QUANTIZED_EUCLIDEAN_VECTOR_H_
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+
+/*
+  QuantizedEuclideanVector stores a EuclideanVector in one byte per dimension.
+
+  Every magnitude x is stored as an int8 code q in [-127, 127] with a per-vector scale and
+  offset, so that x ~ offset + scale * q. The offset is the middle of [min, max] of the
+  magnitudes and the scale spreads that range over the 255 codes, so every dequantized
+  magnitude is within GetMaxError() = scale / 2 of the original.
+
+  Dot products, norms and distances are computed on the codes with an exact integer dot product
+  (ev_kernels::DotInt8), plus the per-vector sums of the codes:
+    u . v ~ n ou ov + ou sv sum(qv) + ov su sum(qu) + su sv sum(qu qv)
+  The result is the exact dot product of the two dequantized vectors, up to double rounding, so
+  it differs from the dot product of the original vectors by at most
+    eu * sum(|v[i]|) + ev * sum(|u[i]|) + n eu ev
+  where eu and ev are the GetMaxError() of the two vectors.
+*/
+class QuantizedEuclideanVector {
+ public:
+  // Constructors
+  // A vector with 0 dimensions
+  QuantizedEuclideanVector() noexcept = default;
+  // Quantizes the given vector, whose magnitudes must all be finite
+  explicit QuantizedEuclideanVector(const EuclideanVector&);
+
+  // Friends
+  // Approximate dot product
+  friend double operator*(const QuantizedEuclideanVector&, const QuantizedEuclideanVector&);
+  // Approximate euclidean distance
+  friend double Distance(const QuantizedEuclideanVector&, const QuantizedEuclideanVector&);
+
+  // Operations
+  // Dequantized magnitude
+  double operator[](const int index) const noexcept {
+    assert(index >= 0 && index < GetNumDimensions());
+
+    return offset_ + scale_ * codes_[index];
+  }
+
+  // Methods
+  double at(int) const;
+  int GetNumDimensions() const noexcept { return static_cast<int>(codes_.size()); }
+  double GetScale() const noexcept { return scale_; }
+  double GetOffset() const noexcept { return offset_; }
+  // Largest difference between a magnitude and its dequantized value
+  double GetMaxError() const noexcept { return scale_ / 2; }
+  const std::int8_t* data() const noexcept { return codes_.data(); }
+  // Approximate euclidean norm
+  double GetEuclideanNorm() const;
+  EuclideanVector Dequantize() const;
+
+ private:
+  // Sum of the squares of the dequantized magnitudes
+  double SumOfSquares() const noexcept;
+
+  std::vector<std::int8_t> codes_;
+  double scale_ = 0.0;
+  double offset_ = 0.0;
+  // Sum of the codes and of their squares, for the terms of the dot product that involve offsets
+  std::int64_t sumOfCodes_ = 0;
+  std::int64_t sumOfSquaredCodes_ = 0;
+};
+
+#endif  // ASSIGNMENTS_EV_QUANTIZED_EUCLIDEAN_VECTOR_H_
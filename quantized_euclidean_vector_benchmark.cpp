@@ -0,0 +1,103 @@
+// Created By : Rahil Agrawal
+//
+// Memory use and throughput of QuantizedEuclideanVector against double and float
+// EuclideanVectors, for the dot product and the distance, over 16 to 2^20 dimensions.
+//
+// Every benchmark reports bytes/vector (the magnitudes or codes plus the object itself, which
+// is what a corpus of these vectors costs per entry) and bytes/s of magnitudes or codes read.
+// The int8 dot product runs on the kernels of the instruction set named in the label.
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_kernels.h"
+#include "assignments/ev/quantized_euclidean_vector.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+template <typename T>
+BasicEuclideanVector<T> RandomVector(int n, unsigned seed) {
+  std::mt19937 gen{seed};
+  std::uniform_real_distribution<double> dist{-1.0, 1.0};
+  auto v = BasicEuclideanVector<T>(n);
+  for (int i = 0; i < n; i++)
+    v[i] = static_cast<T>(dist(gen));
+  return v;
+}
+
+template <typename T>
+void ReportMemory(benchmark::State& state, int n, std::size_t objectSize, int vectorsRead) {
+  state.counters["bytes/vector"] = static_cast<double>(objectSize + n * sizeof(T));
+  state.SetBytesProcessed(state.iterations() * vectorsRead * n * sizeof(T));
+  state.SetLabel(ev_kernels::IsaName(ev_kernels::DetectIsa()));
+}
+
+void BM_DoubleDot(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  auto u = RandomVector<double>(n, 1);
+  auto v = RandomVector<double>(n, 2);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(u * v);
+  ReportMemory<double>(state, n, sizeof(EuclideanVector), 2);
+}
+
+void BM_FloatDot(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  auto u = RandomVector<float>(n, 1);
+  auto v = RandomVector<float>(n, 2);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(u * v);
+  ReportMemory<float>(state, n, sizeof(BasicEuclideanVector<float>), 2);
+}
+
+void BM_QuantizedDot(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  auto u = QuantizedEuclideanVector(RandomVector<double>(n, 1));
+  auto v = QuantizedEuclideanVector(RandomVector<double>(n, 2));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(u * v);
+  ReportMemory<std::int8_t>(state, n, sizeof(QuantizedEuclideanVector), 2);
+}
+
+void BM_DoubleDistance(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  auto u = RandomVector<double>(n, 1);
+  auto v = RandomVector<double>(n, 2);
+  for (auto _ : state) {
+    // u.u + v.v - 2 u.v, so that no temporary vector is allocated
+    benchmark::DoNotOptimize(std::sqrt(u * u + v * v - 2 * (u * v)));
+  }
+  ReportMemory<double>(state, n, sizeof(EuclideanVector), 2);
+}
+
+void BM_QuantizedDistance(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  auto u = QuantizedEuclideanVector(RandomVector<double>(n, 1));
+  auto v = QuantizedEuclideanVector(RandomVector<double>(n, 2));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Distance(u, v));
+  ReportMemory<std::int8_t>(state, n, sizeof(QuantizedEuclideanVector), 2);
+}
+
+void BM_Quantize(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  auto v = RandomVector<double>(n, 1);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(QuantizedEuclideanVector(v));
+  ReportMemory<double>(state, n, sizeof(EuclideanVector), 1);
+}
+
+// 16, 64, 256, ..., 2^20 dimensions
+BENCHMARK(BM_DoubleDot)->RangeMultiplier(4)->Range(16, 1 << 20);
+BENCHMARK(BM_FloatDot)->RangeMultiplier(4)->Range(16, 1 << 20);
+BENCHMARK(BM_QuantizedDot)->RangeMultiplier(4)->Range(16, 1 << 20);
+BENCHMARK(BM_DoubleDistance)->RangeMultiplier(4)->Range(16, 1 << 20);
+BENCHMARK(BM_QuantizedDistance)->RangeMultiplier(4)->Range(16, 1 << 20);
+BENCHMARK(BM_Quantize)->RangeMultiplier(4)->Range(16, 1 << 20);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,191 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Quantization is lossy, so the tests check the documented error bounds rather than exact
+  values: every dequantized magnitude is within GetMaxError() of the original, and the
+  approximate dot product, norm and distance are within the bounds derived from it of the exact
+  EuclideanVector results (operator*, GetEuclideanNorm and the norm of the difference).
+
+  The bounds are checked for random vectors of several sizes, including vectors whose
+  magnitudes are far from 0 (where the offset dominates), constant vectors (where the scale is
+  0) and vectors large enough to exercise every SIMD loop and tail.
+  Failure scenarios follow the EuclideanVector error messages.
+
+*/
+
+#include <cfloat>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_testing.h"
+#include "assignments/ev/quantized_euclidean_vector.h"
+#include "catch.h"
+
+namespace {
+
+EuclideanVector RandomVector(int n, double low, double high, unsigned seed) {
+  return ev_testing::RandomVectors(1, n, seed, low, high)[0];
+}
+
+double SumOfAbsolutes(const EuclideanVector& v) {
+  auto sum = 0.0;
+  for (int i = 0; i < v.GetNumDimensions(); i++)
+    sum += std::abs(v[i]);
+  return sum;
+}
+
+// Rounding of the double arithmetic, on top of the quantization error
+double RoundingSlack(double magnitude, int n) {
+  return 8 * (n + 1) * DBL_EPSILON * magnitude;
+}
+
+const std::vector<int> kSizes{1, 2, 7, 31, 64, 65, 300, 4099};
+
+}  // namespace
+
+SCENARIO("Quantize and dequantize a EuclideanVector") {
+  for (auto n : kSizes) {
+    GIVEN("That there is a random vector with " + std::to_string(n) + " dimensions") {
+      auto ev = RandomVector(n, -3.0, 5.0, n);
+      WHEN("It is quantized") {
+        auto qv = QuantizedEuclideanVector(ev);
+        THEN("It has one code per dimension, every code within [-127, 127]") {
+          REQUIRE(qv.GetNumDimensions() == n);
+          REQUIRE(qv.GetMaxError() == qv.GetScale() / 2);
+          for (int i = 0; i < n; i++)
+            REQUIRE(std::abs(qv.data()[i]) <= 127);
+        }
+        THEN("Every dequantized magnitude is within the maximum error of the original") {
+          auto dequantized = qv.Dequantize();
+          REQUIRE(dequantized.GetNumDimensions() == n);
+          for (int i = 0; i < n; i++) {
+            REQUIRE(std::abs(dequantized[i] - ev[i]) <=
+                    qv.GetMaxError() + RoundingSlack(5.0, 1));
+            REQUIRE(qv[i] == dequantized[i]);
+            REQUIRE(qv.at(i) == dequantized[i]);
+          }
+        }
+      }
+    }
+  }
+  GIVEN("That there is a vector with magnitudes 1, 2 and 3") {
+    auto ev = EuclideanVector(3);
+    ev[0] = 1.0;
+    ev[1] = 2.0;
+    ev[2] = 3.0;
+    WHEN("It is quantized") {
+      auto qv = QuantizedEuclideanVector(ev);
+      THEN("The smallest and largest magnitudes use the extreme codes") {
+        REQUIRE(qv.GetOffset() == 2.0);
+        REQUIRE(qv.data()[0] == -127);
+        REQUIRE(qv.data()[1] == 0);
+        REQUIRE(qv.data()[2] == 127);
+      }
+    }
+  }
+  GIVEN("That there is a vector with every magnitude equal to 4.5") {
+    auto ev = EuclideanVector(10, 4.5);
+    WHEN("It is quantized") {
+      auto qv = QuantizedEuclideanVector(ev);
+      THEN("The offset represents every magnitude exactly") {
+        REQUIRE(qv.GetScale() == 0.0);
+        REQUIRE(qv.Dequantize() == ev);
+        REQUIRE(qv.GetEuclideanNorm() == Approx(ev.GetEuclideanNorm()));
+      }
+    }
+  }
+  GIVEN("That there is a vector with 0 dimensions") {
+    auto qv = QuantizedEuclideanVector(EuclideanVector(0));
+    WHEN("It is dequantized") {
+      THEN("The vector has 0 dimensions") {
+        REQUIRE(qv.GetNumDimensions() == 0);
+        REQUIRE(qv.Dequantize().GetNumDimensions() == 0);
+      }
+    }
+    WHEN("The euclidean norm is obtained") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(qv.GetEuclideanNorm(),
+                            "EuclideanVector with no dimensions does not have a norm");
+      }
+    }
+  }
+  GIVEN("That there is a vector with an infinite magnitude") {
+    auto ev = EuclideanVector(3, 1.0);
+    ev[1] = INFINITY;
+    WHEN("It is quantized") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(QuantizedEuclideanVector(ev),
+                            "EuclideanVector with non-finite magnitudes cannot be quantized");
+      }
+    }
+  }
+  GIVEN("That there is a quantized vector with 3 dimensions") {
+    auto qv = QuantizedEuclideanVector(EuclideanVector(3, 1.0));
+    WHEN("An invalid index is accessed") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(qv.at(3),
+                            "Index 3 is not valid for this QuantizedEuclideanVector object");
+        REQUIRE_THROWS_WITH(qv.at(-1),
+                            "Index -1 is not valid for this QuantizedEuclideanVector object");
+      }
+    }
+  }
+}
+
+SCENARIO("Compute approximate dot products, norms and distances on the codes") {
+  for (auto n : kSizes) {
+    for (auto center : {0.0, 1000.0}) {
+      GIVEN("That there are two random vectors with " + std::to_string(n) +
+            " dimensions around " + std::to_string(center)) {
+        auto ev1 = RandomVector(n, center - 2.0, center + 3.0, 2 * n);
+        auto ev2 = RandomVector(n, center - 4.0, center + 1.0, 2 * n + 1);
+        auto qv1 = QuantizedEuclideanVector(ev1);
+        auto qv2 = QuantizedEuclideanVector(ev2);
+        const double e1 = qv1.GetMaxError();
+        const double e2 = qv2.GetMaxError();
+        const double largest = (center + 4.0) * (center + 4.0) * n;
+        WHEN("The dot product is computed on the codes") {
+          auto dotProd = qv1 * qv2;
+          THEN("It is within the documented bound of the exact dot product") {
+            auto bound = e1 * SumOfAbsolutes(ev2) + e2 * SumOfAbsolutes(ev1) + n * e1 * e2;
+            REQUIRE(std::abs(dotProd - ev1 * ev2) <= bound + RoundingSlack(largest, n));
+          }
+        }
+        WHEN("The euclidean norm is computed on the codes") {
+          auto norm = qv1.GetEuclideanNorm();
+          THEN("It is within sqrt(n) times the maximum error of the exact norm") {
+            REQUIRE(std::abs(norm - ev1.GetEuclideanNorm()) <=
+                    std::sqrt(n) * e1 + RoundingSlack(largest, n) / ev1.GetEuclideanNorm());
+          }
+        }
+        WHEN("The distance is computed on the codes") {
+          auto distance = Distance(qv1, qv2);
+          THEN("It is within sqrt(n) times the sum of the maximum errors of the exact distance") {
+            auto exact = EuclideanVector(ev1 - ev2).GetEuclideanNorm();
+            REQUIRE(std::abs(distance - exact) <=
+                    std::sqrt(n) * (e1 + e2) + std::sqrt(RoundingSlack(largest, n)));
+          }
+        }
+      }
+    }
+  }
+  GIVEN("That there is a quantized vector") {
+    auto qv = QuantizedEuclideanVector(RandomVector(100, 10.0, 20.0, 3));
+    WHEN("Its distance to itself is computed") {
+      THEN("It is 0") { REQUIRE(Distance(qv, qv) <= 1e-6); }
+    }
+  }
+  GIVEN("That there are quantized vectors with 2 and 3 dimensions") {
+    auto qv1 = QuantizedEuclideanVector(EuclideanVector(2, 1.0));
+    auto qv2 = QuantizedEuclideanVector(EuclideanVector(3, 1.0));
+    WHEN("Their dot product and distance are computed") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(qv1 * qv2, "Dimensions of LHS(2) and RHS(3) do not match");
+        REQUIRE_THROWS_WITH(Distance(qv1, qv2), "Dimensions of LHS(2) and RHS(3) do not match");
+      }
+    }
+  }
+}
@@ -0,0 +1,284 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/sparse_euclidean_vector.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_kernels.h"
+
+namespace {
+
+[[noreturn]] void ThrowInvalidIndex(int index) {
+  std::ostringstream ss;
+  ss << "Index " << index << " is not valid for this SparseEuclideanVector object";
+  ev_detail::Throw(ss.str());
+}
+
+// Same message as a EuclideanVector with a negative number of dimensions
+void CheckNumDimensions(int numDimensions) {
+  if (numDimensions < 0) {
+    std::ostringstream ss;
+    ss << "Number of dimensions " << numDimensions << " is not valid";
+    ev_detail::Throw(ss.str());
+  }
+}
+
+}  // namespace
+
+// Constructors
+
+SparseEuclideanVector::SparseEuclideanVector(int numDimensions) : numDimensions_{numDimensions} {
+  CheckNumDimensions(numDimensions_);
+}
+
+SparseEuclideanVector::SparseEuclideanVector(int numDimensions,
+                                             std::vector<int> indices,
+                                             std::vector<double> values)
+  : numDimensions_{numDimensions}, indices_{std::move(indices)}, values_{std::move(values)} {
+  CheckNumDimensions(numDimensions_);
+  if (indices_.size() != values_.size()) {
+    std::ostringstream ss;
+    ss << "Number of indices(" << indices_.size() << ") and values(" << values_.size()
+       << ") do not match";
+    ev_detail::Throw(ss.str());
+  }
+  for (std::size_t k = 0; k < indices_.size(); k++) {
+    if (indices_[k] < 0 || indices_[k] >= numDimensions_)
+      ThrowInvalidIndex(indices_[k]);
+    if (k > 0 && indices_[k] <= indices_[k - 1])
+      ev_detail::Throw("Indices of a SparseEuclideanVector must be strictly increasing");
+  }
+}
+
+SparseEuclideanVector::SparseEuclideanVector(const EuclideanVector& v)
+  : numDimensions_{v.GetNumDimensions()} {
+  for (int i = 0; i < numDimensions_; i++) {
+    if (v[i] != 0.0) {
+      indices_.push_back(i);
+      values_.push_back(v[i]);
+    }
+  }
+}
+
+SparseEuclideanVector::SparseEuclideanVector(SparseEuclideanVector&& v) noexcept
+  : numDimensions_{v.numDimensions_}, indices_{std::move(v.indices_)},
+    values_{std::move(v.values_)} {
+  v.numDimensions_ = 0;
+  v.indices_.clear();
+  v.values_.clear();
+}
+
+// Friends
+
+bool operator==(const SparseEuclideanVector& u, const SparseEuclideanVector& v) noexcept {
+  if (u.numDimensions_ != v.numDimensions_)
+    return false;
+
+  // Merge the stored magnitudes; a magnitude stored on one side only must be 0
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < u.indices_.size() || j < v.indices_.size()) {
+    if (j == v.indices_.size() || (i < u.indices_.size() && u.indices_[i] < v.indices_[j])) {
+      if (u.values_[i++] != 0.0)
+        return false;
+    } else if (i == u.indices_.size() || v.indices_[j] < u.indices_[i]) {
+      if (v.values_[j++] != 0.0)
+        return false;
+    } else if (u.values_[i++] != v.values_[j++]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool operator!=(const SparseEuclideanVector& u, const SparseEuclideanVector& v) noexcept {
+  return !(u == v);
+}
+
+SparseEuclideanVector operator+(const SparseEuclideanVector& u, const SparseEuclideanVector& v) {
+  auto sum = u;
+  return sum += v;
+}
+
+SparseEuclideanVector operator-(const SparseEuclideanVector& u, const SparseEuclideanVector& v) {
+  auto difference = u;
+  return difference -= v;
+}
+
+double operator*(const SparseEuclideanVector& u, const SparseEuclideanVector& v) {
+  ev_detail::CheckDimensions(u.numDimensions_, v.numDimensions_);
+
+  // Only the indices stored in both vectors contribute
+  double dotProd = 0.0;
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < u.indices_.size() && j < v.indices_.size()) {
+    if (u.indices_[i] < v.indices_[j]) {
+      i++;
+    } else if (v.indices_[j] < u.indices_[i]) {
+      j++;
+    } else {
+      dotProd += u.values_[i++] * v.values_[j++];
+    }
+  }
+  return dotProd;
+}
+
+double operator*(const SparseEuclideanVector& u, const EuclideanVector& v) {
+  ev_detail::CheckDimensions(u.numDimensions_, v.GetNumDimensions());
+
+  return ev_kernels::SparseDot(u.indices_.data(), u.values_.data(), u.GetNumStored(), v.data());
+}
+
+double operator*(const EuclideanVector& u, const SparseEuclideanVector& v) {
+  ev_detail::CheckDimensions(u.GetNumDimensions(), v.numDimensions_);
+
+  return ev_kernels::SparseDot(v.indices_.data(), v.values_.data(), v.GetNumStored(), u.data());
+}
+
+SparseEuclideanVector operator*(SparseEuclideanVector v, double d) noexcept {
+  v *= d;
+  return v;
+}
+
+SparseEuclideanVector operator*(double d, SparseEuclideanVector v) noexcept {
+  v *= d;
+  return v;
+}
+
+SparseEuclideanVector operator/(SparseEuclideanVector v, double d) {
+  v /= d;
+  return v;
+}
+
+std::ostream& operator<<(std::ostream& os, const SparseEuclideanVector& v) noexcept {
+  char buffer[kMaxFormattedMagnitudeLength];
+  os.put('{');
+  for (int k = 0; k < v.GetNumStored(); k++) {
+    if (k != 0)
+      os.put(' ');
+    os << v.indices_[k];
+    os.put(':');
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), v.values_[k]);
+    os.write(buffer, result.ptr - buffer);
+  }
+  os.put('}');
+  return os;
+}
+
+// Operations
+
+SparseEuclideanVector& SparseEuclideanVector::operator=(SparseEuclideanVector&& v) noexcept {
+  if (this == &v)
+    return *this;
+  numDimensions_ = v.numDimensions_;
+  indices_ = std::move(v.indices_);
+  values_ = std::move(v.values_);
+  v.numDimensions_ = 0;
+  v.indices_.clear();
+  v.values_.clear();
+  return *this;
+}
+
+SparseEuclideanVector& SparseEuclideanVector::operator+=(const SparseEuclideanVector& v) {
+  ev_detail::CheckDimensions(numDimensions_, v.numDimensions_);
+
+  return Merge(v, 1.0);
+}
+
+SparseEuclideanVector& SparseEuclideanVector::operator-=(const SparseEuclideanVector& v) {
+  ev_detail::CheckDimensions(numDimensions_, v.numDimensions_);
+
+  return Merge(v, -1.0);
+}
+
+SparseEuclideanVector& SparseEuclideanVector::operator*=(double d) noexcept {
+  ev_kernels::Scale(values_.data(), d, GetNumStored());
+
+  return *this;
+}
+
+SparseEuclideanVector& SparseEuclideanVector::operator/=(double d) {
+  if (d == 0)
+    ev_detail::Throw("Invalid vector division by 0");
+
+  ev_kernels::Divide(values_.data(), d, GetNumStored());
+
+  return *this;
+}
+
+SparseEuclideanVector::operator EuclideanVector() const {
+  auto v = EuclideanVector(numDimensions_);
+  for (int k = 0; k < GetNumStored(); k++)
+    v[indices_[k]] = values_[k];
+  return v;
+}
+
+// Methods
+
+double SparseEuclideanVector::at(int index) const {
+  if (index < 0 || index >= numDimensions_)
+    ThrowInvalidIndex(index);
+
+  auto it = std::lower_bound(indices_.begin(), indices_.end(), index);
+  if (it == indices_.end() || *it != index)
+    return 0.0;
+  return values_[it - indices_.begin()];
+}
+
+double SparseEuclideanVector::GetEuclideanNorm() const {
+  if (numDimensions_ == 0)
+    ev_detail::Throw("EuclideanVector with no dimensions does not have a norm");
+
+  return std::sqrt(ev_kernels::SumOfSquares(values_.data(), GetNumStored()));
+}
+
+SparseEuclideanVector SparseEuclideanVector::CreateUnitVector() const {
+  if (numDimensions_ == 0)
+    ev_detail::Throw("EuclideanVector with no dimensions does not have a unit vector");
+  double norm = GetEuclideanNorm();
+  if (norm == 0.0)
+    ev_detail::Throw("EuclideanVector with euclidean normal of 0 does not have a unit vector");
+
+  return *this / norm;
+}
+
+SparseEuclideanVector& SparseEuclideanVector::Merge(const SparseEuclideanVector& v, double a) {
+  std::vector<int> indices;
+  std::vector<double> values;
+  indices.reserve(indices_.size() + v.indices_.size());
+  values.reserve(indices_.size() + v.indices_.size());
+
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < indices_.size() || j < v.indices_.size()) {
+    if (j == v.indices_.size() || (i < indices_.size() && indices_[i] < v.indices_[j])) {
+      indices.push_back(indices_[i]);
+      values.push_back(values_[i++]);
+    } else if (i == indices_.size() || v.indices_[j] < indices_[i]) {
+      indices.push_back(v.indices_[j]);
+      values.push_back(a * v.values_[j++]);
+    } else {
+      indices.push_back(indices_[i]);
+      values.push_back(values_[i++] + a * v.values_[j++]);
+    }
+  }
+
+  indices_ = std::move(indices);
+  values_ = std::move(values);
+  return *this;
+}
+
+EuclideanVector& Axpy(EuclideanVector& y, double a, const SparseEuclideanVector& x) {
+  ev_detail::CheckDimensions(y.GetNumDimensions(), x.GetNumDimensions());
+
+  ev_kernels::SparseAxpy(y.data(), a, x.GetIndices().data(), x.GetValues().data(),
+                         x.GetNumStored());
+
+  return y;
+}
@@ -0,0 +1,90 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_SPARSE_EUCLIDEAN_VECTOR_H_
+#define ASSIGNMENTS_EV_SPARSE_EUCLIDEAN_VECTOR_H_
+
+#include <ostream>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+
+/*
+  SparseEuclideanVector stores only the magnitudes that are (or may be) non-zero, as an array
+  of strictly increasing indices and an array of values, so a vector with millions of
+  dimensions and a few non-zeros costs a few bytes per non-zero.
+
+  Magnitudes that are not stored are 0. Arithmetic keeps the union of the stored indices, so a
+  stored magnitude can be 0 (e.g. after subtracting a vector from itself); such magnitudes are
+  still compared and printed as 0 and never change any result.
+
+  Sparse-sparse operations merge the two index arrays. Sparse-dense dot products and Axpy
+  gather (and scatter) the dense magnitudes at the stored indices (see ev_kernels::SparseDot).
+  Dimension errors are the EuclideanVector ones.
+*/
+class SparseEuclideanVector {
+ public:
+  // Constructors
+  // A vector with the given number of dimensions and every magnitude 0. Throws if
+  // numDimensions is negative.
+  explicit SparseEuclideanVector(int numDimensions = 0);
+  // The indices must be strictly increasing and less than numDimensions
+  SparseEuclideanVector(int numDimensions, std::vector<int> indices, std::vector<double> values);
+  // Stores the non-zero magnitudes of the given vector
+  explicit SparseEuclideanVector(const EuclideanVector&);
+  SparseEuclideanVector(const SparseEuclideanVector&) = default;
+  // Move Constructor will leave the given vector with 0 dimensions
+  SparseEuclideanVector(SparseEuclideanVector&&) noexcept;
+
+  // Friends
+  friend bool operator==(const SparseEuclideanVector&, const SparseEuclideanVector&) noexcept;
+  friend bool operator!=(const SparseEuclideanVector&, const SparseEuclideanVector&) noexcept;
+  friend SparseEuclideanVector operator+(const SparseEuclideanVector&,
+                                         const SparseEuclideanVector&);
+  friend SparseEuclideanVector operator-(const SparseEuclideanVector&,
+                                         const SparseEuclideanVector&);
+  // Dot products
+  friend double operator*(const SparseEuclideanVector&, const SparseEuclideanVector&);
+  friend double operator*(const SparseEuclideanVector&, const EuclideanVector&);
+  friend double operator*(const EuclideanVector&, const SparseEuclideanVector&);
+  friend SparseEuclideanVector operator*(SparseEuclideanVector, double) noexcept;
+  friend SparseEuclideanVector operator*(double, SparseEuclideanVector) noexcept;
+  friend SparseEuclideanVector operator/(SparseEuclideanVector, double);
+  // Prints the stored magnitudes as {index:magnitude ...}
+  friend std::ostream& operator<<(std::ostream&, const SparseEuclideanVector&) noexcept;
+
+  // Operations
+  SparseEuclideanVector& operator=(const SparseEuclideanVector&) = default;
+  // Move Assignment will leave the given vector with 0 dimensions
+  SparseEuclideanVector& operator=(SparseEuclideanVector&&) noexcept;
+  SparseEuclideanVector& operator+=(const SparseEuclideanVector&);
+  SparseEuclideanVector& operator-=(const SparseEuclideanVector&);
+  SparseEuclideanVector& operator*=(double) noexcept;
+  SparseEuclideanVector& operator/=(double);
+  explicit operator EuclideanVector() const;
+
+  // Methods
+  // Magnitude at the given dimension, 0 when it is not stored
+  double at(int) const;
+  int GetNumDimensions() const noexcept { return numDimensions_; }
+  int GetNumStored() const noexcept { return static_cast<int>(indices_.size()); }
+  const std::vector<int>& GetIndices() const noexcept { return indices_; }
+  const std::vector<double>& GetValues() const noexcept { return values_; }
+  double GetEuclideanNorm() const;
+  SparseEuclideanVector CreateUnitVector() const;
+
+  // Destructor
+  ~SparseEuclideanVector() = default;
+
+ private:
+  // Merges the stored magnitudes of *this and a * v
+  SparseEuclideanVector& Merge(const SparseEuclideanVector& v, double a);
+
+  int numDimensions_;
+  std::vector<int> indices_;
+  std::vector<double> values_;
+};
+
+// y += a * x, touching only the stored dimensions of x
+EuclideanVector& Axpy(EuclideanVector& y, double a, const SparseEuclideanVector& x);
+
+#endif  // ASSIGNMENTS_EV_SPARSE_EUCLIDEAN_VECTOR_H_
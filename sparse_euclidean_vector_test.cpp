@@ -0,0 +1,263 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  A SparseEuclideanVector must behave exactly like the dense EuclideanVector with the same
+  magnitudes, so every operation is checked against the EuclideanVector result (which
+  euclidean_vector_test.cpp already covers), for vectors with a few stored magnitudes among
+  many dimensions, vectors whose stored indices only partly overlap, and vectors with nothing
+  stored.
+
+  Sparse-specific behaviour is checked on its own: only non-zero magnitudes are stored when
+  converting from a dense vector, the stored indices stay sorted after arithmetic, and
+  magnitudes that are not stored read as 0.
+  Failure scenarios follow the EuclideanVector error messages.
+
+*/
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/sparse_euclidean_vector.h"
+#include "catch.h"
+
+SCENARIO("Create sparse vectors") {
+  GIVEN("That there are indices and values for a vector with 1000000 dimensions") {
+    std::vector<int> indices{3, 70, 999999};
+    std::vector<double> values{1.5, -2.0, 4.0};
+    WHEN("A sparse vector is created from them") {
+      auto sv = SparseEuclideanVector(1000000, indices, values);
+      THEN("Only the given magnitudes are stored") {
+        REQUIRE(sv.GetNumDimensions() == 1000000);
+        REQUIRE(sv.GetNumStored() == 3);
+        REQUIRE(sv.GetIndices() == indices);
+        REQUIRE(sv.GetValues() == values);
+      }
+      THEN("The magnitudes that are not stored are 0") {
+        REQUIRE(sv.at(70) == -2.0);
+        REQUIRE(sv.at(999999) == 4.0);
+        REQUIRE(sv.at(0) == 0.0);
+        REQUIRE(sv.at(71) == 0.0);
+      }
+    }
+  }
+  GIVEN("That there is a dense vector with 2 non-zero magnitudes") {
+    auto ev = EuclideanVector(6);
+    ev[1] = 2.0;
+    ev[4] = -3.0;
+    WHEN("A sparse vector is created from it") {
+      auto sv = SparseEuclideanVector(ev);
+      THEN("Only the non-zero magnitudes are stored") {
+        REQUIRE(sv.GetIndices() == std::vector<int>{1, 4});
+        REQUIRE(sv.GetValues() == std::vector<double>{2.0, -3.0});
+      }
+      AND_WHEN("It is converted back to a dense vector") {
+        auto dense = EuclideanVector(sv);
+        THEN("It is equal to the original") { REQUIRE(dense == ev); }
+      }
+    }
+  }
+  GIVEN("That there is a sparse vector with 10 dimensions and nothing stored") {
+    auto sv = SparseEuclideanVector(10);
+    WHEN("It is converted to a dense vector") {
+      THEN("Every magnitude is 0") { REQUIRE(EuclideanVector(sv) == EuclideanVector(10)); }
+    }
+  }
+  GIVEN("That there is a sparse vector") {
+    auto sv = SparseEuclideanVector(5, {0, 2}, {1.0, 2.0});
+    WHEN("It is moved") {
+      auto moved = std::move(sv);
+      THEN("The moved-from vector has 0 dimensions") {
+        REQUIRE(moved.GetNumStored() == 2);
+        REQUIRE(sv.GetNumDimensions() == 0);  // NOLINT(bugprone-use-after-move)
+        REQUIRE(sv.GetNumStored() == 0);      // NOLINT(bugprone-use-after-move)
+      }
+    }
+  }
+  GIVEN("That there are invalid indices and values") {
+    WHEN("A sparse vector is created from them") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(SparseEuclideanVector(5, {0, 1}, {1.0}),
+                            "Number of indices(2) and values(1) do not match");
+        REQUIRE_THROWS_WITH(SparseEuclideanVector(5, {0, 5}, {1.0, 2.0}),
+                            "Index 5 is not valid for this SparseEuclideanVector object");
+        REQUIRE_THROWS_WITH(SparseEuclideanVector(5, {-1}, {1.0}),
+                            "Index -1 is not valid for this SparseEuclideanVector object");
+        REQUIRE_THROWS_WITH(SparseEuclideanVector(5, {2, 2}, {1.0, 2.0}),
+                            "Indices of a SparseEuclideanVector must be strictly increasing");
+        REQUIRE_THROWS_WITH(SparseEuclideanVector(5, {3, 1}, {1.0, 2.0}),
+                            "Indices of a SparseEuclideanVector must be strictly increasing");
+      }
+    }
+  }
+  GIVEN("That there is a negative number of dimensions") {
+    WHEN("A sparse vector is created with it") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(SparseEuclideanVector(-1), "Number of dimensions -1 is not valid");
+        REQUIRE_THROWS_WITH(SparseEuclideanVector(-1, {}, {}),
+                            "Number of dimensions -1 is not valid");
+      }
+    }
+  }
+  GIVEN("That there is a sparse vector with 5 dimensions") {
+    auto sv = SparseEuclideanVector(5, {1}, {1.0});
+    WHEN("An invalid index is accessed") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(sv.at(5),
+                            "Index 5 is not valid for this SparseEuclideanVector object");
+      }
+    }
+  }
+}
+
+SCENARIO("Combine sparse vectors with each other") {
+  GIVEN("That there are two sparse vectors whose stored indices partly overlap") {
+    auto sv1 = SparseEuclideanVector(100, {2, 10, 50, 99}, {1.0, 2.0, 3.0, 4.0});
+    auto sv2 = SparseEuclideanVector(100, {0, 10, 60, 99}, {5.0, -1.0, 7.0, 0.5});
+    auto ev1 = EuclideanVector(sv1);
+    auto ev2 = EuclideanVector(sv2);
+    WHEN("They are added and subtracted") {
+      auto sum = sv1 + sv2;
+      auto difference = sv1 - sv2;
+      THEN("The results match the dense results") {
+        REQUIRE(EuclideanVector(sum) == EuclideanVector(ev1 + ev2));
+        REQUIRE(EuclideanVector(difference) == EuclideanVector(ev1 - ev2));
+      }
+      THEN("The union of the indices is stored, in order") {
+        REQUIRE(sum.GetIndices() == std::vector<int>{0, 2, 10, 50, 60, 99});
+      }
+    }
+    WHEN("Their dot product is computed") {
+      THEN("It matches the dense dot product") {
+        REQUIRE(sv1 * sv2 == ev1 * ev2);
+        REQUIRE(sv1 * sv2 == -2.0 + 2.0);
+      }
+    }
+    WHEN("One is updated in place with the other") {
+      sv1 += sv2;
+      sv2 -= sv2;
+      THEN("The results match the dense results") {
+        REQUIRE(EuclideanVector(sv1) == EuclideanVector(ev1 + ev2));
+        REQUIRE(EuclideanVector(sv2) == EuclideanVector(100));
+      }
+      THEN("A vector subtracted from itself is equal to a vector with nothing stored") {
+        REQUIRE(sv2.GetNumStored() == 4);
+        REQUIRE(sv2 == SparseEuclideanVector(100));
+      }
+    }
+    WHEN("They are compared") {
+      THEN("They are equal only to a vector with the same magnitudes") {
+        REQUIRE(sv1 == SparseEuclideanVector(ev1));
+        REQUIRE(sv1 != sv2);
+        REQUIRE(sv1 != SparseEuclideanVector(101, {2, 10, 50, 99}, {1.0, 2.0, 3.0, 4.0}));
+      }
+    }
+  }
+  GIVEN("That there are sparse vectors with different dimensions") {
+    auto sv1 = SparseEuclideanVector(4, {1}, {1.0});
+    auto sv2 = SparseEuclideanVector(5, {1}, {1.0});
+    WHEN("They are combined") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(sv1 + sv2, "Dimensions of LHS(4) and RHS(5) do not match");
+        REQUIRE_THROWS_WITH(sv1 - sv2, "Dimensions of LHS(4) and RHS(5) do not match");
+        REQUIRE_THROWS_WITH(sv1 * sv2, "Dimensions of LHS(4) and RHS(5) do not match");
+        REQUIRE_THROWS_WITH(sv1 += sv2, "Dimensions of LHS(4) and RHS(5) do not match");
+      }
+    }
+  }
+}
+
+SCENARIO("Scale a sparse vector and compute its norm") {
+  GIVEN("That there is a sparse vector with magnitudes 3 and 4 stored") {
+    auto sv = SparseEuclideanVector(1000, {10, 500}, {3.0, 4.0});
+    WHEN("It is scaled") {
+      auto scaled = 2.0 * sv;
+      auto divided = sv / 2.0;
+      sv *= -1.0;
+      THEN("Only the stored magnitudes change") {
+        REQUIRE(scaled == SparseEuclideanVector(1000, {10, 500}, {6.0, 8.0}));
+        REQUIRE(divided == SparseEuclideanVector(1000, {10, 500}, {1.5, 2.0}));
+        REQUIRE(sv == SparseEuclideanVector(1000, {10, 500}, {-3.0, -4.0}));
+      }
+    }
+    WHEN("The euclidean norm and the unit vector are computed") {
+      THEN("They match the dense results") {
+        REQUIRE(sv.GetEuclideanNorm() == 5.0);
+        REQUIRE(EuclideanVector(sv.CreateUnitVector()) ==
+                EuclideanVector(sv).CreateUnitVector());
+      }
+    }
+    WHEN("It is divided by 0") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(sv / 0.0, "Invalid vector division by 0");
+        REQUIRE_THROWS_WITH(sv /= 0.0, "Invalid vector division by 0");
+      }
+    }
+    WHEN("It is printed") {
+      std::ostringstream os;
+      os << sv;
+      THEN("The stored magnitudes are printed with their indices") {
+        REQUIRE(os.str() == "{10:3 500:4}");
+      }
+    }
+  }
+  GIVEN("That there are sparse vectors with 0 dimensions and with nothing stored") {
+    auto empty = SparseEuclideanVector(0);
+    auto zero = SparseEuclideanVector(3);
+    WHEN("Their norms and unit vectors are computed") {
+      THEN("The EuclideanVector exceptions are thrown") {
+        REQUIRE_THROWS_WITH(empty.GetEuclideanNorm(),
+                            "EuclideanVector with no dimensions does not have a norm");
+        REQUIRE_THROWS_WITH(empty.CreateUnitVector(),
+                            "EuclideanVector with no dimensions does not have a unit vector");
+        REQUIRE(zero.GetEuclideanNorm() == 0.0);
+        REQUIRE_THROWS_WITH(
+            zero.CreateUnitVector(),
+            "EuclideanVector with euclidean normal of 0 does not have a unit vector");
+      }
+    }
+  }
+}
+
+SCENARIO("Combine a sparse vector with a dense vector") {
+  GIVEN("That there are a sparse and a dense vector with 300 dimensions") {
+    std::vector<int> indices;
+    std::vector<double> values;
+    for (int i = 1; i < 300; i += 7) {
+      indices.push_back(i);
+      values.push_back(0.25 * i);
+    }
+    auto sv = SparseEuclideanVector(300, indices, values);
+    auto ev = EuclideanVector(300);
+    for (int i = 0; i < 300; i++)
+      ev[i] = 1.0 + (i % 5);
+    WHEN("Their dot product is computed") {
+      THEN("It matches the dense dot product, in either order") {
+        REQUIRE(sv * ev == Approx(EuclideanVector(sv) * ev));
+        REQUIRE(ev * sv == sv * ev);
+      }
+    }
+    WHEN("The sparse vector is accumulated into the dense vector with Axpy") {
+      auto expected = EuclideanVector(ev + 2.0 * EuclideanVector(sv));
+      Axpy(ev, 2.0, sv);
+      THEN("It matches the dense result") {
+        for (int i = 0; i < 300; i++)
+          REQUIRE(ev[i] == Approx(expected[i]));
+      }
+    }
+  }
+  GIVEN("That there are a sparse and a dense vector with different dimensions") {
+    auto sv = SparseEuclideanVector(4, {1}, {1.0});
+    auto ev = EuclideanVector(5);
+    WHEN("They are combined") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(sv * ev, "Dimensions of LHS(4) and RHS(5) do not match");
+        REQUIRE_THROWS_WITH(ev * sv, "Dimensions of LHS(5) and RHS(4) do not match");
+        REQUIRE_THROWS_WITH(Axpy(ev, 1.0, sv), "Dimensions of LHS(5) and RHS(4) do not match");
+      }
+    }
+  }
+}
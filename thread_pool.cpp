@@ -0,0 +1,128 @@
+// Created By : Rahil Agrawal
+
+#include "assignments/ev/thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "assignments/ev/euclidean_vector.h"
+
+namespace {
+
+// The pools whose tasks the calling thread is running, innermost first
+struct RunningPool {
+  const ThreadPool* pool;
+  const RunningPool* outer;
+};
+
+thread_local const RunningPool* runningPools = nullptr;
+
+bool IsRunningTasksOf(const ThreadPool* pool) noexcept {
+  for (const auto* running = runningPools; running != nullptr; running = running->outer) {
+    if (running->pool == pool)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+// Constructors
+
+ThreadPool::ThreadPool(int numThreads) {
+  for (int i = 1; i < std::max(numThreads, 1); i++)
+    workers_.emplace_back([this] { WorkerLoop(); });
+}
+
+// Methods
+
+void ThreadPool::ParallelFor(int numTasks, const std::function<void(int)>& task) {
+  if (numTasks <= 0)
+    return;
+  // A task of this pool calling ParallelFor again would wait for submit_ forever
+  if (workers_.empty() || numTasks == 1 || IsRunningTasksOf(this)) {
+    for (int i = 0; i < numTasks; i++)
+      task(i);
+    return;
+  }
+
+  std::lock_guard<std::mutex> submit{submit_};
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    task_ = &task;
+    numTasks_ = numTasks;
+    nextTask_ = 0;
+    unfinishedTasks_ = numTasks;
+    error_ = nullptr;
+    generation_++;
+  }
+  wake_.notify_all();
+
+  RunTasks();
+
+  std::unique_lock<std::mutex> lock{mutex_};
+  done_.wait(lock, [this] { return unfinishedTasks_ == 0; });
+  task_ = nullptr;
+#if EUCLIDEAN_VECTOR_EXCEPTIONS
+  if (error_)
+    std::rethrow_exception(error_);
+#endif
+}
+
+// Destructor
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_)
+    worker.join();
+}
+
+// Helpers
+
+void ThreadPool::WorkerLoop() {
+  unsigned long seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+      if (stopping_)
+        return;
+      seen = generation_;
+    }
+    RunTasks();
+  }
+}
+
+void ThreadPool::RunTasks() {
+  const RunningPool running{this, runningPools};
+  runningPools = &running;
+  std::unique_lock<std::mutex> lock{mutex_};
+  while (task_ != nullptr && nextTask_ < numTasks_) {
+    const int index = nextTask_++;
+    const auto* task = task_;
+    lock.unlock();
+#if EUCLIDEAN_VECTOR_EXCEPTIONS
+    try {
+      (*task)(index);
+    } catch (...) {
+      lock.lock();
+      if (!error_)
+        error_ = std::current_exception();
+      lock.unlock();
+    }
+#else
+    (*task)(index);
+#endif
+    lock.lock();
+    if (--unfinishedTasks_ == 0)
+      done_.notify_all();
+  }
+  runningPools = running.outer;
+}
@@ -0,0 +1,66 @@
+// Created By : Rahil Agrawal
+
+#ifndef ASSIGNMENTS_EV_THREAD_POOL_H_
+#define ASSIGNMENTS_EV_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+  A fixed set of worker threads for the parallel parts of the library.
+
+  ParallelFor(n, task) runs task(0) ... task(n - 1), spread over the workers and the calling
+  thread, and returns when all of them have finished. Which thread runs which index is not
+  fixed, so callers that need reproducible results must make each task write only its own
+  output and combine the outputs in a fixed order afterwards.
+
+  A task may itself call ParallelFor on the same pool (directly, or through a library function
+  given the pool, such as the tile sink of PairwiseDistances). The other threads are busy with
+  the outer call, so the nested tasks run one after the other on the thread that calls it.
+*/
+class ThreadPool {
+ public:
+  // Constructors
+  // numThreads threads in total, including the thread that calls ParallelFor
+  explicit ThreadPool(int numThreads = static_cast<int>(std::thread::hardware_concurrency()));
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+
+  // Operations
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool& operator=(ThreadPool&&) = delete;
+
+  // Methods
+  // Rethrows the first exception thrown by a task, after every task has finished
+  void ParallelFor(int numTasks, const std::function<void(int)>& task);
+  int GetNumThreads() const noexcept { return static_cast<int>(workers_.size()) + 1; }
+
+  // Destructor
+  ~ThreadPool();
+
+ private:
+  void WorkerLoop();
+  void RunTasks();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  // Only one ParallelFor runs at a time
+  std::mutex submit_;
+
+  // Current job, guarded by mutex_
+  const std::function<void(int)>* task_ = nullptr;
+  int numTasks_ = 0;
+  int nextTask_ = 0;
+  int unfinishedTasks_ = 0;
+  unsigned long generation_ = 0;
+  std::exception_ptr error_;
+  bool stopping_ = false;
+};
+
+#endif  // ASSIGNMENTS_EV_THREAD_POOL_H_